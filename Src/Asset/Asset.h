@@ -23,6 +23,32 @@ namespace VulkanHelper
 		Image Image;
 	};
 
+	// Packed std430 material record as read by shaders, textures are indices into a bindless texture array
+	struct GPUMaterial
+	{
+		glm::vec4 Color;
+		glm::vec4 EmissiveColor;
+		glm::vec4 MediumColor;
+		float Metallic;
+		float Roughness;
+		float SpecularTint;
+		float Ior;
+
+		float Transparency;
+		float MediumDensity;
+		float MediumAnisotropy;
+		float Anisotropy;
+
+		float AnisotropyRotation;
+		uint32_t AlbedoTexture;
+		uint32_t NormalTexture;
+		uint32_t RoughnessTexture;
+
+		uint32_t MetallnessTexture;
+		uint32_t Padding[3];
+	};
+	static_assert(sizeof(GPUMaterial) % 16 == 0, "GPUMaterial has to match std430 array stride");
+
 	class Material
 	{
 	public:
@@ -44,8 +70,6 @@ namespace VulkanHelper
 		float Anisotropy = 0.0f;
 		float AnisotropyRotation = 0.0f;
 
-		glm::vec3 padding;
-
 		AssetHandle AlbedoTexture;
 		AssetHandle NormalTexture;
 		AssetHandle RoughnessTexture;
@@ -54,6 +78,14 @@ namespace VulkanHelper
 		std::string MaterialName;
 	};
 
+	// A single node reference to a mesh, meshes referenced by several nodes are uploaded once and drawn per instance
+	struct MeshInstance
+	{
+		uint32_t MeshIndex = 0; // Index into ModelAsset::Meshes
+		glm::mat4 Transform = glm::mat4(1.0f);
+		std::string NodeName;
+	};
+
 	class ModelAsset : public Asset
 	{
 	public:
@@ -63,6 +95,8 @@ namespace VulkanHelper
 		std::vector<Mesh> Meshes;
 		std::vector<std::string> MeshNames;
 		std::vector<glm::mat4> MeshTransfrorms;
-		std::vector<Material> Materials;
+		std::vector<Material> Materials; // One per unique material, see MeshMaterialIndices
+		std::vector<uint32_t> MeshMaterialIndices; // Index into Materials for every mesh
+		std::vector<MeshInstance> Instances;
 	};
 }
\ No newline at end of file
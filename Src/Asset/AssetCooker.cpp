@@ -0,0 +1,530 @@
+#include "Pch.h"
+#include "AssetCooker.h"
+
+#include "AssetImporter.h"
+#include "CookedModel.h"
+#include "KTX2.h"
+#include "MappedIOSystem.h"
+#include "Logger/Logger.h"
+#include "Utility/Hash.h"
+#include "Utility/MappedFile.h"
+#include "Utility/ThreadPool.h"
+
+#include <stb_image.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+#include <map>
+#include <set>
+
+namespace
+{
+	// Remembers every file Assimp opens, those are the dependencies of the cooked model
+	class RecordingIOSystem : public VulkanHelper::MappedIOSystem
+	{
+	public:
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override
+		{
+			Assimp::IOStream* stream = MappedIOSystem::Open(file, mode);
+			if (stream)
+				OpenedFiles.push_back(file);
+
+			return stream;
+		}
+
+		std::vector<std::string> OpenedFiles;
+	};
+
+	struct MaterialSlot
+	{
+		aiTextureType Type;
+		VulkanHelper::TextureRole Role;
+	};
+
+	// Same order as CookedModel::MaterialTexture and the same types AssetImporter::ProcessAssimpMaterial() uses
+	static constexpr MaterialSlot s_MaterialSlots[VulkanHelper::CookedModel::MaterialTextureCount] = {
+		{ aiTextureType_DIFFUSE, VulkanHelper::TextureRole::Color },
+		{ aiTextureType_NORMALS, VulkanHelper::TextureRole::Normal },
+		{ aiTextureType_DIFFUSE_ROUGHNESS, VulkanHelper::TextureRole::Roughness },
+		{ aiTextureType_METALNESS, VulkanHelper::TextureRole::Metalness },
+	};
+
+	uint64_t GetModelSeed()
+	{
+		return VulkanHelper::Hash::Combine(VulkanHelper::Hash::XXH64("CookedModel"), VulkanHelper::AssetCooker::s_CookerVersion);
+	}
+
+	uint64_t GetTextureSeed(VulkanHelper::TextureRole role)
+	{
+		return VulkanHelper::Hash::Combine(VulkanHelper::Hash::XXH64("CookedTexture"), ((uint64_t)VulkanHelper::AssetCooker::s_CookerVersion << 8) | (uint64_t)role);
+	}
+}
+
+struct VulkanHelper::AssetCooker::Context
+{
+	CreateInfo Info;
+	std::string SourceDirectory; // Canonical
+	std::unordered_map<AssetID, CookManifest::Entry> Previous; // Keyed by CookManifest::GetRequestID()
+
+	std::mutex Mutex;
+	CookManifest Manifest;
+	std::set<std::pair<std::string, TextureRole>> Textures; // Canonical path and role of every texture to cook
+	Statistics Stats;
+};
+
+bool VulkanHelper::AssetCooker::Cook(const CreateInfo& createInfo, Statistics* outStatistics)
+{
+	Context context;
+	context.Info = createInfo;
+	context.SourceDirectory = AssetManager::CanonicalizePath(createInfo.SourceDirectory);
+
+	std::error_code error;
+	if (!std::filesystem::is_directory(createInfo.SourceDirectory, error))
+	{
+		VH_ERROR("Source directory {} doesn't exist", createInfo.SourceDirectory);
+		return false;
+	}
+
+	std::filesystem::create_directories(createInfo.OutputDirectory, error);
+	std::string manifestPath = (std::filesystem::path(createInfo.OutputDirectory) / s_ManifestName).generic_string();
+
+	// Previous results decide what's up to date, a missing or broken manifest just cooks everything
+	MappedFile previousFile;
+	if (!createInfo.Force && previousFile.Open(manifestPath))
+	{
+		CookManifest previous;
+		std::string parseError;
+		if (CookManifest::Parse((const char*)previousFile.GetData(), previousFile.GetSize(), &previous, &parseError))
+		{
+			for (CookManifest::Entry& entry : previous.Entries)
+				context.Previous[CookManifest::GetRequestID(entry)] = std::move(entry);
+		}
+		else
+		{
+			VH_WARN("Ignoring invalid manifest {}: {}", manifestPath, parseError);
+		}
+	}
+	previousFile.Close();
+
+	std::vector<std::string> models;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(createInfo.SourceDirectory, error))
+	{
+		if (!entry.is_regular_file())
+			continue;
+
+		std::string path = AssetManager::CanonicalizePath(entry.path().generic_string());
+		std::string extension = AssetManager::GetExtension(path);
+		if (extension == ".gltf" || extension == ".glb" || extension == ".obj")
+			models.push_back(path);
+		else if (extension == ".png" || extension == ".jpg")
+			context.Textures.insert({ path, TextureRole::Color });
+	}
+
+	uint32_t threadCount = createInfo.ThreadCount != 0 ? createInfo.ThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
+	ThreadPool threadPool({ nullptr, threadCount - 1 }); // The calling thread takes part in ParallelFor
+
+	// Models first, their materials decide which roles the textures are needed in
+	threadPool.ParallelFor((uint32_t)models.size(), [&](uint32_t i)
+		{
+			CookManifest::Entry entry;
+			bool cooked = CookModel(context, models[i], &entry);
+
+			std::lock_guard<std::mutex> lock(context.Mutex);
+			if (!cooked)
+			{
+				context.Stats.Failed++;
+				return;
+			}
+
+			for (const CookManifest::TextureReference& texture : entry.Textures)
+				context.Textures.insert({ AssetManager::CanonicalizePath(texture.Path), texture.Role });
+
+			context.Manifest.Entries.push_back(std::move(entry));
+		});
+
+	std::vector<std::pair<std::string, TextureRole>> textures(context.Textures.begin(), context.Textures.end());
+	threadPool.ParallelFor((uint32_t)textures.size(), [&](uint32_t i)
+		{
+			CookManifest::Entry entry;
+			bool cooked = CookTexture(context, textures[i].first, textures[i].second, &entry);
+
+			std::lock_guard<std::mutex> lock(context.Mutex);
+			if (!cooked)
+			{
+				context.Stats.Failed++;
+				return;
+			}
+
+			if (entry.Cooked.empty())
+				return; // Outside of the source directory, stays uncooked
+
+			context.Manifest.Entries.push_back(std::move(entry));
+		});
+
+	// Stable order keeps the manifest diffable between runs
+	std::sort(context.Manifest.Entries.begin(), context.Manifest.Entries.end(), [](const CookManifest::Entry& a, const CookManifest::Entry& b)
+		{
+			if (a.Source != b.Source)
+				return a.Source < b.Source;
+
+			return a.Role < b.Role;
+		});
+
+	bool written = context.Manifest.Write(manifestPath);
+
+	*outStatistics = context.Stats;
+	VH_INFO("Cooked {}, {} up to date, {} failed", context.Stats.Cooked, context.Stats.UpToDate, context.Stats.Failed);
+
+	return written && context.Stats.Failed == 0;
+}
+
+bool VulkanHelper::AssetCooker::CookModel(Context& context, const std::string& path, CookManifest::Entry* outEntry)
+{
+	outEntry->Type = CookManifest::EntryType::Model;
+	outEntry->Source = path;
+
+	auto previous = context.Previous.find(AssetManager::GetAssetID(path));
+	if (previous != context.Previous.end() && IsUpToDate(context, previous->second, GetModelSeed()))
+	{
+		*outEntry = previous->second;
+
+		std::lock_guard<std::mutex> lock(context.Mutex);
+		context.Stats.UpToDate++;
+		return true;
+	}
+
+	outEntry->Cooked = GetOutputPath(context, path, ".vhmodel");
+
+	RecordingIOSystem* ioSystem = new RecordingIOSystem();
+	Assimp::Importer importer;
+	importer.SetIOHandler(ioSystem); // Importer takes ownership
+	const aiScene* scene = importer.ReadFile(path, AssetImporter::GetAssimpImportFlags());
+	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+	{
+		VH_ERROR("Failed to cook {}: {}", path, importer.GetErrorString());
+		return false;
+	}
+
+	// The model itself first, then buffers and everything else Assimp read
+	outEntry->Dependencies.push_back(path);
+	for (const std::string& opened : ioSystem->OpenedFiles)
+	{
+		std::string dependency = AssetManager::CanonicalizePath(opened);
+		if (std::find(outEntry->Dependencies.begin(), outEntry->Dependencies.end(), dependency) == outEntry->Dependencies.end())
+			outEntry->Dependencies.push_back(dependency);
+	}
+
+	bool allFound;
+	outEntry->Hash = HashDependencies(outEntry->Dependencies, GetModelSeed(), &allFound);
+
+	CookedModel::Model model;
+	model.SourceHash = outEntry->Hash;
+
+	// Same naming and placement rules as AssetImporter::ImportModel()
+	AssetImporter::GatherAssimpInstances(scene, 0, &model.Instances);
+	model.Meshes.resize(scene->mNumMeshes);
+	std::vector<bool> hasInstance(scene->mNumMeshes, false);
+	for (const MeshInstance& instance : model.Instances)
+	{
+		if (hasInstance[instance.MeshIndex])
+			continue;
+
+		hasInstance[instance.MeshIndex] = true;
+		model.Meshes[instance.MeshIndex].Name = instance.NodeName;
+		model.Meshes[instance.MeshIndex].Transform = instance.Transform;
+	}
+
+	std::map<std::pair<int, TextureRole>, std::string> embeddedPaths;
+	std::vector<uint32_t> materialRemap(scene->mNumMaterials, UINT32_MAX);
+	for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+	{
+		CookedModel::MeshData& mesh = model.Meshes[i];
+		if (!hasInstance[i])
+			mesh.Name = scene->mMeshes[i]->mName.C_Str();
+
+		Mesh::ConvertAssimpMesh(scene->mMeshes[i], glm::mat4(1.0f), &mesh.Vertices, &mesh.Indices);
+
+		uint32_t aiMaterialIndex = scene->mMeshes[i]->mMaterialIndex;
+		if (materialRemap[aiMaterialIndex] != UINT32_MAX)
+		{
+			mesh.MaterialIndex = materialRemap[aiMaterialIndex];
+			continue;
+		}
+
+		const aiMaterial* aiMat = scene->mMaterials[aiMaterialIndex];
+		CookedModel::MaterialData material;
+		AssetImporter::ReadAssimpMaterialParameters(aiMat, &material.Parameters);
+
+		for (uint32_t slot = 0; slot < CookedModel::MaterialTextureCount; slot++)
+		{
+			std::string texturePath;
+			int embeddedIndex;
+			if (!AssetImporter::FindAssimpTexture(scene, aiMat, s_MaterialSlots[slot].Type, &texturePath, &embeddedIndex))
+				continue; // Fallback texture
+
+			TextureRole role = s_MaterialSlots[slot].Role;
+			if (embeddedIndex < 0)
+			{
+				material.TexturePaths[slot] = texturePath;
+				outEntry->Textures.push_back({ texturePath, role });
+				continue;
+			}
+
+			// Embedded textures only exist inside the model, they are written next to it and referenced by the cooked path
+			std::string& embeddedPath = embeddedPaths[{ embeddedIndex, role }];
+			if (embeddedPath.empty())
+			{
+				embeddedPath = GetOutputPath(context, path, "." + std::to_string(embeddedIndex) + "." + GetRoleName(role) + ".ktx2");
+
+				const aiTexture* texture = scene->mTextures[embeddedIndex];
+				std::vector<uint8_t> ktx2;
+				bool cooked;
+				if (texture->mHeight == 0)
+				{
+					cooked = CookImage(texture->pcData, texture->mWidth, role, &ktx2);
+				}
+				else
+				{
+					// Raw BGRA texels, flipped like everything going through stb_image
+					int decodeChannels = AssetImporter::ChooseTextureLayout(role, 4).DecodeChannels;
+					std::vector<uint8_t> pixels((size_t)texture->mWidth * texture->mHeight * decodeChannels);
+					uint8_t* dst = pixels.data();
+					for (uint32_t y = 0; y < texture->mHeight; y++)
+					{
+						const aiTexel* srcRow = texture->pcData + (size_t)(texture->mHeight - 1 - y) * texture->mWidth;
+						for (uint32_t x = 0; x < texture->mWidth; x++)
+						{
+							uint8_t texel[4] = { srcRow[x].r, srcRow[x].g, srcRow[x].b, srcRow[x].a };
+							for (int c = 0; c < decodeChannels; c++)
+								*dst++ = texel[c];
+						}
+					}
+
+					cooked = CookPixels(pixels.data(), (int)texture->mWidth, (int)texture->mHeight, 4, role, &ktx2);
+				}
+
+				if (!cooked || !WriteFile(embeddedPath, ktx2))
+				{
+					VH_ERROR("Failed to cook embedded texture {} of {}", embeddedIndex, path);
+					return false;
+				}
+
+				outEntry->Outputs.push_back(embeddedPath);
+			}
+
+			material.TexturePaths[slot] = embeddedPath;
+		}
+
+		materialRemap[aiMaterialIndex] = (uint32_t)model.Materials.size();
+		mesh.MaterialIndex = materialRemap[aiMaterialIndex];
+		model.Materials.push_back(std::move(material));
+	}
+
+	std::vector<uint8_t> data;
+	CookedModel::Write(model, &data);
+	if (!WriteFile(outEntry->Cooked, data))
+		return false;
+
+	std::lock_guard<std::mutex> lock(context.Mutex);
+	context.Stats.Cooked++;
+	return true;
+}
+
+bool VulkanHelper::AssetCooker::CookTexture(Context& context, const std::string& path, TextureRole role, CookManifest::Entry* outEntry)
+{
+	outEntry->Type = CookManifest::EntryType::Texture;
+	outEntry->Source = path;
+	outEntry->Role = role;
+
+	auto previous = context.Previous.find(AssetManager::GetTextureID(path, role));
+	if (previous != context.Previous.end() && IsUpToDate(context, previous->second, GetTextureSeed(role)))
+	{
+		*outEntry = previous->second;
+
+		std::lock_guard<std::mutex> lock(context.Mutex);
+		context.Stats.UpToDate++;
+		return true;
+	}
+
+	outEntry->Cooked = GetOutputPath(context, path, role == TextureRole::Color ? ".ktx2" : std::string(".") + GetRoleName(role) + ".ktx2");
+	if (outEntry->Cooked.empty())
+	{
+		VH_WARN("Texture {} lies outside of the source directory, it's loaded from source at runtime", path);
+		return true;
+	}
+
+	// Same '%' translation the runtime applies before reading the file
+	std::string filePath = AssetImporter::GetTextureFilePath(path);
+	MappedFile file;
+	if (!file.Open(filePath))
+	{
+		VH_ERROR("Texture {} doesn't exist", filePath);
+		return false;
+	}
+
+	outEntry->Dependencies.push_back(filePath);
+	outEntry->Hash = Hash::Combine(GetTextureSeed(role), Hash::XXH64(file.GetData(), file.GetSize()));
+
+	std::vector<uint8_t> ktx2;
+	if (!CookImage(file.GetData(), file.GetSize(), role, &ktx2) || !WriteFile(outEntry->Cooked, ktx2))
+	{
+		VH_ERROR("Failed to cook {}", path);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(context.Mutex);
+	context.Stats.Cooked++;
+	return true;
+}
+
+bool VulkanHelper::AssetCooker::CookImage(const void* data, size_t size, TextureRole role, std::vector<uint8_t>* outKTX2)
+{
+	int width, height, sourceChannels;
+	if (!stbi_info_from_memory((const stbi_uc*)data, (int)size, &width, &height, &sourceChannels))
+		return false;
+
+	AssetImporter::TextureLayout layout = AssetImporter::ChooseTextureLayout(role, sourceChannels);
+
+	stbi_set_flip_vertically_on_load_thread(true);
+	stbi_uc* pixels = stbi_load_from_memory((const stbi_uc*)data, (int)size, &width, &height, &sourceChannels, layout.DecodeChannels);
+	if (!pixels)
+		return false;
+
+	bool cooked = CookPixels(pixels, width, height, sourceChannels, role, outKTX2);
+	stbi_image_free(pixels);
+
+	return cooked;
+}
+
+bool VulkanHelper::AssetCooker::CookPixels(const uint8_t* pixels, int width, int height, int sourceChannels, TextureRole role, std::vector<uint8_t>* outKTX2)
+{
+	AssetImporter::TextureLayout layout = AssetImporter::ChooseTextureLayout(role, sourceChannels);
+
+	// Same mip count CreateTextureImage() generates on the GPU
+	uint32_t levelCount = (uint32_t)glm::max(1, glm::min(5, (int)glm::floor(glm::log2((float)glm::max(width, height)))));
+
+	std::vector<std::vector<uint8_t>> levels(levelCount);
+	levels[0].resize((size_t)width * height * layout.Channels);
+	for (size_t i = 0; i < (size_t)width * height; i++)
+	{
+		const uint8_t* src = pixels + i * layout.DecodeChannels;
+		uint8_t* dst = levels[0].data() + i * layout.Channels;
+		for (int c = 0; c < layout.Channels; c++)
+			dst[c] = layout.SourceChannel >= 0 ? src[layout.SourceChannel] : src[c];
+	}
+
+	// 2x2 box filter, odd edges clamp like a linear blit does
+	for (uint32_t level = 1; level < levelCount; level++)
+	{
+		int srcWidth = glm::max(width >> (level - 1), 1);
+		int srcHeight = glm::max(height >> (level - 1), 1);
+		int dstWidth = glm::max(width >> level, 1);
+		int dstHeight = glm::max(height >> level, 1);
+
+		const uint8_t* src = levels[level - 1].data();
+		levels[level].resize((size_t)dstWidth * dstHeight * layout.Channels);
+		uint8_t* dst = levels[level].data();
+		for (int y = 0; y < dstHeight; y++)
+		{
+			int y0 = glm::min(y * 2, srcHeight - 1);
+			int y1 = glm::min(y * 2 + 1, srcHeight - 1);
+			for (int x = 0; x < dstWidth; x++)
+			{
+				int x0 = glm::min(x * 2, srcWidth - 1);
+				int x1 = glm::min(x * 2 + 1, srcWidth - 1);
+				for (int c = 0; c < layout.Channels; c++)
+				{
+					uint32_t sum =
+						src[((size_t)y0 * srcWidth + x0) * layout.Channels + c] +
+						src[((size_t)y0 * srcWidth + x1) * layout.Channels + c] +
+						src[((size_t)y1 * srcWidth + x0) * layout.Channels + c] +
+						src[((size_t)y1 * srcWidth + x1) * layout.Channels + c];
+					dst[((size_t)y * dstWidth + x) * layout.Channels + c] = (uint8_t)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	// Pixels come flipped like everything going through stb_image, the file says so for other readers
+	return KTX2::Write(layout.Format, (uint32_t)width, (uint32_t)height, levels, false, outKTX2);
+}
+
+std::string VulkanHelper::AssetCooker::GetOutputPath(const Context& context, const std::string& sourcePath, const std::string& suffix)
+{
+	std::filesystem::path relative = std::filesystem::path(sourcePath).lexically_relative(context.SourceDirectory);
+	if (relative.empty() || *relative.begin() == "..")
+		return std::string();
+
+	return AssetManager::CanonicalizePath((std::filesystem::path(context.Info.OutputDirectory) / relative).generic_string() + suffix);
+}
+
+bool VulkanHelper::AssetCooker::IsUpToDate(const Context& context, const CookManifest::Entry& previous, uint64_t seed)
+{
+	if (context.Info.Force || previous.Dependencies.empty())
+		return false;
+
+	// Every file the entry produced has to still exist, deleted outputs are cooked again
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(previous.Cooked, error))
+		return false;
+
+	for (const std::string& output : previous.Outputs)
+	{
+		if (!std::filesystem::is_regular_file(output, error))
+			return false;
+	}
+
+	bool allFound;
+	uint64_t hash = HashDependencies(previous.Dependencies, seed, &allFound);
+	return allFound && hash == previous.Hash;
+}
+
+uint64_t VulkanHelper::AssetCooker::HashDependencies(std::span<const std::string> paths, uint64_t seed, bool* outAllFound)
+{
+	*outAllFound = true;
+
+	uint64_t hash = seed;
+	for (const std::string& path : paths)
+	{
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			*outAllFound = false;
+			continue;
+		}
+
+		hash = Hash::Combine(hash, Hash::XXH64(file.GetData(), file.GetSize()));
+	}
+
+	return hash;
+}
+
+bool VulkanHelper::AssetCooker::WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	stream.write((const char*)data.data(), data.size());
+	if (!stream)
+	{
+		VH_ERROR("Failed to write {}", path);
+		return false;
+	}
+
+	return true;
+}
+
+const char* VulkanHelper::AssetCooker::GetRoleName(TextureRole role)
+{
+	switch (role)
+	{
+	case TextureRole::Color: return "color";
+	case TextureRole::Normal: return "normal";
+	case TextureRole::Roughness: return "roughness";
+	case TextureRole::Metalness: return "metalness";
+	case TextureRole::Generic: return "generic";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Pch.h"
+
+#include "AssetManager.h"
+#include "CookManifest.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Offline conversion of source assets into the formats the runtime loads fastest, needs no window or GPU.
+	 *
+	 * Textures become KTX2 files with their mip chain, one per role they are used with. Models become CookedModel files,
+	 * their embedded textures are cooked next to them. Everything is listed in a CookManifest in the output directory and
+	 * outputs whose inputs hash the same as in the previous manifest are skipped.
+	 */
+	class AssetCooker
+	{
+	public:
+		struct CreateInfo
+		{
+			std::string SourceDirectory;
+			std::string OutputDirectory;
+			uint32_t ThreadCount = 0; // 0 uses every hardware thread
+			bool Force = false; // Cook everything even if it's up to date
+		};
+
+		struct Statistics
+		{
+			uint32_t Cooked = 0;
+			uint32_t UpToDate = 0;
+			uint32_t Failed = 0;
+		};
+
+		// Bump whenever a cook step changes its output, invalidates everything cooked before
+		inline static constexpr uint32_t s_CookerVersion = 2; // 2 records the KTX2 row order
+		inline static constexpr const char* s_ManifestName = "manifest.json";
+
+		/**
+		 * @brief Cooks every model and texture of the source directory and the external textures the models use.
+		 *
+		 * Returns false if anything failed, the manifest is written either way and lists everything that succeeded.
+		 */
+		[[nodiscard]] static bool Cook(const CreateInfo& createInfo, Statistics* outStatistics);
+
+	private:
+		struct Context;
+
+		static bool CookModel(Context& context, const std::string& path, CookManifest::Entry* outEntry);
+		static bool CookTexture(Context& context, const std::string& path, TextureRole role, CookManifest::Entry* outEntry);
+
+		// Decodes like AssetImporter::ImportTexture() does and builds the KTX2 file
+		static bool CookImage(const void* data, size_t size, TextureRole role, std::vector<uint8_t>* outKTX2);
+		// pixels have as many channels as the role's layout decodes, rows bottom up like stb_image flips them
+		static bool CookPixels(const uint8_t* pixels, int width, int height, int sourceChannels, TextureRole role, std::vector<uint8_t>* outKTX2);
+
+		// Path of the cooked file, empty if the source lies outside of the source directory
+		static std::string GetOutputPath(const Context& context, const std::string& sourcePath, const std::string& suffix);
+		static bool IsUpToDate(const Context& context, const CookManifest::Entry& previous, uint64_t seed);
+		static uint64_t HashDependencies(std::span<const std::string> paths, uint64_t seed, bool* outAllFound);
+		static bool WriteFile(const std::string& path, const std::vector<uint8_t>& data);
+		static const char* GetRoleName(TextureRole role);
+	};
+}
@@ -2,97 +2,716 @@
 #include "Pch.h"
 #include "AssetImporter.h"
 #include "Vulkan/Device.h"
+#include "Vulkan/UploadBatch.h"
 
+// stb_image allocations are routed through these so a decode can land directly in staging memory, see DecodeTarget
+static void* StbiMalloc(size_t size);
+static void* StbiRealloc(void* memory, size_t size);
+static void StbiFree(void* memory);
+
+#define STBI_MALLOC(size) StbiMalloc(size)
+#define STBI_REALLOC(memory, size) StbiRealloc(memory, size)
+#define STBI_FREE(memory) StbiFree(memory)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include "Logger/Logger.h"
+#include "Utility/Half.h"
+#include "Package.h"
+#include "AssetProfiler.h"
+#include "MappedIOSystem.h"
+#include "GLTFImporter.h"
+#include "KTX2.h"
+#include "CookedModel.h"
 
 #include "glm.hpp"
+#include "gtc/constants.hpp"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <assimp/texture.h>
+
+// When set, the first allocation of exactly Size bytes is served from Memory instead of the heap. stb_image
+// allocates its final RGBA output in one piece, so that's where decoded and flipped pixels end up. Any other
+// allocation that happens to match is harmless, the caller checks which pointer came back and copies if needed.
+struct DecodeTarget
+{
+	void* Memory = nullptr;
+	size_t Size = 0;
+	bool InUse = false;
+};
+static thread_local DecodeTarget s_DecodeTarget;
+
+static void* StbiMalloc(size_t size)
+{
+	if (s_DecodeTarget.Memory != nullptr && !s_DecodeTarget.InUse && size == s_DecodeTarget.Size)
+	{
+		s_DecodeTarget.InUse = true;
+		return s_DecodeTarget.Memory;
+	}
+
+	return malloc(size);
+}
+
+static void* StbiRealloc(void* memory, size_t size)
+{
+	if (memory != nullptr && memory == s_DecodeTarget.Memory)
+	{
+		// Never grow in place inside the staging range, move out to the heap
+		void* newMemory = malloc(size);
+		if (newMemory)
+			memcpy(newMemory, memory, std::min(size, s_DecodeTarget.Size));
+
+		s_DecodeTarget.InUse = false;
+		return newMemory;
+	}
 
-VulkanHelper::Image VulkanHelper::AssetImporter::ImportTexture(Device* device, std::string path, bool HDR)
+	return realloc(memory, size);
+}
+
+static void StbiFree(void* memory)
 {
-	std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+	if (memory != nullptr && memory == s_DecodeTarget.Memory)
+	{
+		s_DecodeTarget.InUse = false;
+		return;
+	}
 
+	free(memory);
+}
+
+std::string VulkanHelper::AssetImporter::GetTextureFilePath(std::string path)
+{
+	// Model files store spaces in texture names as '%'
 	for (int i = 0; i < path.size(); i++)
 	{
 		if (path[i] == '%')
 			path[i] = ' ';
 	}
 
-	int texChannels;
-	bool flipOnLoad = !HDR;
-	stbi_set_flip_vertically_on_load_thread(flipOnLoad);
-	int sizeX, sizeY;
-	void* pixels;
+	return path;
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::ImportTexture(Device* device, std::string path, bool HDR, UploadBatch* batch /*= nullptr*/, TextureRole role /*= TextureRole::Color*/)
+{
+	path = GetTextureFilePath(path);
+
+	// Decoding straight from the mapping skips the stdio buffer copy
+	AssetFile file;
+	if (!AssetManager::OpenFile(path, &file))
+	{
+		VH_ERROR("Failed to open texture: {0}", path);
+		return Image();
+	}
+
+	return ImportTexture(device, file.Data, file.Size, path, HDR, batch, role);
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::ImportTexture(Device* device, const void* data, size_t size, const std::string& name, bool HDR, UploadBatch* batch /*= nullptr*/, TextureRole role /*= TextureRole::Color*/)
+{
+	// Precompressed containers keep their own format and mip chain, role and HDR don't apply
+	if (KTX2::IsKTX2(data, size))
+		return ImportKTX2(device, data, size, name, batch);
+
+	std::filesystem::path cwd = std::filesystem::current_path();
+
+	// Header only, needed to size the staging memory before decoding
+	int sizeX = 0, sizeY = 0, texChannels = 0;
+	bool validHeader = data != nullptr && stbi_info_from_memory((const stbi_uc*)data, (int)size, &sizeX, &sizeY, &texChannels);
+	if (!validHeader)
+	{
+		VH_ERROR("failed to load texture image! Path: {0}, Current working directory: {1}", name, cwd.string());
+		return Image();
+	}
+
+	uint64_t pixelCount = (uint64_t)sizeX * (uint64_t)sizeY;
+	TextureLayout layout = ChooseTextureLayout(role, texChannels);
+	VkFormat format = HDR ? AssetManager::GetHDRFormat() : layout.Format;
+	VkDeviceSize imageSize = HDR ? pixelCount * GetHDRPixelSize(format) : pixelCount * layout.Channels;
+
+	UploadBatch localBatch;
+	if (!batch)
+	{
+		localBatch.Init({ device });
+		batch = &localBatch;
+	}
+
+	UploadBatch::StagingAllocation staging;
+	if (batch->AllocateStaging(imageSize, &staging) != ResultCode::Success)
+	{
+		VH_ERROR("Failed to allocate {0} bytes of staging memory for texture {1}", imageSize, name);
+		return Image();
+	}
+
+	AssetProfiler::ScopedTimer decodeTimer(name, AssetStage::Decode, size);
+
+	stbi_set_flip_vertically_on_load_thread(!HDR);
+	void* pixels = nullptr;
 	if (HDR)
 	{
-		pixels = stbi_loadf(path.c_str(), &sizeX, &sizeY, &texChannels, STBI_rgb_alpha);
+		// Floats have to be converted anyway, the conversion writes straight into staging
+		pixels = stbi_loadf_from_memory((const stbi_uc*)data, (int)size, &sizeX, &sizeY, &texChannels, STBI_rgb_alpha);
 	}
 	else
 	{
-		pixels = stbi_load(path.c_str(), &sizeX, &sizeY, &texChannels, STBI_rgb_alpha);
+		// Full decodes land straight in staging, one channel out of a multi channel source has to go through a temporary decode
+		if (layout.SourceChannel < 0)
+			s_DecodeTarget = { staging.Data, (size_t)imageSize, false };
+
+		pixels = stbi_load_from_memory((const stbi_uc*)data, (int)size, &sizeX, &sizeY, &texChannels, layout.DecodeChannels);
 	}
 
-	std::filesystem::path cwd = std::filesystem::current_path();
-	VH_ASSERT(pixels, "failed to load texture image! Path: {0}, Current working directory: {1}", path, cwd.string());
-	uint64_t sizeOfPixel = HDR ? sizeof(float) * 4 : sizeof(uint8_t) * 4;
-	VkDeviceSize imageSize = (uint64_t)sizeX * (uint64_t)sizeY * sizeOfPixel;
+	if (!pixels)
+	{
+		s_DecodeTarget = {};
+		VH_ERROR("failed to load texture image! Path: {0}, Current working directory: {1}", name, cwd.string());
+		return Image();
+	}
+
+	if (HDR)
+	{
+		ConvertHDRPixels((float*)pixels, pixelCount, format, staging.Data);
+	}
+	else if (layout.SourceChannel >= 0)
+	{
+		const uint8_t* src = (const uint8_t*)pixels + layout.SourceChannel;
+		uint8_t* dst = (uint8_t*)staging.Data;
+		for (uint64_t i = 0; i < pixelCount; i++)
+		{
+			dst[i] = src[i * layout.DecodeChannels];
+		}
+	}
+	else if (pixels != staging.Data)
+	{
+		// Only happens if some decoder ever allocates its output in several steps
+		memcpy(staging.Data, pixels, imageSize);
+	}
+
+	stbi_image_free(pixels);
+	s_DecodeTarget = {};
+	decodeTimer.Stop();
+
+	Image image = CreateTextureImage(device, sizeX, sizeY, format, batch, staging);
+
+	if (batch == &localBatch)
+	{
+		AssetProfiler::ScopedTimer uploadTimer(name, AssetStage::UploadWait, imageSize);
+		localBatch.Submit();
+	}
+
+	return Image(std::move(image));
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::ImportKTX2(Device* device, const void* data, size_t size, const std::string& name, UploadBatch* batch /*= nullptr*/)
+{
+	KTX2::Info info;
+	std::string error;
+	bool valid = KTX2::Parse(data, size, &info, &error);
+	if (!valid)
+	{
+		VH_ERROR("Failed to load KTX2 texture! Path: {0}, Error: {1}", name, error);
+		return Image();
+	}
+
+	VkFormat supportedFormat = device->GetPhysicalDevice().FindSupportedFormat({ info.Format }, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT);
+	if (supportedFormat == VK_FORMAT_UNDEFINED)
+	{
+		VH_ERROR("KTX2 texture format isn't supported by the device! Path: {0}, Format: {1}", name, (uint32_t)info.Format);
+		return Image();
+	}
+
+	// Every other texture is uploaded bottom row first (stb_image flips on load, importers flip the V coordinate), so
+	// top down files are flipped to match. Cube map faces are sampled with Vulkan's own orientation and stay as they are
+	bool flip = info.TopDown && info.FaceCount == 1;
+	if (flip && !KTX2::CanFlipVertically(info))
+	{
+		VH_WARN("KTX2 texture {0} is stored top down in a format that can't be flipped, it's sampled upside down. Store it bottom up (KTXorientation \"ru\") instead", name);
+		flip = false;
+	}
 
+	UploadBatch localBatch;
+	if (!batch)
+	{
+		localBatch.Init({ device });
+		batch = &localBatch;
+	}
+
+	// Every level goes into one staging allocation, offsets kept aligned for the copy
+	uint32_t subresourceCount = info.LayerCount * info.FaceCount;
+	std::vector<VkDeviceSize> levelOffsets(info.LevelCount);
+	VkDeviceSize stagingSize = 0;
+	for (uint32_t level = 0; level < info.LevelCount; level++)
+	{
+		levelOffsets[level] = stagingSize;
+		stagingSize += (info.Levels[level].UncompressedSize + 15) & ~15ull;
+	}
+
+	UploadBatch::StagingAllocation staging;
+	if (batch->AllocateStaging(stagingSize, &staging) != ResultCode::Success)
+	{
+		VH_ERROR("Failed to allocate {0} bytes of staging memory for texture {1}", stagingSize, name);
+		return Image();
+	}
+
+	AssetProfiler::ScopedTimer decodeTimer(name, AssetStage::Decode, size);
+
+	std::vector<VkBufferImageCopy> regions(info.LevelCount);
+	for (uint32_t level = 0; level < info.LevelCount; level++)
+	{
+		bool decompressed = KTX2::DecompressLevel(info, data, info.Levels[level], (uint8_t*)staging.Data + levelOffsets[level]);
+		if (!decompressed)
+		{
+			VH_ERROR("Failed to decompress KTX2 level! Path: {0}, Level: {1}", name, level);
+			return Image();
+		}
+
+		if (flip)
+			KTX2::FlipVertically(info, level, (uint8_t*)staging.Data + levelOffsets[level]);
+
+		VkBufferImageCopy& region = regions[level];
+		region.bufferOffset = levelOffsets[level];
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = level;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = subresourceCount;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { std::max(info.Width >> level, 1u), std::max(info.Height >> level, 1u), 1 };
+	}
+
+	decodeTimer.Stop();
+
+	Image::CreateInfo imageInfo{};
+	imageInfo.Device = device;
+	imageInfo.Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageInfo.Format = info.Format;
+	imageInfo.Width = info.Width;
+	imageInfo.Height = info.Height;
+	imageInfo.LayerCount = subresourceCount;
+	imageInfo.MipMapCount = info.LevelCount;
+	imageInfo.Properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	imageInfo.Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	if (info.FaceCount == 6)
+		imageInfo.ViewType = info.LayerCount > 1 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+	else
+		imageInfo.ViewType = info.LayerCount > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+
+	Image image;
+	(void)image.Init(imageInfo);
+
+	(void)batch->UploadStagingToImage(&image, staging, regions);
+
+	if (batch == &localBatch)
+	{
+		AssetProfiler::ScopedTimer uploadTimer(name, AssetStage::UploadWait, stagingSize);
+		localBatch.Submit();
+	}
+
+	return Image(std::move(image));
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::ImportEmbeddedTexture(Device* device, const aiTexture* texture, const std::string& name, UploadBatch* batch, TextureRole role)
+{
+	// Compressed, pcData holds the whole image file
+	if (texture->mHeight == 0)
+		return ImportTexture(device, texture->pcData, texture->mWidth, name, false, batch, role);
+
+	// Raw BGRA8 texels
+	uint32_t width = texture->mWidth;
+	uint32_t height = texture->mHeight;
+	TextureLayout layout = ChooseTextureLayout(role, 4);
+
+	UploadBatch::StagingAllocation staging;
+	if (batch->AllocateStaging((VkDeviceSize)width * height * layout.Channels, &staging) != ResultCode::Success)
+	{
+		VH_ERROR("Failed to allocate staging memory for embedded texture {0}", name);
+		return Image();
+	}
+
+	// Flipped like everything going through stb_image
+	AssetProfiler::ScopedTimer decodeTimer(name, AssetStage::Decode, (uint64_t)width * height * sizeof(aiTexel));
+
+	uint8_t* dst = (uint8_t*)staging.Data;
+	for (uint32_t y = 0; y < height; y++)
+	{
+		const aiTexel* srcRow = texture->pcData + (size_t)(height - 1 - y) * width;
+		for (uint32_t x = 0; x < width; x++)
+		{
+			uint8_t texel[4] = { srcRow[x].r, srcRow[x].g, srcRow[x].b, srcRow[x].a };
+			if (layout.SourceChannel >= 0)
+				*dst++ = texel[layout.SourceChannel];
+			else
+				for (int c = 0; c < layout.Channels; c++)
+					*dst++ = texel[c];
+		}
+	}
+
+	decodeTimer.Stop();
+
+	return CreateTextureImage(device, (int)width, (int)height, layout.Format, batch, staging);
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::CreateTextureImage(Device* device, int width, int height, VkFormat format, UploadBatch* batch, const UploadBatch::StagingAllocation& staging)
+{
 	Image::CreateInfo info{};
 	info.Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
-	info.Format = HDR ? VK_FORMAT_R32G32B32A32_SFLOAT : VK_FORMAT_R8G8B8A8_UNORM;
-	info.Height = sizeY;
-	info.Width = sizeX;
+	info.Format = format;
+	info.Height = height;
+	info.Width = width;
 	info.Properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 	info.Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-	info.MipMapCount = glm::min(5, (int)glm::floor(glm::log2((float)glm::max(sizeX, sizeY))));
+	info.MipMapCount = glm::max(1, glm::min(5, (int)glm::floor(glm::log2((float)glm::max(width, height)))));
 	info.Device = device;
 	Image image;
 	image.Init(info);
 
-	image.WritePixels(pixels, imageSize, true);
+	(void)batch->UploadStagingToImage(&image, staging, true);
+
+	return Image(std::move(image));
+}
+
+VulkanHelper::Image VulkanHelper::AssetImporter::ImportEnvironmentMap(Device* device, std::string path, uint32_t faceSize, UploadBatch* batch /*= nullptr*/)
+{
+	for (int i = 0; i < path.size(); i++)
+	{
+		if (path[i] == '%')
+			path[i] = ' ';
+	}
+
+	int texChannels;
+	stbi_set_flip_vertically_on_load_thread(false);
+	int sizeX, sizeY;
+	AssetFile file;
+	float* pixels = nullptr;
+	bool opened = AssetManager::OpenFile(path, &file);
+	AssetProfiler::ScopedTimer decodeTimer(path, AssetStage::Decode, file.Size);
+	if (opened)
+		pixels = stbi_loadf_from_memory(file.Data, (int)file.Size, &sizeX, &sizeY, &texChannels, STBI_rgb_alpha);
+	file = AssetFile();
+
+	if (!pixels)
+	{
+		std::filesystem::path cwd = std::filesystem::current_path();
+		VH_ERROR("failed to load environment map! Path: {0}, Current working directory: {1}", path, cwd.string());
+		return Image();
+	}
+
+	if (faceSize == 0)
+		faceSize = glm::max(sizeX / 4, 1);
+
+	VkFormat format = AssetManager::GetHDRFormat();
+	uint64_t faceTexelCount = (uint64_t)faceSize * (uint64_t)faceSize;
+	uint64_t faceByteSize = faceTexelCount * GetHDRPixelSize(format);
+
+	UploadBatch localBatch;
+	if (!batch)
+	{
+		localBatch.Init({ device });
+		batch = &localBatch;
+	}
+
+	// All 6 faces tightly packed in Vulkan's +X, -X, +Y, -Y, +Z, -Z order, written straight into staging memory
+	UploadBatch::StagingAllocation staging;
+	if (batch->AllocateStaging(faceByteSize * 6, &staging) != ResultCode::Success)
+	{
+		VH_ERROR("Failed to allocate staging memory for environment map {0}", path);
+		stbi_image_free(pixels);
+		return Image();
+	}
+	char* cubePixels = (char*)staging.Data;
+	uint64_t rowByteSize = (uint64_t)faceSize * GetHDRPixelSize(format);
+	std::vector<float> rowPixels((size_t)faceSize * 4);
+	for (uint32_t face = 0; face < 6; face++)
+	{
+		for (uint32_t y = 0; y < faceSize; y++)
+		{
+			for (uint32_t x = 0; x < faceSize; x++)
+			{
+				glm::vec2 uv = (glm::vec2((float)x, (float)y) + 0.5f) / (float)faceSize * 2.0f - 1.0f;
+				glm::vec3 dir = glm::normalize(CubeFaceDirection(face, uv));
+
+				// Direction to equirectangular coords, +Y is the top row of the source image
+				glm::vec2 equirectUV;
+				equirectUV.x = glm::atan(dir.z, dir.x) / (2.0f * glm::pi<float>()) + 0.5f;
+				equirectUV.y = glm::acos(glm::clamp(dir.y, -1.0f, 1.0f)) / glm::pi<float>();
+
+				glm::vec4 color = SampleBilinear(pixels, sizeX, sizeY, equirectUV);
+				memcpy(&rowPixels[(size_t)x * 4], &color, sizeof(glm::vec4));
+			}
+
+			ConvertHDRPixels(rowPixels.data(), faceSize, format, cubePixels + face * faceByteSize + rowByteSize * y);
+		}
+	}
 
 	stbi_image_free(pixels);
+	decodeTimer.Stop();
+
+	Image::CreateInfo info{};
+	info.Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+	info.Format = format;
+	info.Height = faceSize;
+	info.Width = faceSize;
+	info.Properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	info.Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	info.MipMapCount = glm::max(1, glm::min(5, (int)glm::floor(glm::log2((float)faceSize))));
+	info.ViewType = VK_IMAGE_VIEW_TYPE_CUBE;
+	info.LayerCount = 6;
+	info.Device = device;
+	Image image;
+	image.Init(info);
+
+	(void)batch->UploadStagingToImage(&image, staging, true);
+
+	if (batch == &localBatch)
+	{
+		AssetProfiler::ScopedTimer uploadTimer(path, AssetStage::UploadWait, faceByteSize * 6);
+		localBatch.Submit();
+	}
 
 	return Image(std::move(image));
 }
 
+VulkanHelper::AssetImporter::TextureLayout VulkanHelper::AssetImporter::ChooseTextureLayout(TextureRole role, int sourceChannels)
+{
+	TextureLayout layout;
+	switch (role)
+	{
+	case TextureRole::Roughness:
+	case TextureRole::Metalness:
+		layout.Format = VK_FORMAT_R8_UNORM;
+		layout.Channels = 1;
+		if (sourceChannels >= 3)
+		{
+			// glTF packs roughness into G and metalness into B of the same texture
+			layout.DecodeChannels = 3;
+			layout.SourceChannel = role == TextureRole::Roughness ? 1 : 2;
+		}
+		else
+		{
+			layout.DecodeChannels = 1;
+		}
+		break;
+	case TextureRole::Generic:
+		if (sourceChannels == 1)
+		{
+			layout.Format = VK_FORMAT_R8_UNORM;
+			layout.Channels = 1;
+		}
+		else if (sourceChannels == 2)
+		{
+			layout.Format = VK_FORMAT_R8G8_UNORM;
+			layout.Channels = 2;
+		}
+		layout.DecodeChannels = layout.Channels;
+		break;
+	default:
+		break;
+	}
+
+	return layout;
+}
+
+uint32_t VulkanHelper::AssetImporter::GetHDRPixelSize(VkFormat format)
+{
+	return format == VK_FORMAT_B10G11R11_UFLOAT_PACK32 ? (uint32_t)sizeof(uint32_t) : 4 * (uint32_t)sizeof(uint16_t);
+}
+
+void VulkanHelper::AssetImporter::ConvertHDRPixels(const float* pixels, uint64_t pixelCount, VkFormat format, void* outPixels)
+{
+	if (format == VK_FORMAT_B10G11R11_UFLOAT_PACK32)
+	{
+		Half::ToB10G11R11(pixels, (uint32_t*)outPixels, pixelCount);
+	}
+	else
+	{
+		VH_ASSERT(format == VK_FORMAT_R16G16B16A16_SFLOAT, "Unsupported HDR format! Format: {}", (int)format);
+
+		Half::FromFloats(pixels, (uint16_t*)outPixels, pixelCount * 4);
+	}
+}
+
+glm::vec3 VulkanHelper::AssetImporter::CubeFaceDirection(uint32_t face, glm::vec2 uv)
+{
+	switch (face)
+	{
+	case 0: return glm::vec3(1.0f, -uv.y, -uv.x);	// +X
+	case 1: return glm::vec3(-1.0f, -uv.y, uv.x);	// -X
+	case 2: return glm::vec3(uv.x, 1.0f, uv.y);		// +Y
+	case 3: return glm::vec3(uv.x, -1.0f, -uv.y);	// -Y
+	case 4: return glm::vec3(uv.x, -uv.y, 1.0f);	// +Z
+	default: return glm::vec3(-uv.x, -uv.y, -1.0f);	// -Z
+	}
+}
+
+glm::vec4 VulkanHelper::AssetImporter::SampleBilinear(const float* pixels, int width, int height, glm::vec2 uv)
+{
+	float x = uv.x * (float)width - 0.5f;
+	float y = uv.y * (float)height - 0.5f;
+	int x0 = (int)glm::floor(x);
+	int y0 = (int)glm::floor(y);
+	float fx = x - (float)x0;
+	float fy = y - (float)y0;
+
+	auto fetch = [&](int px, int py)
+		{
+			px = ((px % width) + width) % width; // Wrap horizontally
+			py = glm::clamp(py, 0, height - 1);
+			const float* texel = pixels + ((size_t)py * width + px) * 4;
+			return glm::vec4(texel[0], texel[1], texel[2], texel[3]);
+		};
+
+	glm::vec4 top = glm::mix(fetch(x0, y0), fetch(x0 + 1, y0), fx);
+	glm::vec4 bottom = glm::mix(fetch(x0, y0 + 1), fetch(x0 + 1, y0 + 1), fx);
+	return glm::mix(top, bottom, fy);
+}
+
 void VulkanHelper::AssetImporter::ImportModel(
 	Device* device,
 	std::string path,
 	std::vector<Mesh>* outMeshes,
 	std::vector<std::string>* outMeshNames,
 	std::vector<glm::mat4>* outMeshTransfrorms,
-	std::vector<Material>* outMaterials
+	std::vector<Material>* outMaterials,
+	std::vector<uint32_t>* outMeshMaterialIndices,
+	std::vector<MeshInstance>* outInstances
+)
+{
+	// Cooked models skip parsing entirely, they are either requested directly or the cook manifest redirects to them
+	std::string cookedPath = AssetManager::GetCookedPath(AssetManager::GetAssetID(path));
+	if (cookedPath.empty() && AssetManager::GetExtension(path) == ".vhmodel")
+		cookedPath = path;
+
+	if (!cookedPath.empty())
+	{
+		AssetFile file;
+		if (AssetManager::OpenFile(cookedPath, &file) && ImportCookedModel(device, file.Data, file.Size, cookedPath, outMeshes, outMeshNames, outMeshTransfrorms, outMaterials, outMeshMaterialIndices, outInstances))
+			return;
+
+		VH_WARN("Failed to load cooked model {}, falling back to {}", cookedPath, path);
+	}
+
+	// Most content is glTF, which loads much faster without going through Assimp's scene and post processing
+	if (GLTFImporter::ImportModel(device, path, outMeshes, outMeshNames, outMeshTransfrorms, outMaterials, outMeshMaterialIndices, outInstances))
+	{
+		VH_TRACE("Loaded {} with the native glTF importer", path);
+		return;
+	}
+
+	ImportAssimpModel(device, path, outMeshes, outMeshNames, outMeshTransfrorms, outMaterials, outMeshMaterialIndices, outInstances);
+}
+
+void VulkanHelper::AssetImporter::ImportAssimpModel(
+	Device* device,
+	const std::string& path,
+	std::vector<Mesh>* outMeshes,
+	std::vector<std::string>* outMeshNames,
+	std::vector<glm::mat4>* outMeshTransfrorms,
+	std::vector<Material>* outMaterials,
+	std::vector<uint32_t>* outMeshMaterialIndices,
+	std::vector<MeshInstance>* outInstances
 )
 {
+	AssetProfiler::ScopedTimer parseTimer(path, AssetStage::Parse);
+
 	Assimp::Importer importer;
-	const aiScene* scene = importer.ReadFile(path,
-		aiProcess_CalcTangentSpace |
-		aiProcess_GenSmoothNormals |
-		aiProcess_ImproveCacheLocality |
-		aiProcess_RemoveRedundantMaterials |
-		aiProcess_SplitLargeMeshes |
-		aiProcess_Triangulate |
-		aiProcess_GenUVCoords |
-		aiProcess_SortByPType |
-		aiProcess_FindDegenerates |
-		aiProcess_FindInvalidData);
+	importer.SetIOHandler(new MappedIOSystem()); // Importer takes ownership
+	const aiScene* scene = importer.ReadFile(path, GetAssimpImportFlags());
+	parseTimer.Stop();
+
 	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
 	{
 		VH_ERROR("Failed to load model: {0}", importer.GetErrorString());
 		return;
 	}
 
-	int index = 0;
-	ProcessAssimpNode(device, scene->mRootNode, scene, path, outMeshes, outMeshNames, outMeshTransfrorms, outMaterials, index);
+	// Walk the node tree first and only collect instances, conversion and upload runs in parallel afterwards
+	uint32_t firstMesh = (uint32_t)outMeshes->size();
+	size_t firstInstance = outInstances->size();
+	GatherAssimpInstances(scene, firstMesh, outInstances);
+
+	// Every aiMesh becomes exactly one Mesh no matter how many nodes reference it. Name and transform of
+	// a mesh are taken from its first instance, meshes without any instance keep their own name and identity
+	std::vector<bool> hasInstance(scene->mNumMeshes, false);
+	outMeshNames->resize(firstMesh + scene->mNumMeshes);
+	outMeshTransfrorms->resize(firstMesh + scene->mNumMeshes, glm::mat4(1.0f));
+	for (size_t i = firstInstance; i < outInstances->size(); i++)
+	{
+		const MeshInstance& instance = (*outInstances)[i];
+		uint32_t localIndex = instance.MeshIndex - firstMesh;
+		if (hasInstance[localIndex])
+			continue;
+
+		hasInstance[localIndex] = true;
+		(*outMeshNames)[instance.MeshIndex] = instance.NodeName;
+		(*outMeshTransfrorms)[instance.MeshIndex] = instance.Transform;
+	}
+
+	// Materials are cheap, doing them first starts the texture loads while meshes are being converted.
+	// Every aiMaterial is processed once, meshes sharing it share the index
+	AssetID modelID = AssetManager::GetAssetID(path);
+	std::vector<EmbeddedTextureLoad> embeddedLoads;
+	uint32_t firstMaterial = (uint32_t)outMaterials->size();
+	std::vector<uint32_t> materialRemap(scene->mNumMaterials, UINT32_MAX);
+	for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+	{
+		if (!hasInstance[i])
+			(*outMeshNames)[firstMesh + i] = scene->mMeshes[i]->mName.C_Str();
+
+		uint32_t aiMaterialIndex = scene->mMeshes[i]->mMaterialIndex;
+		if (materialRemap[aiMaterialIndex] == UINT32_MAX)
+		{
+			materialRemap[aiMaterialIndex] = (uint32_t)outMaterials->size();
+			outMaterials->push_back(ProcessAssimpMaterial(scene, scene->mMaterials[aiMaterialIndex], modelID, &embeddedLoads));
+		}
+
+		outMeshMaterialIndices->push_back(materialRemap[aiMaterialIndex]);
+	}
+
+	// Every mesh writes only its own slot so the output order matches scene->mMeshes
+	outMeshes->resize(firstMesh + scene->mNumMeshes);
+
+	// Embedded textures only live as long as the scene, so they are decoded here next to the meshes
+	// instead of going through the asset manager queue. Everything shares one submission
+	UploadBatch batch({ device });
+	AssetManager::GetThreadPool().ParallelFor(scene->mNumMeshes + (uint32_t)embeddedLoads.size(), [&](uint32_t i)
+		{
+			if (i < scene->mNumMeshes)
+			{
+				AssetProfiler::ScopedTimer meshTimer(path, AssetStage::MeshBuild);
+				Mesh& mesh = (*outMeshes)[firstMesh + i];
+				(void)mesh.Init(device, scene->mMeshes[i], scene, glm::mat4(1.0f), &batch);
+				meshTimer.SetBytes(mesh.GetVertexCount() * sizeof(Mesh::DefaultVertex) + mesh.GetIndexCount() * sizeof(uint32_t));
+				return;
+			}
+
+			EmbeddedTextureLoad& load = embeddedLoads[i - scene->mNumMeshes];
+			std::shared_ptr<Asset> asset = load.Asset.lock();
+			if (!asset) // Every handle already dropped
+				return;
+
+			std::string name = path + "/*" + std::to_string(load.TextureIndex);
+			VH_TRACE("Loading Embedded Texture: {}", name);
+
+			TextureAsset* textureAsset = (TextureAsset*)asset.get();
+			textureAsset->Image = ImportEmbeddedTexture(device, scene->mTextures[load.TextureIndex], name, &batch, load.Role);
+			AssetManager::s_TexturesLoaded++;
+			load.KeepAlive = std::move(asset);
+		});
+
+	{
+		AssetProfiler::ScopedTimer uploadTimer(path, AssetStage::UploadWait);
+		batch.Submit();
+	}
+
+	for (EmbeddedTextureLoad& load : embeddedLoads)
+	{
+		load.KeepAlive.reset();
+		load.Promise->set_value();
+	}
 
-	for (size_t i = 0; i < outMaterials->size(); i++)
+	for (size_t i = firstMaterial; i < outMaterials->size(); i++)
 	{
 		(*outMaterials)[i].AlbedoTexture.WaitToLoad();
 		(*outMaterials)[i].NormalTexture.WaitToLoad();
@@ -101,125 +720,238 @@ void VulkanHelper::AssetImporter::ImportModel(
 	}
 }
 
-void VulkanHelper::AssetImporter::ProcessAssimpNode(
+bool VulkanHelper::AssetImporter::ImportCookedModel(
 	Device* device,
-	aiNode* node,
-	const aiScene* scene,
-	const std::string& filepath,
+	const void* data,
+	size_t size,
+	const std::string& path,
 	std::vector<Mesh>* outMeshes,
 	std::vector<std::string>* outMeshNames,
 	std::vector<glm::mat4>* outMeshTransfrorms,
 	std::vector<Material>* outMaterials,
-	int& index
+	std::vector<uint32_t>* outMeshMaterialIndices,
+	std::vector<MeshInstance>* outInstances
 )
 {
-	// process each mesh located at the current node
-	for (unsigned int i = 0; i < node->mNumMeshes; i++)
+	AssetProfiler::ScopedTimer parseTimer(path, AssetStage::Parse, size);
+
+	CookedModel::Info info;
+	std::string error;
+	if (!CookedModel::Parse(data, size, &info, &error))
 	{
-		glm::mat4 transform = glm::transpose(*(glm::mat4*)(&node->mTransformation));
-		aiNode* currNode = node;
-		while (true)
+		VH_WARN("Invalid cooked model {}: {}", path, error);
+		return false;
+	}
+
+	parseTimer.Stop();
+
+	static constexpr TextureRole s_SlotRoles[CookedModel::MaterialTextureCount] = { TextureRole::Color, TextureRole::Normal, TextureRole::Roughness, TextureRole::Metalness };
+
+	// Texture loads start before the meshes are copied
+	uint32_t firstMaterial = (uint32_t)outMaterials->size();
+	for (const CookedModel::MaterialData& materialData : info.Materials)
+	{
+		AssetHandle textures[CookedModel::MaterialTextureCount];
+		for (uint32_t slot = 0; slot < CookedModel::MaterialTextureCount; slot++)
 		{
-			if (currNode->mParent)
-			{
-				currNode = currNode->mParent;
-				transform = glm::transpose(*(glm::mat4*)(&currNode->mTransformation)) * transform;
-			}
-			else
-			{
-				break;
-			}
+			const std::string& texturePath = materialData.TexturePaths[slot];
+			textures[slot] = AssetManager::GetAsset(texturePath.empty() ? GetFallbackTexture(s_SlotRoles[slot]) : texturePath, s_SlotRoles[slot]);
 		}
 
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		std::string meshName = node->mName.C_Str();
+		Material mat = materialData.Parameters;
+		mat.AlbedoTexture = textures[CookedModel::MaterialTextureAlbedo];
+		mat.NormalTexture = textures[CookedModel::MaterialTextureNormal];
+		mat.RoughnessTexture = textures[CookedModel::MaterialTextureRoughness];
+		mat.MetallnessTexture = textures[CookedModel::MaterialTextureMetalness];
+		outMaterials->push_back(std::move(mat));
+	}
+
+	uint32_t firstMesh = (uint32_t)outMeshes->size();
+	uint32_t meshCount = (uint32_t)info.Meshes.size();
+	outMeshes->resize(firstMesh + meshCount);
+	for (const CookedModel::MeshView& mesh : info.Meshes)
+	{
+		outMeshNames->push_back(mesh.Name);
+		outMeshTransfrorms->push_back(mesh.Transform);
+		outMeshMaterialIndices->push_back(firstMaterial + mesh.MaterialIndex);
+	}
+
+	for (MeshInstance& instance : info.Instances)
+	{
+		instance.MeshIndex += firstMesh;
+		outInstances->push_back(std::move(instance));
+	}
 
+	// Vertices are already in the final layout, building a mesh is a copy into staging
+	UploadBatch batch({ device });
+	AssetManager::GetThreadPool().ParallelFor(meshCount, [&](uint32_t i)
 		{
-			Mesh vhMesh;
-			vhMesh.Init(device, mesh, scene);
+			const CookedModel::MeshView& mesh = info.Meshes[i];
+			AssetProfiler::ScopedTimer meshTimer(path, AssetStage::MeshBuild, mesh.VertexCount * sizeof(Mesh::DefaultVertex) + mesh.IndexCount * sizeof(uint32_t));
+			(void)(*outMeshes)[firstMesh + i].Init(device, mesh.VertexCount, mesh.IndexCount, &batch, [&](Mesh::DefaultVertex* vertices, uint32_t* indices)
+				{
+					memcpy(vertices, mesh.Vertices, mesh.VertexCount * sizeof(Mesh::DefaultVertex));
+					if (mesh.IndexCount > 0)
+						memcpy(indices, mesh.Indices, mesh.IndexCount * sizeof(uint32_t));
+				});
+		});
 
-			outMeshNames->push_back(meshName);
-			outMeshes->emplace_back(std::move(vhMesh));
-		}
+	{
+		AssetProfiler::ScopedTimer uploadTimer(path, AssetStage::UploadWait);
+		batch.Submit();
+	}
 
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		Material mat;
+	for (size_t i = firstMaterial; i < outMaterials->size(); i++)
+	{
+		(*outMaterials)[i].AlbedoTexture.WaitToLoad();
+		(*outMaterials)[i].NormalTexture.WaitToLoad();
+		(*outMaterials)[i].MetallnessTexture.WaitToLoad();
+		(*outMaterials)[i].RoughnessTexture.WaitToLoad();
+	}
 
-		aiColor4D emissiveColor(0.0f, 0.0f, 0.0f, 0.0f);
-		aiColor4D diffuseColor(0.0f, 0.0f, 0.0f, 0.0f);
+	return true;
+}
 
-		{
-			std::string matName = material->GetName().C_Str();
+uint32_t VulkanHelper::AssetImporter::GetAssimpImportFlags()
+{
+	return
+		aiProcess_CalcTangentSpace |
+		aiProcess_GenSmoothNormals |
+		aiProcess_ImproveCacheLocality |
+		aiProcess_RemoveRedundantMaterials |
+		aiProcess_SplitLargeMeshes |
+		aiProcess_Triangulate |
+		aiProcess_GenUVCoords |
+		aiProcess_SortByPType |
+		aiProcess_FindDegenerates |
+		aiProcess_FindInvalidData;
+}
 
-			outMaterials->emplace_back();
-			(*outMaterials)[outMaterials->size() - 1].MaterialName = matName;
+void VulkanHelper::AssetImporter::GatherAssimpInstances(const aiScene* scene, uint32_t firstMesh, std::vector<MeshInstance>* outInstances)
+{
+	struct NodeEntry
+	{
+		const aiNode* Node;
+		glm::mat4 ParentTransform;
+	};
+
+	// Top down, every node multiplies its local matrix onto the already computed parent transform once
+	std::vector<NodeEntry> stack;
+	stack.push_back({ scene->mRootNode, glm::mat4(1.0f) });
+	while (!stack.empty())
+	{
+		NodeEntry entry = stack.back();
+		stack.pop_back();
 
-			material->Get(AI_MATKEY_COLOR_EMISSIVE, emissiveColor);
-			material->Get(AI_MATKEY_EMISSIVE_INTENSITY, emissiveColor.a);
-			material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuseColor);
-			material->Get(AI_MATKEY_ROUGHNESS_FACTOR, mat.Roughness);
-			material->Get(AI_MATKEY_METALLIC_FACTOR, mat.Metallic);
-			material->Get(AI_MATKEY_REFRACTI, mat.Ior);
-			material->Get(AI_MATKEY_TRANSMISSION_FACTOR, mat.Transparency);
+		const aiNode* node = entry.Node;
+		glm::mat4 transform = entry.ParentTransform * glm::transpose(*(glm::mat4*)(&node->mTransformation));
 
-			mat.Roughness = glm::pow(mat.Roughness, 1.0f / 4.0f);
+		for (unsigned int i = 0; i < node->mNumMeshes; i++)
+		{
+			MeshInstance instance;
+			instance.MeshIndex = firstMesh + node->mMeshes[i];
+			instance.Transform = transform;
+			instance.NodeName = node->mName.C_Str();
+			outInstances->push_back(std::move(instance));
+		}
 
-			for (int i = 0; i < (int)material->GetTextureCount(aiTextureType_DIFFUSE); i++)
-			{
-				aiString str;
-				material->GetTexture(aiTextureType_DIFFUSE, i, &str);
-				mat.AlbedoTexture = AssetManager::GetAsset(std::string("assets/") + std::string(str.C_Str()));
-			}
+		// Pushed in reverse so children are visited in their original order
+		for (unsigned int i = node->mNumChildren; i > 0; i--)
+		{
+			stack.push_back({ node->mChildren[i - 1], transform });
+		}
+	}
+}
 
-			for (int i = 0; i < (int)material->GetTextureCount(aiTextureType_NORMALS); i++)
-			{
-				aiString str;
-				material->GetTexture(aiTextureType_NORMALS, i, &str);
-				mat.NormalTexture = AssetManager::GetAsset(std::string("assets/") + std::string(str.C_Str()));
-			}
+bool VulkanHelper::AssetImporter::FindAssimpTexture(const aiScene* scene, const aiMaterial* material, aiTextureType type, std::string* outPath, int* outEmbeddedIndex)
+{
+	uint32_t textureCount = material->GetTextureCount(type);
+	if (textureCount == 0)
+		return false;
 
-			for (int i = 0; i < (int)material->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS); i++)
-			{
-				aiString str;
-				material->GetTexture(aiTextureType_DIFFUSE_ROUGHNESS, i, &str);
-				mat.RoughnessTexture = AssetManager::GetAsset(std::string("assets/") + std::string(str.C_Str()));
-			}
+	// Only the last texture of the type is used
+	aiString str;
+	material->GetTexture(type, textureCount - 1, &str);
 
-			for (int i = 0; i < (int)material->GetTextureCount(aiTextureType_METALNESS); i++)
-			{
-				aiString str;
-				material->GetTexture(aiTextureType_METALNESS, i, &str);
-				mat.MetallnessTexture = AssetManager::GetAsset(std::string("assets/") + std::string(str.C_Str()));
-			}
+	// Embedded textures are referenced as "*index" or by a name matching one of scene->mTextures
+	std::pair<const aiTexture*, int> embedded = scene->GetEmbeddedTextureAndIndex(str.C_Str());
+	*outEmbeddedIndex = embedded.first ? embedded.second : -1;
+	if (embedded.first == nullptr)
+		*outPath = std::string("assets/") + std::string(str.C_Str());
 
-			// Create Empty Texture if none are found
-			if (material->GetTextureCount(aiTextureType_DIFFUSE) == 0)
-			{
-				mat.AlbedoTexture = AssetManager::GetAsset("assets/white.png");
-			}
-			if (material->GetTextureCount(aiTextureType_NORMALS) == 0)
-			{
-				mat.NormalTexture = AssetManager::GetAsset("assets/empty_normal.png");
-			}
-			if (material->GetTextureCount(aiTextureType_METALNESS) == 0)
-			{
-				mat.MetallnessTexture = AssetManager::GetAsset("assets/white.png");
-			}
-			if (material->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS) == 0)
-			{
-				mat.RoughnessTexture = AssetManager::GetAsset("assets/white.png");
-			}
+	return true;
+}
 
-			mat.Color = glm::vec4(diffuseColor.r, diffuseColor.g, diffuseColor.b, 1.0f);
-			mat.EmissiveColor = glm::vec4(emissiveColor.r, emissiveColor.g, emissiveColor.b, emissiveColor.a);
-		}
+VulkanHelper::AssetHandle VulkanHelper::AssetImporter::LoadMaterialTexture(
+	const aiScene* scene,
+	const aiMaterial* material,
+	aiTextureType type,
+	TextureRole role,
+	AssetID modelID,
+	std::vector<EmbeddedTextureLoad>* outEmbeddedLoads
+)
+{
+	std::string path;
+	int embeddedIndex;
 
-		index++;
-	}
+	// Create Empty Texture if none are found
+	if (!FindAssimpTexture(scene, material, type, &path, &embeddedIndex))
+		return AssetManager::GetAsset(GetFallbackTexture(role), role);
+
+	if (embeddedIndex < 0)
+		return AssetManager::GetAsset(path, role);
+
+	EmbeddedTextureLoad load;
+	load.TextureIndex = (uint32_t)embeddedIndex;
+	load.Role = role;
 
-	// process each of the children nodes
-	for (unsigned int i = 0; i < node->mNumChildren; i++)
+	AssetHandle handle = AssetManager::FindOrCreateEmbeddedTexture(modelID, load.TextureIndex, role, &load.Promise);
+	if (load.Promise)
 	{
-		ProcessAssimpNode(device, node->mChildren[i], scene, filepath, outMeshes, outMeshNames, outMeshTransfrorms, outMaterials, index);
+		load.Asset = handle.GetAsset();
+		outEmbeddedLoads->push_back(std::move(load));
 	}
-}
\ No newline at end of file
+
+	return handle;
+}
+
+VulkanHelper::Material VulkanHelper::AssetImporter::ProcessAssimpMaterial(const aiScene* scene, const aiMaterial* material, AssetID modelID, std::vector<EmbeddedTextureLoad>* outEmbeddedLoads)
+{
+	Material mat;
+	ReadAssimpMaterialParameters(material, &mat);
+
+	mat.AlbedoTexture = LoadMaterialTexture(scene, material, aiTextureType_DIFFUSE, TextureRole::Color, modelID, outEmbeddedLoads);
+	mat.NormalTexture = LoadMaterialTexture(scene, material, aiTextureType_NORMALS, TextureRole::Normal, modelID, outEmbeddedLoads);
+	mat.RoughnessTexture = LoadMaterialTexture(scene, material, aiTextureType_DIFFUSE_ROUGHNESS, TextureRole::Roughness, modelID, outEmbeddedLoads);
+	mat.MetallnessTexture = LoadMaterialTexture(scene, material, aiTextureType_METALNESS, TextureRole::Metalness, modelID, outEmbeddedLoads);
+
+	return mat;
+}
+
+void VulkanHelper::AssetImporter::ReadAssimpMaterialParameters(const aiMaterial* material, Material* outMaterial)
+{
+	Material& mat = *outMaterial;
+
+	aiColor4D emissiveColor(0.0f, 0.0f, 0.0f, 0.0f);
+	aiColor4D diffuseColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	mat.MaterialName = material->GetName().C_Str();
+
+	material->Get(AI_MATKEY_COLOR_EMISSIVE, emissiveColor);
+	material->Get(AI_MATKEY_EMISSIVE_INTENSITY, emissiveColor.a);
+	material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuseColor);
+	material->Get(AI_MATKEY_ROUGHNESS_FACTOR, mat.Roughness);
+	material->Get(AI_MATKEY_METALLIC_FACTOR, mat.Metallic);
+	material->Get(AI_MATKEY_REFRACTI, mat.Ior);
+	material->Get(AI_MATKEY_TRANSMISSION_FACTOR, mat.Transparency);
+
+	mat.Roughness = glm::pow(mat.Roughness, 1.0f / 4.0f);
+
+	mat.Color = glm::vec4(diffuseColor.r, diffuseColor.g, diffuseColor.b, 1.0f);
+	mat.EmissiveColor = glm::vec4(emissiveColor.r, emissiveColor.g, emissiveColor.b, emissiveColor.a);
+}
+
+const char* VulkanHelper::AssetImporter::GetFallbackTexture(TextureRole role)
+{
+	return role == TextureRole::Normal ? "assets/empty_normal.png" : "assets/white.png";
+}
@@ -2,41 +2,136 @@
 #include "Pch.h"
 
 #include "Vulkan/Image.h"
+#include "Vulkan/UploadBatch.h"
 #include "Asset.h"
 
+#include <assimp/material.h>
+
 struct aiNode;
 struct aiScene;
+struct aiMaterial;
+struct aiTexture;
 
 namespace VulkanHelper
 {
 	class AssetManager;
 	class Device;
+	class UploadBatch;
 
 	class AssetImporter
 	{
 	public:
-		static Image ImportTexture(Device* device, std::string path, bool HDR);
+		// If batch is provided the upload is only recorded into it and happens when the batch is submitted
+		static Image ImportTexture(Device* device, std::string path, bool HDR, UploadBatch* batch = nullptr, TextureRole role = TextureRole::Color);
+		// Decodes an already loaded image file, name is only used for error messages
+		static Image ImportTexture(Device* device, const void* data, size_t size, const std::string& name, bool HDR, UploadBatch* batch = nullptr, TextureRole role = TextureRole::Color);
+
+		/**
+		 * @brief Uploads a KTX2 container as stored: every mip level, array layer and cube face in one copy, no mip generation.
+		 *
+		 * Supports uncompressed, BCn, ETC2 and ASTC formats with no or zlib supercompression. Compressed formats need the
+		 * matching device feature enabled. Unlike decoded images the data isn't flipped, so textures meant to be used with
+		 * the engine's flipped UVs have to be stored bottom up (toktx --lower_left_maps_to_s0t0).
+		 */
+		static Image ImportKTX2(Device* device, const void* data, size_t size, const std::string& name, UploadBatch* batch = nullptr);
+
+		// Path the texture file is actually read from
+		static std::string GetTextureFilePath(std::string path);
+
+		/**
+		 * @brief Loads an equirectangular HDR image and resamples it into a cube map.
+		 *
+		 * @param faceSize Resolution of a single cube face, 0 picks a quarter of the source width.
+		 */
+		static Image ImportEnvironmentMap(Device* device, std::string path, uint32_t faceSize, UploadBatch* batch = nullptr);
 		static void ImportModel(
 			Device* device,
 			std::string path,
 			std::vector<Mesh>* outMeshes,
 			std::vector<std::string>* outMeshNames,
 			std::vector<glm::mat4>* outMeshTransfrorms,
-			std::vector<Material>* outMaterials
+			std::vector<Material>* outMaterials,
+			std::vector<uint32_t>* outMeshMaterialIndices,
+			std::vector<MeshInstance>* outInstances
 		);
 
-	private:
-		static void ProcessAssimpNode(
+		// Always goes through Assimp, skipping cooked models and the native glTF importer. Lets the two be compared on the same file
+		static void ImportAssimpModel(
 			Device* device,
-			aiNode* node,
-			const aiScene* scene,
-			const std::string& filepath,
+			const std::string& path,
 			std::vector<Mesh>* outMeshes,
 			std::vector<std::string>* outMeshNames,
 			std::vector<glm::mat4>* outMeshTransfrorms,
 			std::vector<Material>* outMaterials,
-			int& index
+			std::vector<uint32_t>* outMeshMaterialIndices,
+			std::vector<MeshInstance>* outInstances
 		);
+
+		// Model written by the offline cooker, see CookedModel. False if the data isn't a valid cooked model
+		static bool ImportCookedModel(
+			Device* device,
+			const void* data,
+			size_t size,
+			const std::string& path,
+			std::vector<Mesh>* outMeshes,
+			std::vector<std::string>* outMeshNames,
+			std::vector<glm::mat4>* outMeshTransfrorms,
+			std::vector<Material>* outMaterials,
+			std::vector<uint32_t>* outMeshMaterialIndices,
+			std::vector<MeshInstance>* outInstances
+		);
+
+		// Texture used by materials that don't reference one for the role
+		static const char* GetFallbackTexture(TextureRole role);
+
+	private:
+		friend class AssetCooker;
+
+		struct TextureLayout
+		{
+			VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+			int Channels = 4; // Channels stored in the image
+			int DecodeChannels = 4; // Channels requested from stb_image
+			int SourceChannel = -1; // If set, only this channel of the decoded pixels is kept
+		};
+
+		static TextureLayout ChooseTextureLayout(TextureRole role, int sourceChannels);
+
+		// outPixels has to hold pixelCount * GetHDRPixelSize(format) bytes
+		static void ConvertHDRPixels(const float* pixels, uint64_t pixelCount, VkFormat format, void* outPixels);
+		static uint32_t GetHDRPixelSize(VkFormat format);
+		static glm::vec3 CubeFaceDirection(uint32_t face, glm::vec2 uv);
+		static glm::vec4 SampleBilinear(const float* pixels, int width, int height, glm::vec2 uv);
+
+		// Post processing every Assimp import runs, the cooker has to match it
+		static uint32_t GetAssimpImportFlags();
+		static void GatherAssimpInstances(const aiScene* scene, uint32_t firstMesh, std::vector<MeshInstance>* outInstances);
+		// Embedded texture whose asset was created by this import and still has to be decoded
+		struct EmbeddedTextureLoad
+		{
+			uint32_t TextureIndex = 0;
+			TextureRole Role = TextureRole::Color;
+			std::shared_ptr<Asset> KeepAlive; // Holds the image until the upload is submitted
+			std::weak_ptr<Asset> Asset;
+			std::shared_ptr<std::promise<void>> Promise;
+		};
+
+		static Material ProcessAssimpMaterial(const aiScene* scene, const aiMaterial* material, AssetID modelID, std::vector<EmbeddedTextureLoad>* outEmbeddedLoads);
+		// Everything except the textures
+		static void ReadAssimpMaterialParameters(const aiMaterial* material, Material* outMaterial);
+		// False if the material has no texture of the type. Otherwise outEmbeddedIndex is the scene texture index, or -1 and outPath is set
+		static bool FindAssimpTexture(const aiScene* scene, const aiMaterial* material, aiTextureType type, std::string* outPath, int* outEmbeddedIndex);
+		static AssetHandle LoadMaterialTexture(
+			const aiScene* scene,
+			const aiMaterial* material,
+			aiTextureType type,
+			TextureRole role,
+			AssetID modelID,
+			std::vector<EmbeddedTextureLoad>* outEmbeddedLoads
+		);
+
+		static Image ImportEmbeddedTexture(Device* device, const aiTexture* texture, const std::string& name, UploadBatch* batch, TextureRole role);
+		static Image CreateTextureImage(Device* device, int width, int height, VkFormat format, UploadBatch* batch, const UploadBatch::StagingAllocation& staging);
 	};
 
 }
\ No newline at end of file
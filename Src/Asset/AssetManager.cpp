@@ -4,103 +4,717 @@
 #include "Asset.h"
 
 #include "Logger/Logger.h"
+#include "Utility/Hash.h"
 
 #include "Vulkan/Device.h"
+#include "Vulkan/UploadBatch.h"
 #include "AssetImporter.h"
+#include "AssetProfiler.h"
+#include "Package.h"
+#include "CookManifest.h"
+#include "AssetPrefetcher.h"
 
-void VulkanHelper::AssetManager::Init(Device* device)
+void VulkanHelper::AssetManager::Init(Device* device, uint32_t threadCount /*= 0*/)
 {
 	s_Device = device;
 
-	s_ThreadPool.Init({ device, 1 });
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	s_ThreadPool.Init({ device, threadCount });
+	s_FileReader.Init({});
+}
+
+std::string VulkanHelper::AssetManager::CanonicalizePath(const std::string& path)
+{
+	std::string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+
+	return std::filesystem::path(normalized).lexically_normal().generic_string();
+}
+
+void VulkanHelper::AssetHandle::WaitToLoad()
+{
+	if (!Future.valid())
+		return;
+
+	// Model imports wait on their textures from a worker while those textures can still be queued behind other models
+	AssetManager::GetThreadPool().WaitFor(Future);
+}
+
+VulkanHelper::AssetID VulkanHelper::AssetManager::GetAssetID(const std::string& path)
+{
+	return Hash::XXH64(CanonicalizePath(path));
+}
+
+VulkanHelper::AssetID VulkanHelper::AssetManager::GetTextureID(const std::string& path, TextureRole role)
+{
+	AssetID id = GetAssetID(path);
+	if (role == TextureRole::Color)
+		return id;
+
+	return Hash::Combine(id, Hash::XXH64("TextureRole") + (uint64_t)role);
+}
+
+VulkanHelper::AssetID VulkanHelper::AssetManager::GetEnvironmentMapID(const std::string& path, uint32_t faceSize)
+{
+	// Same file loaded as a 2D texture is a different asset
+	return Hash::Combine(GetAssetID(path), Hash::XXH64("EnvironmentMap") + faceSize);
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::GetAsset(const std::string& path, TextureRole role /*= TextureRole::Color*/)
+{
+	AssetHandle handle = RequestAsset(path, role);
+	AssetPrefetcher::OnRequest(handle.ID, path, GetAssetType(path) == AssetType::Texture ? role : TextureRole::Color, false, 0);
+
+	return handle;
+}
+
+std::vector<VulkanHelper::AssetHandle> VulkanHelper::AssetManager::GetAssets(std::span<const std::string> paths, TextureRole role /*= TextureRole::Color*/)
+{
+	std::vector<AssetHandle> handles = RequestAssets(paths, role);
+	for (size_t i = 0; i < paths.size(); i++)
+		AssetPrefetcher::OnRequest(handles[i].ID, paths[i], GetAssetType(paths[i]) == AssetType::Texture ? role : TextureRole::Color, false, 0);
+
+	return handles;
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::GetEnvironmentMap(const std::string& path, uint32_t faceSize /*= 0*/)
+{
+	AssetHandle handle = RequestEnvironmentMap(path, faceSize);
+	AssetPrefetcher::OnRequest(handle.ID, path, TextureRole::Color, true, faceSize);
+
+	return handle;
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::RequestAsset(const std::string& path, TextureRole role)
+{
+	AssetType type = GetAssetType(path);
+	if (type != AssetType::Texture)
+		role = TextureRole::Color;
+
+	AssetID id = GetTextureID(path, role);
+
+	std::shared_ptr<std::promise<void>> promise;
+	uint64_t fileSize = 0;
+
+	// Only the shard owning this ID is locked, requests for other assets don't wait on each other
+	AssetHandle handle;
+	if (type == AssetType::Texture && s_ContentDeduplication)
+	{
+		if (s_Assets.Access(id, [&](AssetMap& assets) { return FindAsset(assets, id, &handle); }))
+			return handle;
+
+		handle = FindOrCreateTextureByContent(path, id, role, &promise, &fileSize);
+	}
+	else
+	{
+		handle = s_Assets.Access(id, [&](AssetMap& assets) { return FindOrCreateAsset(assets, id, type, &promise); });
+	}
+
+	if (!promise) // Cache hit
+		return handle;
+
+	// The task only holds a weak reference, so the asset can still be freed if the user drops every handle during loading
+	LoadRequest request{ path, type, fileSize, 0, role, handle.Asset, promise };
+
+	if (type == AssetType::Texture)
+		LoadTexture(request);
+	else
+		LoadModel(request);
+
+	return handle;
+}
+
+std::vector<VulkanHelper::AssetHandle> VulkanHelper::AssetManager::RequestAssets(std::span<const std::string> paths, TextureRole role)
+{
+	std::vector<AssetHandle> handles(paths.size());
+	std::vector<AssetID> ids(paths.size());
+	std::vector<AssetType> types(paths.size());
+	std::vector<TextureRole> roles(paths.size());
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		types[i] = GetAssetType(paths[i]);
+		roles[i] = types[i] == AssetType::Texture ? role : TextureRole::Color;
+		ids[i] = GetTextureID(paths[i], roles[i]);
+	}
+
+	bool deduplicate = s_ContentDeduplication;
+	std::vector<LoadRequest> misses;
+	std::vector<uint32_t> contentLookups;
+	s_Assets.AccessMany(ids, [&](uint32_t index, AssetMap& assets)
+		{
+			// Textures missing by path are looked up by content afterwards, file reads shouldn't happen under the shard lock
+			if (deduplicate && types[index] == AssetType::Texture)
+			{
+				if (!FindAsset(assets, ids[index], &handles[index]))
+					contentLookups.push_back(index);
+
+				return;
+			}
+
+			std::shared_ptr<std::promise<void>> promise;
+			handles[index] = FindOrCreateAsset(assets, ids[index], types[index], &promise);
+
+			if (promise)
+				misses.push_back({ paths[index], types[index], 0, 0, roles[index], handles[index].Asset, promise });
+		});
+
+	for (LoadRequest& request : misses)
+		request.FileSize = GetFileSize(request.Path);
+
+	for (uint32_t index : contentLookups)
+	{
+		std::shared_ptr<std::promise<void>> promise;
+		uint64_t fileSize = 0;
+		handles[index] = FindOrCreateTextureByContent(paths[index], ids[index], roles[index], &promise, &fileSize);
+
+		if (promise)
+			misses.push_back({ paths[index], types[index], fileSize, 0, roles[index], handles[index].Asset, promise });
+	}
+
+	if (misses.empty())
+		return handles;
+
+	// Models go first since they spawn texture loads of their own, then everything largest first so the
+	// long loads don't end up at the tail of the queue
+	std::sort(misses.begin(), misses.end(), [](const LoadRequest& a, const LoadRequest& b)
+		{
+			if (a.Type != b.Type)
+				return a.Type == AssetType::Model;
+
+			return a.FileSize > b.FileSize;
+		});
+
+	std::vector<LoadRequest> textureGroup;
+	for (LoadRequest& request : misses)
+	{
+		if (request.Type == AssetType::Model)
+		{
+			LoadModel(request);
+			continue;
+		}
+
+		textureGroup.push_back(std::move(request));
+		if (textureGroup.size() == s_UploadGroupSize)
+		{
+			LoadTextureGroup(std::move(textureGroup));
+			textureGroup.clear();
+		}
+	}
+
+	if (!textureGroup.empty())
+		LoadTextureGroup(std::move(textureGroup));
+
+	return handles;
 }
 
-VulkanHelper::AssetHandle VulkanHelper::AssetManager::GetAsset(const std::string& path)
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::RequestEnvironmentMap(const std::string& path, uint32_t faceSize)
 {
-	std::hash<std::string> hash;
-	uint64_t hashValue = hash(path);
+	VH_ASSERT(IsHDRTexture(path), "Environment maps have to be .hdr files! Path: {}", path);
+
+	AssetID id = GetEnvironmentMapID(path, faceSize);
+
+	std::shared_ptr<std::promise<void>> promise;
+	AssetHandle handle = s_Assets.Access(id, [&](AssetMap& assets) { return FindOrCreateAsset(assets, id, AssetType::EnvironmentMap, &promise); });
+
+	if (!promise) // Cache hit
+		return handle;
+
+	LoadRequest request{ path, AssetType::EnvironmentMap, 0, faceSize, TextureRole::Color, handle.Asset, promise };
+	LoadEnvironmentMap(request);
 
+	return handle;
+}
+
+void VulkanHelper::AssetManager::SetHDRFormat(VkFormat format)
+{
+	VH_ASSERT(format == VK_FORMAT_R16G16B16A16_SFLOAT || format == VK_FORMAT_B10G11R11_UFLOAT_PACK32, "Unsupported HDR format! Format: {}", (int)format);
+
+	s_HDRFormat = format;
+}
+
+std::string VulkanHelper::AssetManager::GetExtension(const std::string& path)
+{
 	size_t dotPos = path.find_last_of('.');
 	VH_ASSERT(dotPos != std::string::npos, "Failed to get file extension! Path: {}", path);
 	std::string extension = path.substr(dotPos, path.size() - dotPos);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
 
-	s_AssetsMutex.lock();
-	auto iter = s_Assets.find(hashValue);
-	if (iter != s_Assets.end())
+	return extension;
+}
+
+bool VulkanHelper::AssetManager::IsHDRTexture(const std::string& path)
+{
+	return GetExtension(path) == ".hdr";
+}
+
+VulkanHelper::AssetManager::AssetType VulkanHelper::AssetManager::GetAssetType(const std::string& path)
+{
+	std::string extension = GetExtension(path);
+
+	if (extension == ".png" || extension == ".jpg" || extension == ".hdr" || extension == ".ktx2")
+		return AssetType::Texture;
+	else if (extension == ".gltf" || extension == ".glb" || extension == ".obj" || extension == ".vhmodel")
+		return AssetType::Model;
+
+	VH_ASSERT(false, "Unsupported file extension! Path: {}", path);
+	return AssetType::Texture;
+}
+
+bool VulkanHelper::AssetManager::LoadCookManifest(const std::string& path)
+{
+	AssetFile file;
+	if (!OpenFile(path, &file))
+	{
+		VH_ERROR("Failed to open cook manifest {}", path);
+		return false;
+	}
+
+	CookManifest manifest;
+	std::string error;
+	if (!CookManifest::Parse((const char*)file.Data, file.Size, &manifest, &error))
+	{
+		VH_ERROR("Invalid cook manifest {}: {}", path, error);
+		return false;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(s_CookedPathsMutex);
+	for (const CookManifest::Entry& entry : manifest.Entries)
+		s_CookedPaths[CookManifest::GetRequestID(entry)] = entry.Cooked;
+
+	VH_INFO("Loaded cook manifest {} with {} entries", path, manifest.Entries.size());
+	return true;
+}
+
+std::string VulkanHelper::AssetManager::GetCookedPath(AssetID id)
+{
+	std::shared_lock<std::shared_mutex> lock(s_CookedPathsMutex);
+	auto iter = s_CookedPaths.find(id);
+	return iter != s_CookedPaths.end() ? iter->second : std::string();
+}
+
+bool VulkanHelper::AssetManager::MountPackage(const std::string& path)
+{
+	std::shared_ptr<Package> package = std::make_shared<Package>();
+	if (!package->Open(path))
+	{
+		VH_ERROR("Failed to mount package {}", path);
+		return false;
+	}
+
+	VH_INFO("Mounted package {} with {} files", path, package->GetEntryCount());
+
+	std::unique_lock<std::shared_mutex> lock(s_PackagesMutex);
+	s_Packages.push_back(std::move(package));
+
+	return true;
+}
+
+void VulkanHelper::AssetManager::UnmountPackages()
+{
+	// Files opened from a package keep it mapped until they are closed
+	std::unique_lock<std::shared_mutex> lock(s_PackagesMutex);
+	s_Packages.clear();
+}
+
+std::shared_ptr<const VulkanHelper::Package> VulkanHelper::AssetManager::FindPackage(AssetID id)
+{
+	std::shared_lock<std::shared_mutex> lock(s_PackagesMutex);
+	for (size_t i = s_Packages.size(); i > 0; i--)
+	{
+		if (s_Packages[i - 1]->Find(id))
+			return s_Packages[i - 1];
+	}
+
+	return nullptr;
+}
+
+bool VulkanHelper::AssetManager::OpenPackagedFile(const std::string& path, AssetFile* outFile, const std::string& profileName)
+{
+	AssetID id = GetAssetID(path);
+
+	std::shared_ptr<const Package> package = FindPackage(id);
+	if (!package)
+		return false;
+
+	const Package::Entry* entry = package->Find(id);
+
+	outFile->SourcePackage = package;
+	if (entry->Flags & Package::EntryFlagCompressed)
+	{
+		AssetProfiler::ScopedTimer timer(profileName, AssetStage::Decompress, entry->StoredSize);
+
+		outFile->Owned.resize(entry->Size);
+		if (!package->Read(*entry, outFile->Owned.data()))
+		{
+			VH_ERROR("Corrupted package entry {:x} in {}", id, package->GetPath());
+			return false;
+		}
+
+		outFile->Data = outFile->Owned.data();
+	}
+	else
+	{
+		outFile->Data = package->GetStoredData(*entry);
+	}
+
+	outFile->Size = entry->Size;
+	return true;
+}
+
+bool VulkanHelper::AssetManager::OpenFile(const std::string& path, AssetFile* outFile)
+{
+	if (OpenPackagedFile(path, outFile, path))
+		return true;
+
+	if (!outFile->Mapping.Open(path))
+		return false;
+
+	outFile->Data = outFile->Mapping.GetData();
+	outFile->Size = outFile->Mapping.GetSize();
+	return true;
+}
+
+bool VulkanHelper::AssetManager::FileExists(const std::string& path)
+{
+	AssetID id = GetAssetID(path);
+	{
+		std::shared_lock<std::shared_mutex> lock(s_PackagesMutex);
+		for (const std::shared_ptr<const Package>& package : s_Packages)
+		{
+			if (package->Find(id))
+				return true;
+		}
+	}
+
+	std::error_code error;
+	return std::filesystem::is_regular_file(path, error);
+}
+
+uint64_t VulkanHelper::AssetManager::GetFileSize(const std::string& path)
+{
+	AssetID id = GetAssetID(path);
+	{
+		std::shared_lock<std::shared_mutex> lock(s_PackagesMutex);
+		for (size_t i = s_Packages.size(); i > 0; i--)
+		{
+			if (const Package::Entry* entry = s_Packages[i - 1]->Find(id))
+				return entry->Size;
+		}
+	}
+
+	std::error_code error;
+	uint64_t size = (uint64_t)std::filesystem::file_size(path, error);
+	return error ? 0 : size;
+}
+
+void VulkanHelper::AssetManager::ReadFileAsync(const std::string& path, const std::string& profileName, FileCallback callback)
+{
+	AssetID id = GetAssetID(path);
+
+	bool packaged = false;
+	{
+		std::shared_lock<std::shared_mutex> lock(s_PackagesMutex);
+		for (const std::shared_ptr<const Package>& package : s_Packages)
+			packaged |= package->Find(id) != nullptr;
+	}
+
+	// Packaged entries are already mapped, only decompression is left which the worker does itself
+	if (packaged)
+	{
+		s_ThreadPool.PushTask([](std::string path, std::string profileName, FileCallback callback)
+			{
+				std::shared_ptr<AssetFile> file = std::make_shared<AssetFile>();
+				if (!OpenPackagedFile(path, file.get(), profileName))
+					file = nullptr;
+
+				callback(std::move(file));
+			}, path, profileName, std::move(callback));
+		return;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	s_FileReader.Read(path, [profileName, start, callback](bool success, std::vector<uint8_t>& data)
+		{
+			if (AssetProfiler::IsEnabled())
+				AssetProfiler::Record(profileName, AssetStage::FileRead, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), data.size());
+
+			// The reader already logged the failure, a partial buffer would only decode into garbage
+			std::shared_ptr<AssetFile> file;
+			if (success)
+			{
+				file = std::make_shared<AssetFile>();
+				file->Owned = std::move(data);
+				file->Data = file->Owned.data();
+				file->Size = file->Owned.size();
+			}
+
+			s_ThreadPool.PushTask([](FileCallback callback, std::shared_ptr<AssetFile> file) { callback(std::move(file)); }, callback, file);
+		});
+}
+
+VulkanHelper::AssetManager::Statistics VulkanHelper::AssetManager::GetStatistics()
+{
+	Statistics statistics;
+	statistics.TexturesLoaded = s_TexturesLoaded;
+	statistics.ModelsLoaded = s_ModelsLoaded;
+	statistics.DeduplicatedTextures = s_DeduplicatedTextures;
+	statistics.DeduplicatedBytes = s_DeduplicatedBytes;
+
+	return statistics;
+}
+
+void VulkanHelper::AssetManager::ResetStatistics()
+{
+	s_TexturesLoaded = 0;
+	s_ModelsLoaded = 0;
+	s_DeduplicatedTextures = 0;
+	s_DeduplicatedBytes = 0;
+}
+
+bool VulkanHelper::AssetManager::FindAsset(AssetMap& assets, AssetID id, AssetHandle* outHandle)
+{
+	auto iter = assets.find(id);
+	if (iter == assets.end())
+		return false;
+
+	std::shared_ptr<Asset> asset = iter->second.Asset.lock();
+	if (!asset)
+		return false;
+
+	outHandle->ID = id;
+	outHandle->Asset = std::move(asset);
+	outHandle->Future = iter->second.Future;
+	return true;
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::FindOrCreateEmbeddedTexture(AssetID modelID, uint32_t textureIndex, TextureRole role, std::shared_ptr<std::promise<void>>* outPromise)
+{
+	AssetID id = Hash::Combine(Hash::Combine(modelID, Hash::XXH64("EmbeddedTexture") + textureIndex), (uint64_t)role);
+
+	// Counted by the importer once the texture is decoded
+	return s_Assets.Access(id, [&](AssetMap& assets) { return FindOrCreateAsset(assets, id, AssetType::Texture, outPromise); });
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::FindOrCreateTextureByContent(const std::string& path, AssetID pathID, TextureRole role, std::shared_ptr<std::promise<void>>* outPromise, uint64_t* outFileSize)
+{
+	uint64_t contentHash = 0;
+
+	// Compressed entries are hashed as stored, decompressing them here would only be repeated by the load.
+	// LZ4 output is deterministic, so equal files still share a hash unless one of them is stored uncompressed
+	AssetID fileID = GetAssetID(path);
+	std::shared_ptr<const Package> package = FindPackage(fileID);
+	const Package::Entry* entry = package ? package->Find(fileID) : nullptr;
+	if (entry != nullptr && (entry->Flags & Package::EntryFlagCompressed))
+	{
+		*outFileSize = entry->Size;
+		contentHash = Hash::Combine(Hash::XXH64(package->GetStoredData(*entry), entry->StoredSize), entry->Size);
+	}
+	else
+	{
+		AssetFile file;
+		if (!OpenFile(path, &file))
+		{
+			// Let the importer report the missing file
+			return s_Assets.Access(pathID, [&](AssetMap& assets) { return FindOrCreateAsset(assets, pathID, AssetType::Texture, outPromise); });
+		}
+
+		*outFileSize = file.Size;
+		contentHash = Hash::XXH64(file.Data, file.Size);
+	}
+
+	// The same bytes decode differently as HDR or with another role, so those get their own ID
+	AssetID contentID = Hash::Combine(contentHash, (IsHDRTexture(path) ? 1 : 0) | ((uint64_t)role << 1));
+
+	AssetHandle handle = s_ContentAssets.Access(contentID, [&](AssetMap& assets) { return FindOrCreateAsset(assets, contentID, AssetType::Texture, outPromise); });
+	handle.ID = pathID;
+
+	s_Assets.Access(pathID, [&](AssetMap& assets) { assets[pathID] = { handle.Future, handle.Asset }; });
+
+	if (!*outPromise)
+	{
+		VH_TRACE("Texture {} has the same content as an already loaded one, reusing it", path);
+		s_DeduplicatedTextures++;
+		s_DeduplicatedBytes += *outFileSize;
+	}
+
+	return handle;
+}
+
+VulkanHelper::AssetHandle VulkanHelper::AssetManager::FindOrCreateAsset(AssetMap& assets, AssetID id, AssetType type, std::shared_ptr<std::promise<void>>* outPromise)
+{
+	AssetHandle handle;
+	handle.ID = id;
+
+	auto iter = assets.find(id);
+	if (iter != assets.end())
 	{
 		// Asset with this path is already loaded
-		if (!iter->second.Asset.expired())
+		handle.Asset = iter->second.Asset.lock();
+		if (handle.Asset)
 		{
-			AssetHandle handle;
 			handle.Future = iter->second.Future;
-			handle.Asset = iter->second.Asset.lock();
-			s_AssetsMutex.unlock();
 			return handle;
 		}
 	}
 
-	std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
-	
-	AssetHandle handle;
-	handle.Future = promise->get_future();
-	if (extension == ".png" || extension == ".jpg")
-		handle.Asset = std::make_shared<TextureAsset>();
-	else if (extension == ".gltf" || extension == ".glb" || extension == ".obj")
+	*outPromise = std::make_shared<std::promise<void>>();
+	handle.Future = (*outPromise)->get_future();
+	if (type == AssetType::Model)
 		handle.Asset = std::make_shared<ModelAsset>();
 	else
-	{
-		VH_ASSERT(false, "Unsupported file extension! Path: {}", path);
-	}
+		handle.Asset = std::make_shared<TextureAsset>();
 
-	s_Assets[hashValue] = { handle.Future, handle.Asset };
-	s_AssetsMutex.unlock();
+	assets[id] = { handle.Future, handle.Asset };
+	return handle;
+}
 
-	if (extension == ".png" || extension == ".jpg")
-	{
-		s_ThreadPool.PushTask([](std::string path, std::shared_ptr<std::promise<void>> promise)
+std::string VulkanHelper::AssetManager::GetTextureReadPath(const LoadRequest& request)
+{
+	std::string cookedPath = GetCookedPath(GetTextureID(request.Path, request.Role));
+	if (!cookedPath.empty())
+		return cookedPath;
+
+	return AssetImporter::GetTextureFilePath(request.Path);
+}
+
+void VulkanHelper::AssetManager::LoadTexture(const LoadRequest& request)
+{
+	// Workers only get the task once there is something to decode
+	ReadFileAsync(GetTextureReadPath(request), request.Path, [request](std::shared_ptr<AssetFile> file)
+		{
+			VH_TRACE("Loading Texture: {}", request.Path);
+
+			std::shared_ptr<Asset> asset = request.Asset.lock();
+			if (!asset) // User deleted the handle during loading
 			{
-				VH_TRACE("Loading Texture: {}", path);
+				request.Promise->set_value();
+				return;
+			}
 
-				std::hash<std::string> hash;
-				uint64_t hashValue = hash(path);
+			if (!file)
+			{
+				// Resolves with an empty image, same as any other failed import
+				VH_ERROR("Failed to read texture {}", request.Path);
+				request.Promise->set_value();
+				return;
+			}
 
-				s_AssetsMutex.lock();
-				if (s_Assets[hashValue].Asset.expired()) // User deleted the handle during loading
-				{
-					promise->set_value();
-					s_AssetsMutex.unlock();
-					return;
-				}
-				s_AssetsMutex.unlock();
+			TextureAsset* textureAsset = (TextureAsset*)asset.get();
+			textureAsset->Image = std::move(AssetImporter::ImportTexture(s_Device, file->Data, file->Size, request.Path, IsHDRTexture(request.Path), nullptr, request.Role));
+			s_TexturesLoaded++;
 
-				TextureAsset* textureAsset = (TextureAsset*)s_Assets[hashValue].Asset.lock().get();
-				textureAsset->Image = std::move(AssetImporter::ImportTexture(s_Device, path, false));
+			request.Promise->set_value();
+		});
+}
 
-				promise->set_value();
-			}, path, promise);
-	}
-	else if (extension == ".gltf" || extension == ".glb" || extension == ".obj")
+void VulkanHelper::AssetManager::LoadTextureGroup(std::vector<LoadRequest> requests)
+{
+	struct Group
 	{
-		s_ThreadPool.PushTask([](std::string path, std::shared_ptr<std::promise<void>> promise)
+		std::vector<LoadRequest> Requests;
+		std::vector<std::shared_ptr<Asset>> Assets; // Keeps the images alive until the batch is submitted
+		std::atomic<uint32_t> Remaining;
+		std::once_flag BatchInitFlag;
+		UploadBatch Batch;
+	};
+
+	std::shared_ptr<Group> group = std::make_shared<Group>();
+	group->Requests = std::move(requests);
+	group->Assets.resize(group->Requests.size());
+	group->Remaining = (uint32_t)group->Requests.size();
+
+	auto decode = [](std::shared_ptr<Group> group, uint32_t index, std::shared_ptr<AssetFile> file)
+		{
+			// Worker threads have command pools created, so the batch is initialized on one of them
+			std::call_once(group->BatchInitFlag, [&group]() { group->Batch.Init({ s_Device }); });
+
+			LoadRequest& request = group->Requests[index];
+			std::shared_ptr<Asset> asset = request.Asset.lock();
+			if (asset && !file)
+			{
+				// Resolves with an empty image like the rest of the group once it's submitted
+				VH_ERROR("Failed to read texture {}", request.Path);
+			}
+			else if (asset) // Otherwise user deleted the handle during loading
+			{
+				VH_TRACE("Loading Texture: {}", request.Path);
+
+				TextureAsset* textureAsset = (TextureAsset*)asset.get();
+				textureAsset->Image = std::move(AssetImporter::ImportTexture(s_Device, file->Data, file->Size, request.Path, IsHDRTexture(request.Path), &group->Batch, request.Role));
+				s_TexturesLoaded++;
+				group->Assets[index] = std::move(asset);
+			}
+
+			// Last texture in the group submits the uploads for everyone
+			if (group->Remaining.fetch_sub(1) == 1)
 			{
-				VH_TRACE("Loading Model: {}", path);
-				std::hash<std::string> hash;
-				uint64_t hashValue = hash(path);
+				std::chrono::steady_clock::time_point submitStart = std::chrono::steady_clock::now();
+				group->Batch.Submit();
 
-				s_AssetsMutex.lock();
-				if (s_Assets[hashValue].Asset.expired()) // User deleted the handle during loading
+				// Shared submission, every texture of the group gets an even share
+				if (AssetProfiler::IsEnabled())
 				{
-					promise->set_value();
-					s_AssetsMutex.unlock();
-					return;
+					uint64_t nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - submitStart).count();
+					for (LoadRequest& groupRequest : group->Requests)
+						AssetProfiler::Record(groupRequest.Path, AssetStage::UploadWait, nanoseconds / group->Requests.size());
 				}
-				s_AssetsMutex.unlock();
 
-				ModelAsset* modelAsset = (ModelAsset*)s_Assets[hashValue].Asset.lock().get();
-				AssetImporter::ImportModel(s_Device, path, &modelAsset->Meshes, &modelAsset->MeshNames, &modelAsset->MeshTransfrorms, &modelAsset->Materials);
-				promise->set_value();
-			}, path, promise);
+				group->Assets.clear();
+
+				for (LoadRequest& groupRequest : group->Requests)
+					groupRequest.Promise->set_value();
+			}
+		};
+
+	// All reads of the group are in flight at once, each texture is decoded as soon as its bytes arrive
+	for (uint32_t i = 0; i < (uint32_t)group->Requests.size(); i++)
+	{
+		ReadFileAsync(GetTextureReadPath(group->Requests[i]), group->Requests[i].Path, [group, i, decode](std::shared_ptr<AssetFile> file)
+			{
+				decode(group, i, std::move(file));
+			});
 	}
+}
 
-	return handle;
+void VulkanHelper::AssetManager::LoadModel(const LoadRequest& request)
+{
+	s_ThreadPool.PushTask([](LoadRequest request)
+		{
+			VH_TRACE("Loading Model: {}", request.Path);
+
+			std::shared_ptr<Asset> asset = request.Asset.lock();
+			if (!asset) // User deleted the handle during loading
+			{
+				request.Promise->set_value();
+				return;
+			}
+
+			ModelAsset* modelAsset = (ModelAsset*)asset.get();
+			AssetImporter::ImportModel(s_Device, request.Path, &modelAsset->Meshes, &modelAsset->MeshNames, &modelAsset->MeshTransfrorms, &modelAsset->Materials, &modelAsset->MeshMaterialIndices, &modelAsset->Instances);
+			s_ModelsLoaded++;
+			request.Promise->set_value();
+		}, request);
+}
+
+void VulkanHelper::AssetManager::LoadEnvironmentMap(const LoadRequest& request)
+{
+	s_ThreadPool.PushTask([](LoadRequest request)
+		{
+			VH_TRACE("Loading Environment Map: {}", request.Path);
+
+			std::shared_ptr<Asset> asset = request.Asset.lock();
+			if (!asset) // User deleted the handle during loading
+			{
+				request.Promise->set_value();
+				return;
+			}
+
+			TextureAsset* textureAsset = (TextureAsset*)asset.get();
+			textureAsset->Image = std::move(AssetImporter::ImportEnvironmentMap(s_Device, request.Path, request.FaceSize));
+			s_TexturesLoaded++;
+
+			request.Promise->set_value();
+		}, request);
 }
@@ -1,21 +1,45 @@
 #pragma once
 #include "Pch.h"
 #include "Utility/ThreadPool.h"
+#include "Utility/ShardedMap.h"
+#include "Utility/AsyncFileReader.h"
+
+#include "vulkan/vulkan_core.h"
+
+#include <shared_mutex>
 
 namespace VulkanHelper
 {
 	class Device;
 	class Asset;
 	class AssetManager;
+	class Package;
+	struct AssetFile;
+
+	// Stable 64-bit asset identifier, see AssetManager::GetAssetID()
+	using AssetID = uint64_t;
+
+	// What a texture is used for, decides how many channels are kept and which source channel they come from
+	enum class TextureRole : uint32_t
+	{
+		Color,		// RGBA8, default
+		Normal,		// RGBA8
+		Roughness,	// R8, taken from G for multi channel sources (glTF metallicRoughness)
+		Metalness,	// R8, taken from B for multi channel sources (glTF metallicRoughness)
+		Generic,	// Keeps the source channel count, R8, R8G8 or RGBA8
+	};
 
 	class AssetHandle
 	{
 	public:
-		inline void WaitToLoad() { Future.wait(); }
-		inline [[nodiscard]] std::shared_ptr<Asset> GetAsset() { return Asset; }
+		// Safe on asset worker threads too, they keep running queued loads until this one is done
+		void WaitToLoad();
+		[[nodiscard]] inline std::shared_ptr<Asset> GetAsset() { return Asset; }
+		[[nodiscard]] inline AssetID GetID() const { return ID; }
 	private:
 		std::shared_future<void> Future;
 		std::shared_ptr<Asset> Asset;
+		AssetID ID = 0;
 		friend class AssetManager;
 	};
 
@@ -24,12 +48,101 @@ namespace VulkanHelper
 	public:
 		AssetManager() = default;
 		~AssetManager() = default;
-		static void Init(Device* Device);
+		// threadCount of 0 uses every hardware thread except the calling one
+		static void Init(Device* Device, uint32_t threadCount = 0);
+
+		// Role is ignored for everything that isn't a texture. Same file with different roles are different assets
+		static AssetHandle GetAsset(const std::string& path, TextureRole role = TextureRole::Color);
+
+		/**
+		 * @brief Requests many assets at once.
+		 *
+		 * Cache hits are resolved with a single lock per touched shard, misses are scheduled largest first and
+		 * texture uploads are grouped into shared submissions. Handles are returned in the order of paths.
+		 */
+		static std::vector<AssetHandle> GetAssets(std::span<const std::string> paths, TextureRole role = TextureRole::Color);
+
+		/**
+		 * @brief Loads an equirectangular .hdr image as a cube map TextureAsset.
+		 *
+		 * @param faceSize Resolution of a single cube face, 0 picks a quarter of the source width.
+		 */
+		static AssetHandle GetEnvironmentMap(const std::string& path, uint32_t faceSize = 0);
+
+		/**
+		 * @brief Format used for .hdr textures, either VK_FORMAT_R16G16B16A16_SFLOAT (default) or VK_FORMAT_B10G11R11_UFLOAT_PACK32.
+		 */
+		static void SetHDRFormat(VkFormat format);
+		[[nodiscard]] inline static VkFormat GetHDRFormat() { return s_HDRFormat; }
 
-		static AssetHandle GetAsset(const std::string& path);
+		/**
+		 * @brief Canonicalizes the path (separators, "./", "../") and hashes it with XXH64.
+		 *
+		 * The same file always maps to the same ID regardless of how the path was spelled, and IDs are stable
+		 * across runs and platforms so they can be stored in cooked files.
+		 */
+		[[nodiscard]] static AssetID GetAssetID(const std::string& path);
+		// Color textures use the plain path ID
+		[[nodiscard]] static AssetID GetTextureID(const std::string& path, TextureRole role);
+		[[nodiscard]] static AssetID GetEnvironmentMapID(const std::string& path, uint32_t faceSize);
+		[[nodiscard]] static std::string CanonicalizePath(const std::string& path);
+
+		/**
+		 * @brief When enabled texture files are hashed on request and byte identical files under different paths
+		 * resolve to a single TextureAsset. Costs an extra read of every requested texture file.
+		 */
+		inline static void SetContentDeduplication(bool enabled) { s_ContentDeduplication = enabled; }
+		[[nodiscard]] inline static bool IsContentDeduplicationEnabled() { return s_ContentDeduplication; }
+
+		struct Statistics
+		{
+			uint64_t TexturesLoaded = 0;
+			uint64_t ModelsLoaded = 0;
+			uint64_t DeduplicatedTextures = 0; // Requests resolved to an already existing asset with the same content
+			uint64_t DeduplicatedBytes = 0; // Source file bytes that didn't have to be decoded and uploaded again
+		};
+
+		/**
+		 * @brief Mounts a package built by VulkanHelperPacker.
+		 *
+		 * Paths are looked up in mounted packages before the file system, packages mounted later win over earlier ones.
+		 */
+		static bool MountPackage(const std::string& path);
+		static void UnmountPackages();
+
+		// Maps the file, or the package entry holding it, decompressing it if needed. False if it exists nowhere
+		[[nodiscard]] static bool OpenFile(const std::string& path, AssetFile* outFile);
+		[[nodiscard]] static bool FileExists(const std::string& path);
+		// Uncompressed size, 0 if the file exists nowhere
+		[[nodiscard]] static uint64_t GetFileSize(const std::string& path);
+
+		/**
+		 * @brief Loads the manifest written by VulkanHelperCooker, requests for cooked sources load the cooked files from then on.
+		 *
+		 * Textures are redirected per role, so a texture cooked for one role still loads from source for others.
+		 */
+		static bool LoadCookManifest(const std::string& path);
+		// Cooked file for the asset or texture ID, empty if it wasn't cooked
+		[[nodiscard]] static std::string GetCookedPath(AssetID id);
+
+		[[nodiscard]] static Statistics GetStatistics();
+		static void ResetStatistics();
+
+		[[nodiscard]] inline static ThreadPool& GetThreadPool() { return s_ThreadPool; }
+		[[nodiscard]] inline static AsyncFileReader& GetFileReader() { return s_FileReader; }
 
 	private:
-		inline static Device* s_Device = nullptr;
+		friend class AssetImporter;
+		friend class GLTFImporter;
+		friend class AssetCooker;
+		friend class AssetPrefetcher;
+
+		enum class AssetType
+		{
+			Texture,
+			Model,
+			EnvironmentMap,
+		};
 
 		struct AssetHandleWeakPtr
 		{
@@ -37,8 +150,71 @@ namespace VulkanHelper
 			std::weak_ptr<Asset> Asset;
 		};
 
-		inline static std::unordered_map<uint64_t, AssetHandleWeakPtr> s_Assets;
+		struct LoadRequest
+		{
+			std::string Path;
+			AssetType Type;
+			uint64_t FileSize = 0;
+			uint32_t FaceSize = 0; // Only used by environment maps
+			TextureRole Role = TextureRole::Color;
+			std::weak_ptr<Asset> Asset;
+			std::shared_ptr<std::promise<void>> Promise;
+		};
+
+		using AssetMap = ShardedMap<AssetID, AssetHandleWeakPtr>::Map;
+
+		// Same as the public versions without notifying the AssetPrefetcher, which uses them for its own requests
+		static AssetHandle RequestAsset(const std::string& path, TextureRole role);
+		static std::vector<AssetHandle> RequestAssets(std::span<const std::string> paths, TextureRole role);
+		static AssetHandle RequestEnvironmentMap(const std::string& path, uint32_t faceSize);
+
+		static std::string GetExtension(const std::string& path);
+		static AssetType GetAssetType(const std::string& path);
+		static bool IsHDRTexture(const std::string& path);
+		static bool FindAsset(AssetMap& assets, AssetID id, AssetHandle* outHandle);
+		static AssetHandle FindOrCreateAsset(AssetMap& assets, AssetID id, AssetType type, std::shared_ptr<std::promise<void>>* outPromise);
+		// Embedded model textures are keyed by the model ID and their index in the model, loading is up to the importer
+		static AssetHandle FindOrCreateEmbeddedTexture(AssetID modelID, uint32_t textureIndex, TextureRole role, std::shared_ptr<std::promise<void>>* outPromise);
+		static AssetHandle FindOrCreateTextureByContent(const std::string& path, AssetID pathID, TextureRole role, std::shared_ptr<std::promise<void>>* outPromise, uint64_t* outFileSize);
+
+		using FileCallback = std::function<void(std::shared_ptr<AssetFile> file)>;
+
+		// Callback runs on a worker thread. Loose files are read by the async reader first, packaged ones are opened by the worker.
+		// file is null if it couldn't be opened or read completely. Read and decompression times are profiled under profileName,
+		// so a cooked file is recorded under the path it was requested with
+		static void ReadFileAsync(const std::string& path, const std::string& profileName, FileCallback callback);
+		static bool OpenPackagedFile(const std::string& path, AssetFile* outFile, const std::string& profileName);
+		// Last mounted package holding the ID, null if none does
+		static std::shared_ptr<const Package> FindPackage(AssetID id);
+
+		// Cooked file if there is one, the source otherwise
+		static std::string GetTextureReadPath(const LoadRequest& request);
+		static void LoadTexture(const LoadRequest& request);
+		static void LoadTextureGroup(std::vector<LoadRequest> requests);
+		static void LoadModel(const LoadRequest& request);
+		static void LoadEnvironmentMap(const LoadRequest& request);
+
+		// Max amount of textures recorded into one upload submission by GetAssets()
+		inline static constexpr uint32_t s_UploadGroupSize = 16;
+
+		inline static Device* s_Device = nullptr;
+		inline static VkFormat s_HDRFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+		inline static ShardedMap<AssetID, AssetHandleWeakPtr> s_Assets;
+		inline static ShardedMap<AssetID, AssetHandleWeakPtr> s_ContentAssets; // Keyed by hash of the file bytes
+		inline static std::atomic<bool> s_ContentDeduplication = false;
+
+		inline static std::atomic<uint64_t> s_TexturesLoaded = 0;
+		inline static std::atomic<uint64_t> s_ModelsLoaded = 0;
+		inline static std::atomic<uint64_t> s_DeduplicatedTextures = 0;
+		inline static std::atomic<uint64_t> s_DeduplicatedBytes = 0;
+		inline static std::vector<std::shared_ptr<const Package>> s_Packages; // Searched back to front
+		inline static std::shared_mutex s_PackagesMutex;
+
+		inline static std::unordered_map<AssetID, std::string> s_CookedPaths;
+		inline static std::shared_mutex s_CookedPathsMutex;
+
 		inline static ThreadPool s_ThreadPool;
-		inline static std::mutex s_AssetsMutex;
+		inline static AsyncFileReader s_FileReader; // Declared after the pool so it shuts down first, its callbacks push into the pool
 	};
-}
\ No newline at end of file
+}
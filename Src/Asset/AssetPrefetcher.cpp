@@ -0,0 +1,347 @@
+#include "Pch.h"
+#include "AssetPrefetcher.h"
+
+#include "Logger/Logger.h"
+#include "Utility/Json.h"
+#include "Utility/MappedFile.h"
+
+namespace
+{
+	enum class PrefetchState
+	{
+		Waiting,
+		Issued,
+		Claimed,
+		Expired,
+	};
+
+	struct PendingAsset
+	{
+		VulkanHelper::AssetPrefetcher::Entry Entry;
+		PrefetchState State = PrefetchState::Waiting;
+		VulkanHelper::AssetHandle Handle; // Keeps the asset alive until it's claimed or expires
+	};
+
+	double GetMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+// Recording, guarded by s_RecordMutex
+static std::mutex s_RecordMutex;
+static std::chrono::steady_clock::time_point s_RecordStart;
+static std::vector<VulkanHelper::AssetPrefetcher::Entry> s_Recorded;
+static std::unordered_set<VulkanHelper::AssetID> s_RecordedIDs;
+
+// Prefetching, guarded by s_PrefetchMutex
+static std::mutex s_PrefetchMutex;
+static VulkanHelper::AssetPrefetcher::PrefetchInfo s_Info;
+static std::chrono::steady_clock::time_point s_PrefetchStart;
+static std::vector<PendingAsset> s_Pending; // Manifest order
+static std::unordered_map<VulkanHelper::AssetID, size_t> s_PendingIndices;
+static size_t s_NextWaiting = 0; // Everything before it was issued, claimed or expired
+static uint64_t s_OutstandingBytes = 0; // File size of issued assets that weren't claimed yet
+static VulkanHelper::AssetPrefetcher::Statistics s_Statistics;
+static uint64_t s_Generation = 0; // Bumped by every BeginPrefetch(), s_Pending may be replaced while Update() issues unlocked
+
+static VulkanHelper::AssetID GetEntryID(const VulkanHelper::AssetPrefetcher::Entry& entry)
+{
+	if (entry.EnvironmentMap)
+		return VulkanHelper::AssetManager::GetEnvironmentMapID(entry.Path, entry.FaceSize);
+
+	return VulkanHelper::AssetManager::GetTextureID(entry.Path, entry.Role);
+}
+
+void VulkanHelper::AssetPrefetcher::StartRecording()
+{
+	std::lock_guard<std::mutex> lock(s_RecordMutex);
+	s_Recorded.clear();
+	s_RecordedIDs.clear();
+	s_RecordStart = std::chrono::steady_clock::now();
+	s_Recording = true;
+}
+
+bool VulkanHelper::AssetPrefetcher::StopRecording(const std::string& manifestPath)
+{
+	std::vector<Entry> entries;
+	{
+		std::lock_guard<std::mutex> lock(s_RecordMutex);
+		s_Recording = false;
+		entries = std::move(s_Recorded);
+		s_Recorded.clear();
+		s_RecordedIDs.clear();
+	}
+
+	VH_INFO("Recorded {} asset requests into {}", entries.size(), manifestPath);
+	return WriteManifest(manifestPath, entries);
+}
+
+bool VulkanHelper::AssetPrefetcher::BeginPrefetch(const PrefetchInfo& info)
+{
+	std::vector<Entry> entries;
+	if (!ReadManifest(info.ManifestPath, &entries))
+		return false;
+
+	EndPrefetch();
+
+	{
+		std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+		s_Info = info;
+		s_PrefetchStart = std::chrono::steady_clock::now();
+		s_Statistics = {};
+		s_NextWaiting = 0;
+		s_OutstandingBytes = 0;
+		s_Generation++;
+
+		s_Pending.reserve(entries.size());
+		for (Entry& entry : entries)
+		{
+			AssetID id = GetEntryID(entry);
+			if (s_PendingIndices.contains(id))
+				continue;
+
+			s_PendingIndices[id] = s_Pending.size();
+			s_Pending.push_back({ std::move(entry) });
+		}
+
+		s_Prefetching = true;
+	}
+
+	Update();
+	return true;
+}
+
+void VulkanHelper::AssetPrefetcher::Update()
+{
+	if (!s_Prefetching)
+		return;
+
+	std::unique_lock<std::mutex> lock(s_PrefetchMutex);
+	double now = GetMilliseconds(s_PrefetchStart);
+
+	// Mispredictions get dropped once they're overdue, freeing their budget
+	for (size_t i = 0; i < s_NextWaiting; i++)
+	{
+		PendingAsset& pending = s_Pending[i];
+		if (pending.State != PrefetchState::Issued || now <= pending.Entry.Milliseconds + s_Info.ExpiryMilliseconds)
+			continue;
+
+		pending.State = PrefetchState::Expired;
+		pending.Handle = AssetHandle();
+		s_OutstandingBytes -= pending.Entry.FileSize;
+		s_Statistics.Expired++;
+	}
+
+	// Issue in recorded order as long as the budget allows, a single asset above budget still goes on its own
+	std::vector<size_t> issued;
+	for (; s_NextWaiting < s_Pending.size(); s_NextWaiting++)
+	{
+		PendingAsset& pending = s_Pending[s_NextWaiting];
+		if (pending.State != PrefetchState::Waiting)
+			continue;
+
+		if (now > pending.Entry.Milliseconds + s_Info.ExpiryMilliseconds)
+		{
+			pending.State = PrefetchState::Expired;
+			s_Statistics.Expired++;
+			continue;
+		}
+
+		if (s_OutstandingBytes != 0 && s_OutstandingBytes + pending.Entry.FileSize > s_Info.MemoryBudget)
+			break;
+
+		pending.State = PrefetchState::Issued;
+		s_OutstandingBytes += pending.Entry.FileSize;
+		s_Statistics.Issued++;
+		issued.push_back(s_NextWaiting);
+	}
+
+	if (issued.empty())
+		return;
+
+	std::vector<Entry> entries;
+	entries.reserve(issued.size());
+	for (size_t index : issued)
+		entries.push_back(s_Pending[index].Entry);
+
+	// Requests can take a while with content deduplication, and model loads request their textures from workers
+	uint64_t generation = s_Generation;
+	lock.unlock();
+
+	// Same role requests go through GetAssets() together so their uploads share submissions
+	std::vector<AssetHandle> handles(entries.size());
+	std::vector<std::string> paths;
+	std::vector<size_t> groupIndices;
+	for (uint32_t role = 0; role <= (uint32_t)TextureRole::Generic; role++)
+	{
+		paths.clear();
+		groupIndices.clear();
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			if (!entries[i].EnvironmentMap && entries[i].Role == (TextureRole)role)
+			{
+				paths.push_back(entries[i].Path);
+				groupIndices.push_back(i);
+			}
+		}
+
+		if (paths.empty())
+			continue;
+
+		std::vector<AssetHandle> groupHandles = AssetManager::RequestAssets(paths, (TextureRole)role);
+		for (size_t i = 0; i < groupIndices.size(); i++)
+			handles[groupIndices[i]] = std::move(groupHandles[i]);
+	}
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].EnvironmentMap)
+			handles[i] = AssetManager::RequestEnvironmentMap(entries[i].Path, entries[i].FaceSize);
+	}
+
+	lock.lock();
+	if (!s_Prefetching || generation != s_Generation)
+		return;
+
+	for (size_t i = 0; i < issued.size(); i++)
+	{
+		// Claimed or expired in the meantime, the handle isn't needed anymore then
+		PendingAsset& pending = s_Pending[issued[i]];
+		if (pending.State == PrefetchState::Issued)
+			pending.Handle = std::move(handles[i]);
+	}
+}
+
+VulkanHelper::AssetPrefetcher::Statistics VulkanHelper::AssetPrefetcher::EndPrefetch()
+{
+	std::vector<PendingAsset> pending;
+	Statistics statistics;
+	{
+		std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+		if (!s_Prefetching)
+			return s_Statistics;
+
+		s_Prefetching = false;
+		for (const PendingAsset& asset : s_Pending)
+		{
+			if (asset.State == PrefetchState::Issued)
+				s_Statistics.Expired++;
+		}
+
+		pending = std::move(s_Pending);
+		s_Pending.clear();
+		s_PendingIndices.clear();
+		s_OutstandingBytes = 0;
+		statistics = s_Statistics;
+	}
+
+	VH_INFO("Asset prefetch ended, {} issued, {} hits, {} late, {} expired", statistics.Issued, statistics.Hits, statistics.Late, statistics.Expired);
+
+	// Handles are dropped outside of the lock, the last reference frees the asset
+	pending.clear();
+	return statistics;
+}
+
+void VulkanHelper::AssetPrefetcher::OnRequest(AssetID id, const std::string& path, TextureRole role, bool environmentMap, uint32_t faceSize)
+{
+	if (s_Recording)
+	{
+		std::lock_guard<std::mutex> lock(s_RecordMutex);
+		if (s_Recording && s_RecordedIDs.insert(id).second)
+			s_Recorded.push_back({ AssetManager::CanonicalizePath(path), role, environmentMap, faceSize, GetMilliseconds(s_RecordStart), AssetManager::GetFileSize(path) });
+	}
+
+	if (!s_Prefetching)
+		return;
+
+	AssetHandle released;
+	{
+		std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+		auto iter = s_PendingIndices.find(id);
+		if (iter == s_PendingIndices.end())
+			return;
+
+		PendingAsset& pending = s_Pending[iter->second];
+		if (pending.State == PrefetchState::Issued)
+		{
+			// The requester holds its own handle by now, the prefetcher's reference can go
+			released = std::move(pending.Handle);
+			s_OutstandingBytes -= pending.Entry.FileSize;
+			s_Statistics.Hits++;
+		}
+		else if (pending.State == PrefetchState::Waiting)
+		{
+			s_Statistics.Late++;
+		}
+		else
+		{
+			return;
+		}
+
+		pending.State = PrefetchState::Claimed;
+	}
+
+	Update();
+}
+
+bool VulkanHelper::AssetPrefetcher::ReadManifest(const std::string& path, std::vector<Entry>* outEntries)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		VH_WARN("Access manifest {} doesn't exist", path);
+		return false;
+	}
+
+	JsonValue json;
+	std::string error;
+	if (!JsonValue::Parse((const char*)file.GetData(), file.GetSize(), &json, &error) || json["version"].GetInt() != s_ManifestVersion)
+	{
+		VH_WARN("Ignoring invalid access manifest {}: {}", path, error.empty() ? "unsupported version" : error);
+		return false;
+	}
+
+	for (const JsonValue& value : json["entries"].GetElements())
+	{
+		Entry entry;
+		entry.Path = value["path"].GetString();
+		entry.Role = (TextureRole)value["role"].GetInt();
+		entry.EnvironmentMap = value["environmentMap"].GetBool();
+		entry.FaceSize = (uint32_t)value["faceSize"].GetInt();
+		entry.Milliseconds = value["ms"].GetNumber();
+		entry.FileSize = (uint64_t)value["size"].GetInt();
+
+		if (!entry.Path.empty() && entry.Role <= TextureRole::Generic)
+			outEntries->push_back(std::move(entry));
+	}
+
+	// Issued in time order
+	std::stable_sort(outEntries->begin(), outEntries->end(), [](const Entry& a, const Entry& b) { return a.Milliseconds < b.Milliseconds; });
+
+	return true;
+}
+
+bool VulkanHelper::AssetPrefetcher::WriteManifest(const std::string& path, std::span<const Entry> entries)
+{
+	std::ofstream stream(path, std::ios::trunc);
+	if (!stream)
+	{
+		VH_ERROR("Failed to write access manifest {}", path);
+		return false;
+	}
+
+	stream << "{\n\t\"version\": " << s_ManifestVersion << ",\n\t\"entries\": [";
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const Entry& entry = entries[i];
+		stream << (i == 0 ? "\n" : ",\n") << "\t\t{ \"path\": " << JsonValue::Quote(entry.Path);
+		stream << ", \"role\": " << (uint32_t)entry.Role;
+		if (entry.EnvironmentMap)
+			stream << ", \"environmentMap\": true, \"faceSize\": " << entry.FaceSize;
+		stream << ", \"ms\": " << entry.Milliseconds << ", \"size\": " << entry.FileSize << " }";
+	}
+	stream << (entries.empty() ? "]\n}\n" : "\n\t]\n}\n");
+
+	return (bool)stream;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "Pch.h"
+
+#include "AssetManager.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Records which assets get requested when, and replays that on later launches as speculative loads.
+	 *
+	 * A recording run writes every first request through AssetManager with its time since StartRecording() into an
+	 * access manifest. BeginPrefetch() reads it back and loads the listed assets on the asset threads ahead of the
+	 * game asking for them, the game's own request then resolves to the already loading asset. Prefetched assets are
+	 * kept alive until requested, bounded by a budget of source bytes, and dropped once they're overdue.
+	 */
+	class AssetPrefetcher
+	{
+	public:
+		struct Entry
+		{
+			std::string Path;
+			TextureRole Role = TextureRole::Color;
+			bool EnvironmentMap = false; // Requested through AssetManager::GetEnvironmentMap()
+			uint32_t FaceSize = 0; // Environment maps only
+			double Milliseconds = 0.0; // Since StartRecording()
+			uint64_t FileSize = 0;
+		};
+
+		struct PrefetchInfo
+		{
+			std::string ManifestPath;
+			uint64_t MemoryBudget = 256ull * 1024 * 1024; // Source bytes of prefetched assets that weren't requested yet
+			double ExpiryMilliseconds = 2000.0; // How late after its recorded time an asset may be requested before it's dropped
+		};
+
+		struct Statistics
+		{
+			uint32_t Issued = 0;
+			uint32_t Hits = 0; // Issued and requested afterwards
+			uint32_t Late = 0; // Requested before the prefetcher got to it
+			uint32_t Expired = 0; // Mispredicted, dropped without a request
+		};
+
+		inline static constexpr uint32_t s_ManifestVersion = 1;
+
+		static void StartRecording();
+		// Writes the requests since StartRecording() as an access manifest
+		static bool StopRecording(const std::string& manifestPath);
+		[[nodiscard]] inline static bool IsRecording() { return s_Recording; }
+
+		/**
+		 * @brief Starts loading the assets of an access manifest, call it at the same point of startup StartRecording() was.
+		 *
+		 * Returns false if the manifest can't be read, nothing is prefetched then.
+		 */
+		static bool BeginPrefetch(const PrefetchInfo& info);
+
+		/**
+		 * @brief Drops overdue assets and issues more as budget frees up, call it once per frame while prefetching.
+		 *
+		 * Requests through AssetManager update the prefetcher too, this only matters once they stop coming.
+		 */
+		static void Update();
+
+		// Drops every prefetched asset that wasn't requested and stops prefetching
+		static Statistics EndPrefetch();
+		[[nodiscard]] inline static bool IsPrefetching() { return s_Prefetching; }
+
+		[[nodiscard]] static bool ReadManifest(const std::string& path, std::vector<Entry>* outEntries);
+		[[nodiscard]] static bool WriteManifest(const std::string& path, std::span<const Entry> entries);
+
+	private:
+		friend class AssetManager;
+
+		// Called by AssetManager after every request, once the requester holds its handle
+		static void OnRequest(AssetID id, const std::string& path, TextureRole role, bool environmentMap, uint32_t faceSize);
+
+		inline static std::atomic<bool> s_Recording = false;
+		inline static std::atomic<bool> s_Prefetching = false;
+	};
+}
@@ -0,0 +1,185 @@
+#include "Pch.h"
+#include "AssetProfiler.h"
+
+#include "Logger/Logger.h"
+#include "Utility/Json.h"
+
+// Everything below is guarded by s_Mutex
+static std::mutex s_Mutex;
+static std::unordered_map<std::string, VulkanHelper::AssetProfiler::AssetRecord> s_Assets;
+static VulkanHelper::AssetProfiler::StageStatistics s_Stages[(size_t)VulkanHelper::AssetStage::Count];
+
+static std::string s_BatchName;
+static std::chrono::steady_clock::time_point s_BatchStart;
+static bool s_BatchActive = false;
+
+static void WriteJsonStages(std::ofstream& stream, const VulkanHelper::AssetProfiler::StageStatistics* stages, const char* indent)
+{
+	stream << "{";
+	bool first = true;
+	for (uint32_t i = 0; i < (uint32_t)VulkanHelper::AssetStage::Count; i++)
+	{
+		const VulkanHelper::AssetProfiler::StageStatistics& stage = stages[i];
+		if (stage.Count == 0)
+			continue;
+
+		stream << (first ? "\n" : ",\n") << indent << "\t\"" << VulkanHelper::AssetProfiler::GetStageName((VulkanHelper::AssetStage)i) << "\": { ";
+		stream << "\"count\": " << stage.Count << ", \"ms\": " << stage.GetMilliseconds() << ", \"bytes\": " << stage.Bytes << ", \"mbPerSecond\": " << stage.GetMegabytesPerSecond() << " }";
+		first = false;
+	}
+	if (first)
+		stream << "}";
+	else
+		stream << "\n" << indent << "}";
+}
+
+uint64_t VulkanHelper::AssetProfiler::AssetRecord::GetTotalNanoseconds() const
+{
+	uint64_t total = 0;
+	for (const StageStatistics& stage : Stages)
+		total += stage.Nanoseconds;
+
+	return total;
+}
+
+VulkanHelper::AssetProfiler::ScopedTimer::ScopedTimer(const std::string& path, AssetStage stage, uint64_t bytes /*= 0*/)
+	: m_Stage(stage), m_Bytes(bytes)
+{
+	if (!s_Enabled)
+		return;
+
+	m_Path = &path;
+	m_Start = std::chrono::steady_clock::now();
+}
+
+VulkanHelper::AssetProfiler::ScopedTimer::~ScopedTimer()
+{
+	Stop();
+}
+
+void VulkanHelper::AssetProfiler::ScopedTimer::Stop()
+{
+	if (!m_Path)
+		return;
+
+	uint64_t nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+	Record(*m_Path, m_Stage, nanoseconds, m_Bytes);
+	m_Path = nullptr;
+}
+
+void VulkanHelper::AssetProfiler::Record(const std::string& path, AssetStage stage, uint64_t nanoseconds, uint64_t bytes /*= 0*/)
+{
+	if (!s_Enabled)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+
+	AssetRecord& record = s_Assets[path];
+	if (record.Path.empty())
+		record.Path = path;
+
+	for (StageStatistics* stats : { &record.Stages[(size_t)stage], &s_Stages[(size_t)stage] })
+	{
+		stats->Count++;
+		stats->Nanoseconds += nanoseconds;
+		stats->Bytes += bytes;
+	}
+}
+
+void VulkanHelper::AssetProfiler::BeginBatch(const std::string& name)
+{
+	Reset();
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_BatchName = name;
+	s_BatchStart = std::chrono::steady_clock::now();
+	s_BatchActive = true;
+}
+
+VulkanHelper::AssetProfiler::Report VulkanHelper::AssetProfiler::EndBatch(const std::string& reportPath /*= ""*/)
+{
+	Report report = GetReport();
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_BatchActive = false;
+	}
+
+	VH_INFO("Asset batch {} loaded in {:.2f} ms, {} assets", report.BatchName, (double)report.WallNanoseconds / 1e6, report.Assets.size());
+
+	if (!reportPath.empty())
+		(void)WriteReport(report, reportPath);
+
+	return report;
+}
+
+VulkanHelper::AssetProfiler::Report VulkanHelper::AssetProfiler::GetReport()
+{
+	Report report;
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		report.BatchName = s_BatchName;
+		if (s_BatchActive)
+			report.WallNanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_BatchStart).count();
+
+		for (size_t i = 0; i < (size_t)AssetStage::Count; i++)
+			report.Stages[i] = s_Stages[i];
+
+		report.Assets.reserve(s_Assets.size());
+		for (const auto& [path, record] : s_Assets)
+			report.Assets.push_back(record);
+	}
+
+	std::sort(report.Assets.begin(), report.Assets.end(), [](const AssetRecord& a, const AssetRecord& b) { return a.GetTotalNanoseconds() > b.GetTotalNanoseconds(); });
+
+	return report;
+}
+
+bool VulkanHelper::AssetProfiler::WriteReport(const Report& report, const std::string& path)
+{
+	std::ofstream stream(path, std::ios::trunc);
+	if (!stream)
+	{
+		VH_ERROR("Failed to write asset profile report to {}", path);
+		return false;
+	}
+
+	stream << "{\n\t\"batch\": " << JsonValue::Quote(report.BatchName);
+	stream << ",\n\t\"wallMs\": " << (double)report.WallNanoseconds / 1e6;
+	stream << ",\n\t\"stages\": ";
+	WriteJsonStages(stream, report.Stages, "\t");
+	stream << ",\n\t\"assets\": [";
+	for (size_t i = 0; i < report.Assets.size(); i++)
+	{
+		const AssetRecord& record = report.Assets[i];
+		stream << (i == 0 ? "\n" : ",\n") << "\t\t{\n\t\t\t\"path\": " << JsonValue::Quote(record.Path);
+		stream << ",\n\t\t\t\"totalMs\": " << (double)record.GetTotalNanoseconds() / 1e6;
+		stream << ",\n\t\t\t\"stages\": ";
+		WriteJsonStages(stream, record.Stages, "\t\t\t");
+		stream << "\n\t\t}";
+	}
+	stream << (report.Assets.empty() ? "]\n}\n" : "\n\t]\n}\n");
+
+	return (bool)stream;
+}
+
+void VulkanHelper::AssetProfiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Assets.clear();
+	for (StageStatistics& stage : s_Stages)
+		stage = StageStatistics();
+}
+
+const char* VulkanHelper::AssetProfiler::GetStageName(AssetStage stage)
+{
+	switch (stage)
+	{
+	case AssetStage::FileRead: return "fileRead";
+	case AssetStage::Decompress: return "decompress";
+	case AssetStage::Parse: return "parse";
+	case AssetStage::Decode: return "decode";
+	case AssetStage::MeshBuild: return "meshBuild";
+	case AssetStage::UploadWait: return "uploadWait";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Pch.h"
+
+namespace VulkanHelper
+{
+	enum class AssetStage : uint32_t
+	{
+		FileRead,	// Async read from request to arrival, includes time spent queued
+		Decompress,	// LZ4 package entries
+		Parse,		// Model file parsing, Assimp scene or glTF document and buffers
+		Decode,		// Image decode into staging memory, HDR conversion, KTX2 supercompression
+		MeshBuild,	// Vertex and index conversion in Mesh::Init
+		UploadWait,	// Submitting an upload batch and waiting for the GPU copy
+
+		Count
+	};
+
+	/**
+	 * @brief Per asset, per stage timers of the asset pipeline.
+	 *
+	 * Disabled by default, every timer is a single branch then. Stage times are summed over all threads, so
+	 * stage throughput is per thread, while the batch wall time shows what the load cost overall.
+	 */
+	class AssetProfiler
+	{
+	public:
+		struct StageStatistics
+		{
+			uint64_t Count = 0;
+			uint64_t Nanoseconds = 0;
+			uint64_t Bytes = 0; // Input bytes processed by the stage
+
+			[[nodiscard]] inline double GetMilliseconds() const { return (double)Nanoseconds / 1e6; }
+			[[nodiscard]] inline double GetMegabytesPerSecond() const { return Nanoseconds == 0 ? 0.0 : ((double)Bytes / (1024.0 * 1024.0)) / ((double)Nanoseconds / 1e9); }
+		};
+
+		struct AssetRecord
+		{
+			std::string Path;
+			StageStatistics Stages[(size_t)AssetStage::Count];
+
+			[[nodiscard]] uint64_t GetTotalNanoseconds() const;
+		};
+
+		struct Report
+		{
+			std::string BatchName;
+			uint64_t WallNanoseconds = 0; // Since BeginBatch(), 0 without one
+			StageStatistics Stages[(size_t)AssetStage::Count];
+			std::vector<AssetRecord> Assets; // Slowest first
+		};
+
+		// Records the time from construction to destruction under the given asset and stage
+		class ScopedTimer
+		{
+		public:
+			ScopedTimer(const std::string& path, AssetStage stage, uint64_t bytes = 0);
+			~ScopedTimer();
+
+			ScopedTimer(const ScopedTimer& other) = delete;
+			ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+			// For stages that only know their input size once they're done
+			inline void SetBytes(uint64_t bytes) { m_Bytes = bytes; }
+
+			// Records right away instead of on destruction
+			void Stop();
+
+		private:
+			const std::string* m_Path = nullptr; // Null when profiling was disabled on construction
+			AssetStage m_Stage;
+			uint64_t m_Bytes;
+			std::chrono::steady_clock::time_point m_Start;
+		};
+
+		inline static void SetEnabled(bool enabled) { s_Enabled = enabled; }
+		[[nodiscard]] inline static bool IsEnabled() { return s_Enabled; }
+
+		static void Record(const std::string& path, AssetStage stage, uint64_t nanoseconds, uint64_t bytes = 0);
+
+		/**
+		 * @brief Clears everything recorded so far and starts the wall clock of a load batch.
+		 */
+		static void BeginBatch(const std::string& name);
+
+		/**
+		 * @brief Ends the current batch, call it once every handle of the batch finished loading.
+		 *
+		 * @param reportPath Optional, writes GetReport() there as JSON.
+		 */
+		static Report EndBatch(const std::string& reportPath = "");
+
+		[[nodiscard]] static Report GetReport();
+		static bool WriteReport(const Report& report, const std::string& path);
+		static void Reset();
+
+		[[nodiscard]] static const char* GetStageName(AssetStage stage);
+
+	private:
+		inline static std::atomic<bool> s_Enabled = false;
+	};
+}
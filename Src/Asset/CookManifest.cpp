@@ -0,0 +1,106 @@
+#include "Pch.h"
+#include "CookManifest.h"
+
+#include "Logger/Logger.h"
+#include "Utility/Json.h"
+
+#include <charconv>
+
+static constexpr int64_t s_ManifestVersion = 1;
+
+VulkanHelper::AssetID VulkanHelper::CookManifest::GetRequestID(const Entry& entry)
+{
+	if (entry.Type == EntryType::Texture)
+		return AssetManager::GetTextureID(entry.Source, entry.Role);
+
+	return AssetManager::GetAssetID(entry.Source);
+}
+
+bool VulkanHelper::CookManifest::Parse(const char* data, size_t size, CookManifest* outManifest, std::string* outError)
+{
+	JsonValue json;
+	if (!JsonValue::Parse(data, size, &json, outError))
+		return false;
+
+	if (json["version"].GetInt() != s_ManifestVersion)
+	{
+		*outError = "Unsupported manifest version " + std::to_string(json["version"].GetInt());
+		return false;
+	}
+
+	for (const JsonValue& value : json["entries"].GetElements())
+	{
+		Entry entry;
+		entry.Type = value["type"].GetString() == "model" ? EntryType::Model : EntryType::Texture;
+		entry.Source = value["source"].GetString();
+		entry.Cooked = value["cooked"].GetString();
+		entry.Role = (TextureRole)value["role"].GetInt();
+
+		// Hashes don't fit into a double, they are stored as hex strings
+		const std::string& hash = value["hash"].GetString();
+		std::from_chars(hash.data(), hash.data() + hash.size(), entry.Hash, 16);
+
+		for (const JsonValue& dependency : value["dependencies"].GetElements())
+			entry.Dependencies.push_back(dependency.GetString());
+
+		for (const JsonValue& texture : value["textures"].GetElements())
+			entry.Textures.push_back({ texture["path"].GetString(), (TextureRole)texture["role"].GetInt() });
+
+		for (const JsonValue& output : value["outputs"].GetElements())
+			entry.Outputs.push_back(output.GetString());
+
+		if (entry.Source.empty() || entry.Cooked.empty())
+		{
+			*outError = "Entry without source or cooked path";
+			return false;
+		}
+
+		outManifest->Entries.push_back(std::move(entry));
+	}
+
+	return true;
+}
+
+bool VulkanHelper::CookManifest::Write(const std::string& path) const
+{
+	std::ofstream stream(path, std::ios::trunc);
+	if (!stream)
+	{
+		VH_ERROR("Failed to write cook manifest {}", path);
+		return false;
+	}
+
+	stream << "{\n\t\"version\": " << s_ManifestVersion << ",\n\t\"entries\": [";
+	for (size_t i = 0; i < Entries.size(); i++)
+	{
+		const Entry& entry = Entries[i];
+
+		char hash[17];
+		snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)entry.Hash);
+
+		stream << (i == 0 ? "\n" : ",\n") << "\t\t{\n";
+		stream << "\t\t\t\"type\": " << (entry.Type == EntryType::Model ? "\"model\"" : "\"texture\"") << ",\n";
+		stream << "\t\t\t\"source\": " << JsonValue::Quote(entry.Source) << ",\n";
+		stream << "\t\t\t\"cooked\": " << JsonValue::Quote(entry.Cooked) << ",\n";
+		stream << "\t\t\t\"role\": " << (uint32_t)entry.Role << ",\n";
+		stream << "\t\t\t\"hash\": \"" << hash << "\",\n";
+
+		stream << "\t\t\t\"dependencies\": [";
+		for (size_t j = 0; j < entry.Dependencies.size(); j++)
+			stream << (j == 0 ? "" : ", ") << JsonValue::Quote(entry.Dependencies[j]);
+		stream << "],\n";
+
+		stream << "\t\t\t\"textures\": [";
+		for (size_t j = 0; j < entry.Textures.size(); j++)
+			stream << (j == 0 ? "" : ", ") << "{ \"path\": " << JsonValue::Quote(entry.Textures[j].Path) << ", \"role\": " << (uint32_t)entry.Textures[j].Role << " }";
+		stream << "],\n";
+
+		stream << "\t\t\t\"outputs\": [";
+		for (size_t j = 0; j < entry.Outputs.size(); j++)
+			stream << (j == 0 ? "" : ", ") << JsonValue::Quote(entry.Outputs[j]);
+		stream << "]\n\t\t}";
+	}
+	stream << (Entries.empty() ? "]\n}\n" : "\n\t]\n}\n");
+
+	return (bool)stream;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Pch.h"
+
+#include "AssetManager.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief List of everything the offline cooker produced, stored as JSON next to the cooked files.
+	 *
+	 * The runtime loads it with AssetManager::LoadCookManifest() to redirect requests for source files to their
+	 * cooked versions, the cooker reads it back to skip outputs whose inputs didn't change.
+	 */
+	class CookManifest
+	{
+	public:
+		enum class EntryType : uint32_t
+		{
+			Texture,
+			Model,
+		};
+
+		struct TextureReference
+		{
+			std::string Path;
+			TextureRole Role = TextureRole::Color;
+		};
+
+		struct Entry
+		{
+			EntryType Type = EntryType::Texture;
+			std::string Source; // Path the runtime requests
+			std::string Cooked;
+			TextureRole Role = TextureRole::Color; // Textures only, every role is cooked separately
+			uint64_t Hash = 0; // Of the cooker version and every dependency's content
+			std::vector<std::string> Dependencies; // Files read while cooking, the source first
+			std::vector<TextureReference> Textures; // Models only, external textures their materials use
+			std::vector<std::string> Outputs; // Models only, embedded textures cooked to their own files next to Cooked
+		};
+
+		// ID the runtime requests the source of the entry with
+		[[nodiscard]] static AssetID GetRequestID(const Entry& entry);
+
+		[[nodiscard]] static bool Parse(const char* data, size_t size, CookManifest* outManifest, std::string* outError);
+		[[nodiscard]] bool Write(const std::string& path) const;
+
+		std::vector<Entry> Entries;
+	};
+}
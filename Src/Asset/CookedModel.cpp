@@ -0,0 +1,188 @@
+#include "Pch.h"
+#include "CookedModel.h"
+
+#include "Utility/ByteReader.h"
+
+#include <cstring>
+
+namespace
+{
+	// Little endian, no padding, the file is only ever read by the same engine
+	struct ByteWriter
+	{
+		std::vector<uint8_t>* Data;
+
+		void Write(const void* value, size_t size)
+		{
+			const uint8_t* bytes = (const uint8_t*)value;
+			Data->insert(Data->end(), bytes, bytes + size);
+		}
+
+		template<typename T>
+		void Write(const T& value) { Write(&value, sizeof(T)); }
+
+		void WriteString(const std::string& string)
+		{
+			Write((uint32_t)string.size());
+			Write(string.data(), string.size());
+		}
+	};
+
+	struct Header
+	{
+		uint32_t Magic = VulkanHelper::CookedModel::s_Magic;
+		uint32_t Version = VulkanHelper::CookedModel::s_Version;
+		uint64_t SourceHash = 0;
+		uint32_t MeshCount = 0;
+		uint32_t MaterialCount = 0;
+		uint32_t InstanceCount = 0;
+		uint32_t Reserved = 0;
+	};
+}
+
+bool VulkanHelper::CookedModel::IsCookedModel(const void* data, size_t size)
+{
+	uint32_t magic = 0;
+	if (data == nullptr || size < sizeof(Header))
+		return false;
+
+	memcpy(&magic, data, sizeof(magic));
+	return magic == s_Magic;
+}
+
+void VulkanHelper::CookedModel::Write(const Model& model, std::vector<uint8_t>* outData)
+{
+	outData->clear();
+	ByteWriter writer{ outData };
+
+	Header header;
+	header.SourceHash = model.SourceHash;
+	header.MeshCount = (uint32_t)model.Meshes.size();
+	header.MaterialCount = (uint32_t)model.Materials.size();
+	header.InstanceCount = (uint32_t)model.Instances.size();
+	writer.Write(header);
+
+	for (const MaterialData& material : model.Materials)
+	{
+		const Material& parameters = material.Parameters;
+		writer.WriteString(parameters.MaterialName);
+		writer.Write(parameters.Color);
+		writer.Write(parameters.EmissiveColor);
+		writer.Write(parameters.MediumColor);
+		writer.Write(parameters.Metallic);
+		writer.Write(parameters.Roughness);
+		writer.Write(parameters.SpecularTint);
+		writer.Write(parameters.Ior);
+		writer.Write(parameters.Transparency);
+		writer.Write(parameters.MediumDensity);
+		writer.Write(parameters.MediumAnisotropy);
+		writer.Write(parameters.Anisotropy);
+		writer.Write(parameters.AnisotropyRotation);
+
+		for (const std::string& path : material.TexturePaths)
+			writer.WriteString(path);
+	}
+
+	for (const MeshInstance& instance : model.Instances)
+	{
+		writer.Write(instance.MeshIndex);
+		writer.Write(instance.Transform);
+		writer.WriteString(instance.NodeName);
+	}
+
+	for (const MeshData& mesh : model.Meshes)
+	{
+		writer.WriteString(mesh.Name);
+		writer.Write(mesh.Transform);
+		writer.Write(mesh.MaterialIndex);
+		writer.Write((uint64_t)mesh.Vertices.size());
+		writer.Write((uint64_t)mesh.Indices.size());
+		writer.Write(mesh.Vertices.data(), mesh.Vertices.size() * sizeof(Mesh::DefaultVertex));
+		writer.Write(mesh.Indices.data(), mesh.Indices.size() * sizeof(uint32_t));
+	}
+}
+
+bool VulkanHelper::CookedModel::Parse(const void* data, size_t size, Info* outInfo, std::string* outError)
+{
+	ByteReader reader{ (const uint8_t*)data, size };
+
+	Header header;
+	if (!IsCookedModel(data, size) || !reader.Read(&header))
+	{
+		*outError = "Not a cooked model";
+		return false;
+	}
+
+	if (header.Version != s_Version)
+	{
+		*outError = "Cooked with format version " + std::to_string(header.Version) + ", expected " + std::to_string(s_Version);
+		return false;
+	}
+
+	// Every record takes at least a byte, so bigger counts can only come from a corrupted header
+	if (header.MaterialCount > size || header.InstanceCount > size || header.MeshCount > size)
+	{
+		*outError = "Invalid header";
+		return false;
+	}
+
+	outInfo->SourceHash = header.SourceHash;
+
+	outInfo->Materials.resize(header.MaterialCount);
+	for (MaterialData& material : outInfo->Materials)
+	{
+		Material& parameters = material.Parameters;
+		bool valid = reader.ReadString(&parameters.MaterialName) &&
+			reader.Read(&parameters.Color) &&
+			reader.Read(&parameters.EmissiveColor) &&
+			reader.Read(&parameters.MediumColor) &&
+			reader.Read(&parameters.Metallic) &&
+			reader.Read(&parameters.Roughness) &&
+			reader.Read(&parameters.SpecularTint) &&
+			reader.Read(&parameters.Ior) &&
+			reader.Read(&parameters.Transparency) &&
+			reader.Read(&parameters.MediumDensity) &&
+			reader.Read(&parameters.MediumAnisotropy) &&
+			reader.Read(&parameters.Anisotropy) &&
+			reader.Read(&parameters.AnisotropyRotation);
+
+		for (std::string& path : material.TexturePaths)
+			valid = valid && reader.ReadString(&path);
+
+		if (!valid)
+		{
+			*outError = "Truncated material table";
+			return false;
+		}
+	}
+
+	outInfo->Instances.resize(header.InstanceCount);
+	for (MeshInstance& instance : outInfo->Instances)
+	{
+		if (!reader.Read(&instance.MeshIndex) || !reader.Read(&instance.Transform) || !reader.ReadString(&instance.NodeName) || instance.MeshIndex >= header.MeshCount)
+		{
+			*outError = "Truncated or invalid instance table";
+			return false;
+		}
+	}
+
+	outInfo->Meshes.resize(header.MeshCount);
+	for (MeshView& mesh : outInfo->Meshes)
+	{
+		if (!reader.ReadString(&mesh.Name) || !reader.Read(&mesh.Transform) || !reader.Read(&mesh.MaterialIndex) || !reader.Read(&mesh.VertexCount) || !reader.Read(&mesh.IndexCount))
+		{
+			*outError = "Truncated mesh table";
+			return false;
+		}
+
+		mesh.Vertices = reader.Skip(mesh.VertexCount, sizeof(Mesh::DefaultVertex));
+		mesh.Indices = mesh.Vertices ? reader.Skip(mesh.IndexCount, sizeof(uint32_t)) : nullptr;
+		if (!mesh.Vertices || !mesh.Indices || mesh.MaterialIndex >= header.MaterialCount)
+		{
+			*outError = "Mesh " + mesh.Name + " has invalid data";
+			return false;
+		}
+	}
+
+	return true;
+}
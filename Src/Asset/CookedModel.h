@@ -0,0 +1,82 @@
+#pragma once
+#include "Pch.h"
+
+#include "Asset.h"
+#include "Vulkan/Mesh.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Runtime model format written by the offline cooker.
+	 *
+	 * Holds everything AssetImporter::ImportModel() produces with the vertices already in Mesh::DefaultVertex layout, so
+	 * loading is a copy into staging memory. Materials reference their textures by the path they are requested with,
+	 * an empty path means the importer's fallback texture.
+	 */
+	class CookedModel
+	{
+	public:
+		enum MaterialTexture : uint32_t
+		{
+			MaterialTextureAlbedo,
+			MaterialTextureNormal,
+			MaterialTextureRoughness,
+			MaterialTextureMetalness,
+
+			MaterialTextureCount
+		};
+
+		struct MaterialData
+		{
+			Material Parameters; // Texture handles are ignored
+			std::string TexturePaths[MaterialTextureCount];
+		};
+
+		struct MeshData
+		{
+			std::string Name;
+			glm::mat4 Transform = glm::mat4(1.0f);
+			uint32_t MaterialIndex = 0;
+			std::vector<Mesh::DefaultVertex> Vertices;
+			std::vector<uint32_t> Indices;
+		};
+
+		struct Model
+		{
+			uint64_t SourceHash = 0;
+			std::vector<MeshData> Meshes;
+			std::vector<MaterialData> Materials;
+			std::vector<MeshInstance> Instances;
+		};
+
+		// Mesh of a parsed file, vertex and index data point into the file and may be unaligned
+		struct MeshView
+		{
+			std::string Name;
+			glm::mat4 Transform = glm::mat4(1.0f);
+			uint32_t MaterialIndex = 0;
+			const uint8_t* Vertices = nullptr;
+			uint64_t VertexCount = 0;
+			const uint8_t* Indices = nullptr;
+			uint64_t IndexCount = 0;
+		};
+
+		struct Info
+		{
+			uint64_t SourceHash = 0;
+			std::vector<MeshView> Meshes;
+			std::vector<MaterialData> Materials;
+			std::vector<MeshInstance> Instances;
+		};
+
+		inline static constexpr uint32_t s_Magic = 0x4C444D56; // "VMDL"
+		inline static constexpr uint32_t s_Version = 1;
+
+		[[nodiscard]] static bool IsCookedModel(const void* data, size_t size);
+
+		static void Write(const Model& model, std::vector<uint8_t>* outData);
+
+		// Checks every count and size against the file, the data has to outlive outInfo
+		[[nodiscard]] static bool Parse(const void* data, size_t size, Info* outInfo, std::string* outError);
+	};
+}
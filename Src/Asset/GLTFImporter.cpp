@@ -0,0 +1,845 @@
+#include "Pch.h"
+#include "GLTFImporter.h"
+
+#include "AssetImporter.h"
+#include "AssetManager.h"
+#include "AssetProfiler.h"
+#include "Logger/Logger.h"
+#include "Vulkan/Device.h"
+#include "Vulkan/UploadBatch.h"
+
+#include "glm.hpp"
+#include "gtc/quaternion.hpp"
+#include "gtc/matrix_transform.hpp"
+
+#include <charconv>
+
+// Values from the glTF 2.0 specification
+static constexpr uint32_t s_GLBMagic = 0x46546C67; // "glTF"
+static constexpr uint32_t s_GLBChunkJSON = 0x4E4F534A;
+static constexpr uint32_t s_GLBChunkBIN = 0x004E4942;
+
+static constexpr uint32_t s_ComponentByte = 5120;
+static constexpr uint32_t s_ComponentUnsignedByte = 5121;
+static constexpr uint32_t s_ComponentShort = 5122;
+static constexpr uint32_t s_ComponentUnsignedShort = 5123;
+static constexpr uint32_t s_ComponentUnsignedInt = 5125;
+static constexpr uint32_t s_ComponentFloat = 5126;
+
+static constexpr int64_t s_ModeTriangles = 4;
+
+// Same limit aiProcess_SplitLargeMeshes uses by default, bigger primitives are left to Assimp
+static constexpr uint64_t s_MaxPrimitiveSize = 1000000;
+
+// Sizes, offsets and counts are JSON numbers, anything that isn't a non negative integer a double can hold exactly is malformed
+static bool ReadSize(const VulkanHelper::JsonValue& value, bool required, uint64_t* outValue)
+{
+	static constexpr double s_MaxExactInteger = 9007199254740992.0; // 2^53
+
+	if (!value.IsNumber())
+	{
+		*outValue = 0;
+		return !required && value.IsNull();
+	}
+
+	double number = value.GetNumber();
+	if (!(number >= 0.0) || number >= s_MaxExactInteger || number != std::floor(number))
+		return false;
+
+	*outValue = (uint64_t)number;
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::IsGLTF(const std::string& path)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+	return extension == ".gltf" || extension == ".glb";
+}
+
+bool VulkanHelper::GLTFImporter::ImportModel(
+	Device* device,
+	const std::string& path,
+	std::vector<Mesh>* outMeshes,
+	std::vector<std::string>* outMeshNames,
+	std::vector<glm::mat4>* outMeshTransfrorms,
+	std::vector<Material>* outMaterials,
+	std::vector<uint32_t>* outMeshMaterialIndices,
+	std::vector<MeshInstance>* outInstances
+)
+{
+	if (!IsGLTF(path))
+		return false;
+
+	// Everything that can reject the file happens before the outputs are touched
+	AssetProfiler::ScopedTimer parseTimer(path, AssetStage::Parse);
+
+	Document document;
+	if (!LoadDocument(path, &document))
+		return false;
+
+	std::vector<Primitive> primitives;
+	std::vector<uint32_t> firstPrimitives;
+	if (!GatherPrimitives(document, &primitives, &firstPrimitives))
+		return false;
+
+	parseTimer.SetBytes(document.File.Size);
+	parseTimer.Stop();
+
+	uint32_t firstMesh = (uint32_t)outMeshes->size();
+	std::vector<MeshInstance> instances;
+	if (!GatherInstances(document, firstPrimitives, firstMesh, &instances))
+		return false;
+
+	// Every primitive becomes one Mesh, named and placed like the Assimp path does it
+	uint32_t primitiveCount = (uint32_t)primitives.size();
+	outMeshNames->resize(firstMesh + primitiveCount);
+	outMeshTransfrorms->resize(firstMesh + primitiveCount, glm::mat4(1.0f));
+	std::vector<bool> hasInstance(primitiveCount, false);
+	for (const MeshInstance& instance : instances)
+	{
+		uint32_t localIndex = instance.MeshIndex - firstMesh;
+		if (hasInstance[localIndex])
+			continue;
+
+		hasInstance[localIndex] = true;
+		(*outMeshNames)[instance.MeshIndex] = instance.NodeName;
+		(*outMeshTransfrorms)[instance.MeshIndex] = instance.Transform;
+	}
+
+	outInstances->insert(outInstances->end(), std::make_move_iterator(instances.begin()), std::make_move_iterator(instances.end()));
+
+	// Primitives without a material share one default material at the end of the remap table
+	const JsonValue& materials = document.Json["materials"];
+	AssetID modelID = AssetManager::GetAssetID(path);
+	std::vector<EmbeddedImageLoad> imageLoads;
+	uint32_t firstMaterial = (uint32_t)outMaterials->size();
+	std::vector<uint32_t> materialRemap(materials.GetSize() + 1, UINT32_MAX);
+	for (uint32_t i = 0; i < primitiveCount; i++)
+	{
+		if (!hasInstance[i])
+			(*outMeshNames)[firstMesh + i] = primitives[i].Name;
+
+		size_t materialIndex = primitives[i].Material >= 0 && primitives[i].Material < (int64_t)materials.GetSize() ? (size_t)primitives[i].Material : materials.GetSize();
+		if (materialRemap[materialIndex] == UINT32_MAX)
+		{
+			materialRemap[materialIndex] = (uint32_t)outMaterials->size();
+			outMaterials->push_back(ProcessMaterial(document, materials[materialIndex], modelID, &imageLoads));
+		}
+
+		outMeshMaterialIndices->push_back(materialRemap[materialIndex]);
+	}
+
+	outMeshes->resize(firstMesh + primitiveCount);
+
+	UploadBatch batch({ device });
+	AssetManager::GetThreadPool().ParallelFor(primitiveCount + (uint32_t)imageLoads.size(), [&](uint32_t i)
+		{
+			if (i < primitiveCount)
+			{
+				const Primitive& primitive = primitives[i];
+				AssetProfiler::ScopedTimer meshTimer(path, AssetStage::MeshBuild, primitive.Positions.Count * sizeof(Mesh::DefaultVertex) + primitive.Indices.Count * sizeof(uint32_t));
+				(void)(*outMeshes)[firstMesh + i].Init(device, primitive.Positions.Count, primitive.Indices.Count, &batch, [&](Mesh::DefaultVertex* vertices, uint32_t* indices)
+					{
+						WriteVertices(primitive, vertices);
+						WriteIndices(primitive, indices);
+					});
+				return;
+			}
+
+			EmbeddedImageLoad& load = imageLoads[i - primitiveCount];
+			std::shared_ptr<Asset> asset = load.Asset.lock();
+			if (!asset) // Every handle already dropped
+				return;
+
+			VH_TRACE("Loading Embedded Texture: {}", load.Name);
+
+			TextureAsset* textureAsset = (TextureAsset*)asset.get();
+			textureAsset->Image = AssetImporter::ImportTexture(device, load.Data, load.Size, load.Name, false, &batch, load.Role);
+			AssetManager::s_TexturesLoaded++;
+			load.KeepAlive = std::move(asset);
+		});
+
+	{
+		AssetProfiler::ScopedTimer uploadTimer(path, AssetStage::UploadWait);
+		batch.Submit();
+	}
+
+	for (EmbeddedImageLoad& load : imageLoads)
+	{
+		load.KeepAlive.reset();
+		load.Promise->set_value();
+	}
+
+	for (size_t i = firstMaterial; i < outMaterials->size(); i++)
+	{
+		(*outMaterials)[i].AlbedoTexture.WaitToLoad();
+		(*outMaterials)[i].NormalTexture.WaitToLoad();
+		(*outMaterials)[i].MetallnessTexture.WaitToLoad();
+		(*outMaterials)[i].RoughnessTexture.WaitToLoad();
+	}
+
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::LoadDocument(const std::string& path, Document* outDocument)
+{
+	outDocument->Path = path;
+	outDocument->Directory = std::filesystem::path(path).parent_path().string();
+
+	if (!AssetManager::OpenFile(path, &outDocument->File))
+		return false;
+
+	if (outDocument->File.Mapping.IsOpen())
+		outDocument->File.Mapping.Prefetch();
+
+	const uint8_t* data = outDocument->File.Data;
+	size_t size = outDocument->File.Size;
+
+	const char* json = (const char*)data;
+	size_t jsonSize = size;
+
+	uint32_t magic = 0;
+	if (size >= 12)
+		memcpy(&magic, data, sizeof(uint32_t));
+
+	if (magic == s_GLBMagic)
+	{
+		uint32_t header[3];
+		memcpy(header, data, sizeof(header));
+		if (header[1] != 2 || header[2] > size)
+			return false;
+
+		// JSON chunk has to come first, the optional BIN chunk right after it
+		json = nullptr;
+		size_t offset = 12;
+		while (offset + 8 <= header[2])
+		{
+			uint32_t chunk[2];
+			memcpy(chunk, data + offset, sizeof(chunk));
+			offset += 8;
+
+			if (chunk[0] > header[2] - offset)
+				return false;
+
+			if (chunk[1] == s_GLBChunkJSON && json == nullptr)
+			{
+				json = (const char*)data + offset;
+				jsonSize = chunk[0];
+			}
+			else if (chunk[1] == s_GLBChunkBIN && outDocument->BinChunk == nullptr)
+			{
+				outDocument->BinChunk = data + offset;
+				outDocument->BinChunkSize = chunk[0];
+			}
+
+			offset += chunk[0];
+		}
+
+		if (json == nullptr)
+			return false;
+	}
+
+	std::string error;
+	if (!JsonValue::Parse(json, jsonSize, &outDocument->Json, &error))
+	{
+		VH_WARN("Failed to parse glTF {}: {}", path, error);
+		return false;
+	}
+
+	const JsonValue& version = outDocument->Json["asset"]["version"];
+	if (!version.IsString() || version.GetString().empty() || version.GetString()[0] != '2')
+		return false;
+
+	// Draco, meshopt, quantization and so on
+	if (outDocument->Json["extensionsRequired"].GetSize() > 0)
+	{
+		VH_TRACE("glTF {} requires extensions, using Assimp", path);
+		return false;
+	}
+
+	return LoadBuffers(outDocument);
+}
+
+bool VulkanHelper::GLTFImporter::LoadBuffers(Document* document)
+{
+	const JsonValue& buffers = document->Json["buffers"];
+	document->Buffers.resize(buffers.GetSize());
+	for (size_t i = 0; i < buffers.GetSize(); i++)
+	{
+		const JsonValue& buffer = buffers[i];
+		BufferData& bufferData = document->Buffers[i];
+
+		uint64_t byteLength = 0;
+		if (!ReadSize(buffer["byteLength"], true, &byteLength))
+			return false;
+
+		const JsonValue& uri = buffer["uri"];
+		if (!uri.IsString())
+		{
+			// Only the GLB binary chunk can be referenced without an URI
+			if (document->BinChunk == nullptr || document->BinChunkSize < byteLength)
+				return false;
+
+			bufferData.Data = document->BinChunk;
+		}
+		else if (uri.GetString().starts_with("data:"))
+		{
+			if (!DecodeDataURI(uri.GetString(), &bufferData.OwnedData) || bufferData.OwnedData.size() < byteLength)
+				return false;
+
+			bufferData.Data = bufferData.OwnedData.data();
+		}
+		else
+		{
+			std::unique_ptr<AssetFile> file = std::make_unique<AssetFile>();
+			std::string filePath = (std::filesystem::path(document->Directory) / DecodeURI(uri.GetString())).string();
+			if (!AssetManager::OpenFile(filePath, file.get()) || file->Size < byteLength)
+			{
+				VH_WARN("Failed to open glTF buffer {}", filePath);
+				return false;
+			}
+
+			if (file->Mapping.IsOpen())
+				file->Mapping.Prefetch();
+			bufferData.Data = file->Data;
+			document->ExternalFiles.push_back(std::move(file));
+		}
+
+		bufferData.Size = byteLength;
+	}
+
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::GetAccessor(const Document& document, const JsonValue& index, AccessorView* outView)
+{
+	if (!index.IsNumber())
+		return false;
+
+	const JsonValue& accessor = document.Json["accessors"][(size_t)index.GetInt()];
+	if (!accessor.IsObject() || accessor.Has("sparse") || !accessor.Has("bufferView"))
+		return false;
+
+	const std::string& type = accessor["type"].GetString();
+	uint32_t componentCount = 0;
+	if (type == "SCALAR")
+		componentCount = 1;
+	else if (type == "VEC2")
+		componentCount = 2;
+	else if (type == "VEC3")
+		componentCount = 3;
+	else if (type == "VEC4")
+		componentCount = 4;
+	else
+		return false;
+
+	uint32_t componentType = (uint32_t)accessor["componentType"].GetInt();
+	uint64_t componentSize = 0;
+	switch (componentType)
+	{
+	case s_ComponentByte:
+	case s_ComponentUnsignedByte: componentSize = 1; break;
+	case s_ComponentShort:
+	case s_ComponentUnsignedShort: componentSize = 2; break;
+	case s_ComponentUnsignedInt:
+	case s_ComponentFloat: componentSize = 4; break;
+	default: return false;
+	}
+
+	const JsonValue& bufferView = document.Json["bufferViews"][(size_t)accessor["bufferView"].GetInt()];
+	size_t bufferIndex = (size_t)bufferView["buffer"].GetInt(-1);
+	if (!bufferView.IsObject() || bufferIndex >= document.Buffers.size())
+		return false;
+
+	const BufferData& buffer = document.Buffers[bufferIndex];
+	uint64_t offset = 0;
+	uint64_t stride = 0;
+	uint64_t count = 0;
+	if (!GetAccessorRange(accessor, bufferView, componentSize * componentCount, buffer.Size, &offset, &stride, &count))
+		return false;
+
+	outView->Data = buffer.Data + offset;
+	outView->Count = count;
+	outView->Stride = stride;
+	outView->ComponentType = componentType;
+	outView->ComponentCount = componentCount;
+	outView->Normalized = accessor["normalized"].GetBool();
+
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::GetBufferViewRange(const JsonValue& bufferView, uint64_t bufferSize, uint64_t* outOffset, uint64_t* outLength)
+{
+	uint64_t offset = 0;
+	uint64_t length = 0;
+	if (!ReadSize(bufferView["byteOffset"], false, &offset) || !ReadSize(bufferView["byteLength"], true, &length))
+		return false;
+
+	// Written so that nothing can wrap around
+	if (length > bufferSize || offset > bufferSize - length)
+		return false;
+
+	*outOffset = offset;
+	*outLength = length;
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::GetAccessorRange(
+	const JsonValue& accessor,
+	const JsonValue& bufferView,
+	uint64_t elementSize,
+	uint64_t bufferSize,
+	uint64_t* outOffset,
+	uint64_t* outStride,
+	uint64_t* outCount
+)
+{
+	uint64_t viewOffset = 0;
+	uint64_t viewLength = 0;
+	if (!GetBufferViewRange(bufferView, bufferSize, &viewOffset, &viewLength))
+		return false;
+
+	uint64_t offset = 0;
+	uint64_t stride = 0;
+	uint64_t count = 0;
+	if (!ReadSize(accessor["byteOffset"], false, &offset) || !ReadSize(bufferView["byteStride"], false, &stride) || !ReadSize(accessor["count"], true, &count))
+		return false;
+
+	if (stride == 0)
+		stride = elementSize;
+
+	if (elementSize == 0 || offset > viewLength)
+		return false;
+
+	// Last element has to end inside the view, (count - 1) * stride + elementSize <= viewLength - offset without overflowing
+	uint64_t available = viewLength - offset;
+	if (count != 0 && (elementSize > available || (count - 1) > (available - elementSize) / stride))
+		return false;
+
+	*outOffset = viewOffset + offset;
+	*outStride = stride;
+	*outCount = count;
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::GatherPrimitives(const Document& document, std::vector<Primitive>* outPrimitives, std::vector<uint32_t>* outFirstPrimitives)
+{
+	const JsonValue& meshes = document.Json["meshes"];
+	for (size_t meshIndex = 0; meshIndex < meshes.GetSize(); meshIndex++)
+	{
+		const JsonValue& mesh = meshes[meshIndex];
+		const JsonValue& meshPrimitives = mesh["primitives"];
+		outFirstPrimitives->push_back((uint32_t)outPrimitives->size());
+
+		for (size_t i = 0; i < meshPrimitives.GetSize(); i++)
+		{
+			const JsonValue& primitiveJson = meshPrimitives[i];
+			const JsonValue& attributes = primitiveJson["attributes"];
+
+			// Points and lines would be split off by aiProcess_SortByPType, strips and fans need triangulation
+			if (primitiveJson["mode"].GetInt(s_ModeTriangles) != s_ModeTriangles)
+				return false;
+
+			// Missing normals have to be generated
+			Primitive primitive;
+			if (!GetAccessor(document, attributes["POSITION"], &primitive.Positions) || !GetAccessor(document, attributes["NORMAL"], &primitive.Normals))
+				return false;
+
+			if (primitive.Positions.Count == 0 || primitive.Positions.ComponentType != s_ComponentFloat || primitive.Positions.ComponentCount != 3 ||
+				primitive.Normals.ComponentType != s_ComponentFloat || primitive.Normals.ComponentCount != 3 ||
+				primitive.Normals.Count != primitive.Positions.Count)
+				return false;
+
+			if (attributes.Has("TEXCOORD_0"))
+			{
+				AccessorView& texCoords = primitive.TexCoords;
+				if (!GetAccessor(document, attributes["TEXCOORD_0"], &texCoords) || texCoords.ComponentCount != 2 || texCoords.Count != primitive.Positions.Count)
+					return false;
+
+				bool normalizedInteger = texCoords.Normalized && (texCoords.ComponentType == s_ComponentUnsignedByte || texCoords.ComponentType == s_ComponentUnsignedShort);
+				if (texCoords.ComponentType != s_ComponentFloat && !normalizedInteger)
+					return false;
+			}
+
+			uint64_t triangleCount = primitive.Positions.Count / 3;
+			if (primitiveJson.Has("indices"))
+			{
+				AccessorView& indices = primitive.Indices;
+				if (!GetAccessor(document, primitiveJson["indices"], &indices) || indices.ComponentCount != 1 || indices.Count % 3 != 0)
+					return false;
+
+				if (indices.ComponentType != s_ComponentUnsignedByte && indices.ComponentType != s_ComponentUnsignedShort && indices.ComponentType != s_ComponentUnsignedInt)
+					return false;
+
+				triangleCount = indices.Count / 3;
+			}
+			else if (primitive.Positions.Count % 3 != 0)
+			{
+				return false;
+			}
+
+			if (primitive.Positions.Count > s_MaxPrimitiveSize || triangleCount > s_MaxPrimitiveSize)
+				return false;
+
+			primitive.Material = primitiveJson["material"].GetInt(-1);
+			primitive.Name = mesh["name"].GetString();
+			if (meshPrimitives.GetSize() > 1)
+				primitive.Name += "-" + std::to_string(i);
+
+			outPrimitives->push_back(std::move(primitive));
+		}
+	}
+
+	outFirstPrimitives->push_back((uint32_t)outPrimitives->size());
+
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::GatherInstances(const Document& document, const std::vector<uint32_t>& firstPrimitives, uint32_t firstMesh, std::vector<MeshInstance>* outInstances)
+{
+	const JsonValue& nodes = document.Json["nodes"];
+
+	struct NodeEntry
+	{
+		size_t Node;
+		glm::mat4 ParentTransform;
+	};
+
+	std::vector<NodeEntry> stack;
+	const JsonValue& scenes = document.Json["scenes"];
+	if (scenes.GetSize() > 0)
+	{
+		const JsonValue& roots = scenes[(size_t)document.Json["scene"].GetInt(0)]["nodes"];
+		for (size_t i = roots.GetSize(); i > 0; i--)
+		{
+			stack.push_back({ (size_t)roots[i - 1].GetInt(-1), glm::mat4(1.0f) });
+		}
+	}
+	else
+	{
+		// No scene, every node that isn't a child is a root
+		std::vector<bool> isChild(nodes.GetSize(), false);
+		for (const JsonValue& node : nodes.GetElements())
+		{
+			for (const JsonValue& child : node["children"].GetElements())
+			{
+				size_t childIndex = (size_t)child.GetInt(-1);
+				if (childIndex < isChild.size())
+					isChild[childIndex] = true;
+			}
+		}
+
+		for (size_t i = nodes.GetSize(); i > 0; i--)
+		{
+			if (!isChild[i - 1])
+				stack.push_back({ i - 1, glm::mat4(1.0f) });
+		}
+	}
+
+	// Top down like GatherAssimpInstances(). A valid file is a forest, visiting more nodes than exist means a cycle
+	size_t visitedCount = 0;
+	while (!stack.empty())
+	{
+		NodeEntry entry = stack.back();
+		stack.pop_back();
+
+		if (entry.Node >= nodes.GetSize() || ++visitedCount > nodes.GetSize())
+			return false;
+
+		const JsonValue& node = nodes[entry.Node];
+		glm::mat4 transform = entry.ParentTransform * GetNodeTransform(node);
+
+		if (node.Has("mesh"))
+		{
+			size_t meshIndex = (size_t)node["mesh"].GetInt(-1);
+			if (meshIndex + 1 >= firstPrimitives.size())
+				return false;
+
+			for (uint32_t primitive = firstPrimitives[meshIndex]; primitive < firstPrimitives[meshIndex + 1]; primitive++)
+			{
+				MeshInstance instance;
+				instance.MeshIndex = firstMesh + primitive;
+				instance.Transform = transform;
+				instance.NodeName = node["name"].GetString();
+				outInstances->push_back(std::move(instance));
+			}
+		}
+
+		const JsonValue& children = node["children"];
+		for (size_t i = children.GetSize(); i > 0; i--)
+		{
+			stack.push_back({ (size_t)children[i - 1].GetInt(-1), transform });
+		}
+	}
+
+	return true;
+}
+
+glm::mat4 VulkanHelper::GLTFImporter::GetNodeTransform(const JsonValue& node)
+{
+	// Column major, same as glm
+	const JsonValue& matrix = node["matrix"];
+	if (matrix.GetSize() == 16)
+	{
+		glm::mat4 transform;
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				transform[column][row] = matrix[(size_t)(column * 4 + row)].GetFloat();
+			}
+		}
+
+		return transform;
+	}
+
+	const JsonValue& t = node["translation"];
+	const JsonValue& r = node["rotation"];
+	const JsonValue& s = node["scale"];
+
+	glm::vec3 translation = glm::vec3(t[0].GetFloat(0.0f), t[1].GetFloat(0.0f), t[2].GetFloat(0.0f));
+	glm::quat rotation = glm::quat(r[3].GetFloat(1.0f), r[0].GetFloat(0.0f), r[1].GetFloat(0.0f), r[2].GetFloat(0.0f)); // Stored as xyzw
+	glm::vec3 scale = glm::vec3(s[0].GetFloat(1.0f), s[1].GetFloat(1.0f), s[2].GetFloat(1.0f));
+
+	return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+VulkanHelper::Material VulkanHelper::GLTFImporter::ProcessMaterial(const Document& document, const JsonValue& material, AssetID modelID, std::vector<EmbeddedImageLoad>* outImageLoads)
+{
+	Material mat;
+
+	const JsonValue& pbr = material["pbrMetallicRoughness"];
+	const JsonValue& extensions = material["extensions"];
+	const JsonValue& baseColor = pbr["baseColorFactor"];
+	const JsonValue& emissive = material["emissiveFactor"];
+
+	mat.MaterialName = material.IsNull() ? "DefaultMaterial" : material["name"].GetString();
+
+	// Mirrors what Assimp reports for glTF so both paths produce the same materials
+	mat.Color = glm::vec4(baseColor[0].GetFloat(1.0f), baseColor[1].GetFloat(1.0f), baseColor[2].GetFloat(1.0f), 1.0f);
+	mat.EmissiveColor = glm::vec4(emissive[0].GetFloat(0.0f), emissive[1].GetFloat(0.0f), emissive[2].GetFloat(0.0f), extensions["KHR_materials_emissive_strength"]["emissiveStrength"].GetFloat(1.0f));
+	mat.Roughness = glm::pow(pbr["roughnessFactor"].GetFloat(1.0f), 1.0f / 4.0f);
+	mat.Metallic = pbr["metallicFactor"].GetFloat(1.0f);
+	mat.Ior = extensions["KHR_materials_ior"]["ior"].GetFloat(mat.Ior);
+	mat.Transparency = extensions["KHR_materials_transmission"]["transmissionFactor"].GetFloat(mat.Transparency);
+
+	// Roughness is in G and metalness in B of the same texture, the roles pick the channel
+	mat.AlbedoTexture = LoadMaterialTexture(document, pbr["baseColorTexture"], TextureRole::Color, modelID, "assets/white.png", outImageLoads);
+	mat.NormalTexture = LoadMaterialTexture(document, material["normalTexture"], TextureRole::Normal, modelID, "assets/empty_normal.png", outImageLoads);
+	mat.RoughnessTexture = LoadMaterialTexture(document, pbr["metallicRoughnessTexture"], TextureRole::Roughness, modelID, "assets/white.png", outImageLoads);
+	mat.MetallnessTexture = LoadMaterialTexture(document, pbr["metallicRoughnessTexture"], TextureRole::Metalness, modelID, "assets/white.png", outImageLoads);
+
+	return mat;
+}
+
+VulkanHelper::AssetHandle VulkanHelper::GLTFImporter::LoadMaterialTexture(
+	const Document& document,
+	const JsonValue& textureInfo,
+	TextureRole role,
+	AssetID modelID,
+	const std::string& fallbackPath,
+	std::vector<EmbeddedImageLoad>* outImageLoads
+)
+{
+	const JsonValue& texture = document.Json["textures"][(size_t)textureInfo["index"].GetInt(-1)];
+	size_t imageIndex = (size_t)texture["source"].GetInt(-1);
+	const JsonValue& image = document.Json["images"][imageIndex];
+
+	// Create Empty Texture if none are found
+	if (!image.IsObject())
+		return AssetManager::GetAsset(fallbackPath, role);
+
+	const std::string& uri = image["uri"].GetString();
+	if (!image.Has("bufferView") && !uri.starts_with("data:"))
+	{
+		// Resolved the same way as the Assimp path so both share the texture assets
+		return AssetManager::GetAsset(std::string("assets/") + DecodeURI(uri), role);
+	}
+
+	EmbeddedImageLoad load;
+	load.Role = role;
+	load.Name = document.Path + "/images/" + std::to_string(imageIndex);
+
+	AssetHandle handle = AssetManager::FindOrCreateEmbeddedTexture(modelID, (uint32_t)imageIndex, role, &load.Promise);
+	if (!load.Promise)
+		return handle;
+
+	if (image.Has("bufferView"))
+	{
+		const JsonValue& bufferView = document.Json["bufferViews"][(size_t)image["bufferView"].GetInt()];
+		size_t bufferIndex = (size_t)bufferView["buffer"].GetInt(-1);
+		uint64_t viewOffset = 0;
+		uint64_t viewLength = 0;
+		if (bufferIndex < document.Buffers.size() && GetBufferViewRange(bufferView, document.Buffers[bufferIndex].Size, &viewOffset, &viewLength))
+		{
+			load.Data = document.Buffers[bufferIndex].Data + viewOffset;
+			load.Size = viewLength;
+		}
+	}
+	else if (DecodeDataURI(uri, &load.OwnedData))
+	{
+		load.Data = load.OwnedData.data();
+		load.Size = load.OwnedData.size();
+	}
+
+	if (load.Data == nullptr)
+		VH_WARN("Invalid image {} in {}", imageIndex, document.Path);
+
+	// Still queued when invalid, the decode fails and reports like any other broken image
+	load.Asset = handle.GetAsset();
+	outImageLoads->push_back(std::move(load));
+
+	return handle;
+}
+
+void VulkanHelper::GLTFImporter::WriteVertices(const Primitive& primitive, Mesh::DefaultVertex* outVertices)
+{
+	const AccessorView& positions = primitive.Positions;
+	const AccessorView& normals = primitive.Normals;
+	const AccessorView& texCoords = primitive.TexCoords;
+	bool floatTexCoords = texCoords.ComponentType == s_ComponentFloat;
+
+	for (uint64_t i = 0; i < positions.Count; i++)
+	{
+		Mesh::DefaultVertex& vertex = outVertices[i];
+		memcpy(&vertex.Position, positions.Data + i * positions.Stride, sizeof(glm::vec3));
+		memcpy(&vertex.Normal, normals.Data + i * normals.Stride, sizeof(glm::vec3));
+
+		if (texCoords.Count == 0)
+		{
+			vertex.TexCoord = glm::vec2(0.0f, 0.0f);
+			continue;
+		}
+
+		const uint8_t* texCoord = texCoords.Data + i * texCoords.Stride;
+		if (floatTexCoords)
+		{
+			memcpy(&vertex.TexCoord, texCoord, sizeof(glm::vec2));
+		}
+		else
+		{
+			uint32_t componentSize = texCoords.ComponentType == s_ComponentUnsignedByte ? 1 : 2;
+			vertex.TexCoord.x = ReadComponent(texCoord, texCoords.ComponentType, true);
+			vertex.TexCoord.y = ReadComponent(texCoord + componentSize, texCoords.ComponentType, true);
+		}
+
+		// Textures are loaded flipped, same as Assimp does for glTF
+		vertex.TexCoord.y = 1.0f - vertex.TexCoord.y;
+	}
+}
+
+void VulkanHelper::GLTFImporter::WriteIndices(const Primitive& primitive, uint32_t* outIndices)
+{
+	const AccessorView& indices = primitive.Indices;
+	uint64_t vertexCount = primitive.Positions.Count;
+
+	uint64_t invalidCount = 0;
+	for (uint64_t i = 0; i < indices.Count; i++)
+	{
+		const uint8_t* src = indices.Data + i * indices.Stride;
+
+		uint32_t index;
+		switch (indices.ComponentType)
+		{
+		case s_ComponentUnsignedByte: index = *src; break;
+		case s_ComponentUnsignedShort: { uint16_t value; memcpy(&value, src, sizeof(value)); index = value; break; }
+		default: memcpy(&index, src, sizeof(index)); break;
+		}
+
+		if (index >= vertexCount)
+		{
+			index = 0;
+			invalidCount++;
+		}
+
+		outIndices[i] = index;
+	}
+
+	if (invalidCount > 0)
+		VH_WARN("Primitive {} has {} out of range indices", primitive.Name, invalidCount);
+}
+
+float VulkanHelper::GLTFImporter::ReadComponent(const uint8_t* data, uint32_t componentType, bool normalized)
+{
+	switch (componentType)
+	{
+	case s_ComponentByte: { int8_t value; memcpy(&value, data, sizeof(value)); return normalized ? glm::max(value / 127.0f, -1.0f) : (float)value; }
+	case s_ComponentUnsignedByte: { uint8_t value = *data; return normalized ? value / 255.0f : (float)value; }
+	case s_ComponentShort: { int16_t value; memcpy(&value, data, sizeof(value)); return normalized ? glm::max(value / 32767.0f, -1.0f) : (float)value; }
+	case s_ComponentUnsignedShort: { uint16_t value; memcpy(&value, data, sizeof(value)); return normalized ? value / 65535.0f : (float)value; }
+	case s_ComponentUnsignedInt: { uint32_t value; memcpy(&value, data, sizeof(value)); return (float)value; }
+	default: { float value; memcpy(&value, data, sizeof(value)); return value; }
+	}
+}
+
+bool VulkanHelper::GLTFImporter::DecodeBase64(std::string_view text, std::vector<uint8_t>* outData)
+{
+	auto decodeChar = [](char c) -> int
+		{
+			if (c >= 'A' && c <= 'Z') return c - 'A';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+			if (c >= '0' && c <= '9') return c - '0' + 52;
+			if (c == '+') return 62;
+			if (c == '/') return 63;
+			return -1;
+		};
+
+	outData->clear();
+	outData->reserve(text.size() / 4 * 3);
+
+	uint32_t accumulator = 0;
+	int bits = 0;
+	for (char c : text)
+	{
+		if (c == '=')
+			break;
+
+		int value = decodeChar(c);
+		if (value < 0)
+			return false;
+
+		accumulator = (accumulator << 6) | (uint32_t)value;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			outData->push_back((uint8_t)(accumulator >> bits));
+		}
+	}
+
+	return true;
+}
+
+bool VulkanHelper::GLTFImporter::DecodeDataURI(const std::string& uri, std::vector<uint8_t>* outData)
+{
+	if (!uri.starts_with("data:"))
+		return false;
+
+	size_t dataStart = uri.find(";base64,");
+	if (dataStart == std::string::npos)
+		return false;
+
+	return DecodeBase64(std::string_view(uri).substr(dataStart + 8), outData);
+}
+
+std::string VulkanHelper::GLTFImporter::DecodeURI(const std::string& uri)
+{
+	std::string decoded;
+	decoded.reserve(uri.size());
+	for (size_t i = 0; i < uri.size(); i++)
+	{
+		unsigned int value;
+		if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16).ptr == uri.data() + i + 3)
+		{
+			decoded.push_back((char)value);
+			i += 2;
+			continue;
+		}
+
+		decoded.push_back(uri[i]);
+	}
+
+	return decoded;
+}
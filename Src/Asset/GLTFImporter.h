@@ -0,0 +1,141 @@
+#pragma once
+#include "Pch.h"
+
+#include "Asset.h"
+#include "Utility/Json.h"
+#include "Package.h"
+
+namespace VulkanHelper
+{
+	class Device;
+	class UploadBatch;
+
+	/**
+	 * @brief Native glTF 2.0 (.gltf / .glb) loader that skips Assimp's scene conversion and post processing.
+	 *
+	 * The JSON is parsed once, buffers are used straight out of the mapped file and accessor data is
+	 * converted directly into vertex and index staging memory. Files that need anything Assimp would have
+	 * to fix up (missing normals, non triangle primitives, sparse or quantized accessors, required extensions)
+	 * are rejected before any output is written, so the caller can fall back to Assimp.
+	 */
+	class GLTFImporter
+	{
+	public:
+		[[nodiscard]] static bool IsGLTF(const std::string& path);
+
+		// Same outputs as AssetImporter::ImportModel(), returns false without touching them if the file isn't supported
+		[[nodiscard]] static bool ImportModel(
+			Device* device,
+			const std::string& path,
+			std::vector<Mesh>* outMeshes,
+			std::vector<std::string>* outMeshNames,
+			std::vector<glm::mat4>* outMeshTransfrorms,
+			std::vector<Material>* outMaterials,
+			std::vector<uint32_t>* outMeshMaterialIndices,
+			std::vector<MeshInstance>* outInstances
+		);
+
+		/**
+		 * @brief Byte range of a buffer view inside a buffer of bufferSize bytes.
+		 *
+		 * Negative, fractional and out of range byteOffset / byteLength values are rejected.
+		 */
+		[[nodiscard]] static bool GetBufferViewRange(const JsonValue& bufferView, uint64_t bufferSize, uint64_t* outOffset, uint64_t* outLength);
+
+		/**
+		 * @brief Checks that count elements of elementSize bytes fit into the accessor's buffer view, same rules as GetBufferViewRange().
+		 *
+		 * outOffset is relative to the start of the buffer, outStride is elementSize for tightly packed views.
+		 */
+		[[nodiscard]] static bool GetAccessorRange(
+			const JsonValue& accessor,
+			const JsonValue& bufferView,
+			uint64_t elementSize,
+			uint64_t bufferSize,
+			uint64_t* outOffset,
+			uint64_t* outStride,
+			uint64_t* outCount
+		);
+
+	private:
+		// Byte range of a buffer, either inside a mapped file or in OwnedData
+		struct BufferData
+		{
+			const uint8_t* Data = nullptr;
+			size_t Size = 0;
+			std::vector<uint8_t> OwnedData; // Decoded data: URIs
+		};
+
+		struct Document
+		{
+			std::string Path;
+			std::string Directory;
+			AssetFile File;
+			JsonValue Json;
+			const uint8_t* BinChunk = nullptr; // GLB only
+			size_t BinChunkSize = 0;
+			std::vector<BufferData> Buffers;
+			std::vector<std::unique_ptr<AssetFile>> ExternalFiles;
+		};
+
+		// Strided view of accessor elements, already bounds checked against its buffer
+		struct AccessorView
+		{
+			const uint8_t* Data = nullptr;
+			uint64_t Count = 0;
+			uint64_t Stride = 0;
+			uint32_t ComponentType = 0;
+			uint32_t ComponentCount = 0;
+			bool Normalized = false;
+		};
+
+		struct Primitive
+		{
+			AccessorView Positions;
+			AccessorView Normals;
+			AccessorView TexCoords; // Count is 0 if the primitive has none
+			AccessorView Indices; // Count is 0 for non indexed primitives
+			int64_t Material = -1;
+			std::string Name;
+		};
+
+		// Image whose asset was created by this import and has to be decoded from the file
+		struct EmbeddedImageLoad
+		{
+			const uint8_t* Data = nullptr;
+			size_t Size = 0;
+			std::vector<uint8_t> OwnedData; // Decoded data: URIs
+			std::string Name;
+			TextureRole Role = TextureRole::Color;
+			std::shared_ptr<Asset> KeepAlive; // Holds the image until the upload is submitted
+			std::weak_ptr<Asset> Asset;
+			std::shared_ptr<std::promise<void>> Promise;
+		};
+
+		[[nodiscard]] static bool LoadDocument(const std::string& path, Document* outDocument);
+		[[nodiscard]] static bool LoadBuffers(Document* document);
+		[[nodiscard]] static bool GetAccessor(const Document& document, const JsonValue& index, AccessorView* outView);
+		[[nodiscard]] static bool GatherPrimitives(const Document& document, std::vector<Primitive>* outPrimitives, std::vector<uint32_t>* outFirstPrimitives);
+		[[nodiscard]] static bool GatherInstances(const Document& document, const std::vector<uint32_t>& firstPrimitives, uint32_t firstMesh, std::vector<MeshInstance>* outInstances);
+		static glm::mat4 GetNodeTransform(const JsonValue& node);
+
+		static Material ProcessMaterial(const Document& document, const JsonValue& material, AssetID modelID, std::vector<EmbeddedImageLoad>* outImageLoads);
+		static AssetHandle LoadMaterialTexture(
+			const Document& document,
+			const JsonValue& textureInfo,
+			TextureRole role,
+			AssetID modelID,
+			const std::string& fallbackPath,
+			std::vector<EmbeddedImageLoad>* outImageLoads
+		);
+
+		static void WriteVertices(const Primitive& primitive, Mesh::DefaultVertex* outVertices);
+		static void WriteIndices(const Primitive& primitive, uint32_t* outIndices);
+		static float ReadComponent(const uint8_t* data, uint32_t componentType, bool normalized);
+
+		static bool DecodeBase64(std::string_view text, std::vector<uint8_t>* outData);
+		// Returns false for anything that isn't a base64 data: URI
+		static bool DecodeDataURI(const std::string& uri, std::vector<uint8_t>* outData);
+		static std::string DecodeURI(const std::string& uri);
+	};
+}
@@ -0,0 +1,480 @@
+#include "Pch.h"
+#include "KTX2.h"
+
+#include <stb_image.h>
+#include <bit>
+#include <cstring>
+
+static constexpr uint8_t s_Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A }; // «KTX 20»\r\n\x1A\n
+
+// Byte offsets from the KTX2 specification
+static constexpr size_t s_HeaderSize = 80;
+static constexpr size_t s_LevelIndexEntrySize = 24;
+
+static constexpr char s_OrientationKey[] = "KTXorientation";
+
+template<typename T>
+static T ReadValue(const uint8_t* data, size_t offset)
+{
+	T value;
+	memcpy(&value, data + offset, sizeof(T));
+	return value;
+}
+
+template<typename T>
+static void WriteValue(std::vector<uint8_t>& data, size_t offset, T value)
+{
+	memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+// Reverses the first rowCount rows of rowSize bytes each, starting at data
+static void ReverseRows(uint8_t* data, uint32_t rowCount, size_t rowSize)
+{
+	for (uint32_t row = 0; row < rowCount / 2; row++)
+		std::swap_ranges(data + row * rowSize, data + (row + 1) * rowSize, data + (rowCount - 1 - row) * rowSize);
+}
+
+// BC1 color block and the color half of BC2 and BC3, 2 bit indices with one byte per row after the endpoints
+static void FlipColorBlock(uint8_t* block, uint32_t rowCount)
+{
+	ReverseRows(block + 4, rowCount, 1);
+}
+
+// BC3 alpha, BC4 and both halves of BC5, 3 bit indices with 12 bits per row after the endpoints
+static void FlipInterpolatedBlock(uint8_t* block, uint32_t rowCount)
+{
+	uint64_t indices = 0;
+	memcpy(&indices, block + 2, 6);
+
+	uint64_t flipped = indices;
+	for (uint32_t row = 0; row < rowCount; row++)
+	{
+		uint64_t bits = (indices >> (row * 12)) & 0xFFF;
+		uint32_t target = rowCount - 1 - row;
+		flipped = (flipped & ~(0xFFFull << (target * 12))) | (bits << (target * 12));
+	}
+
+	memcpy(block + 2, &flipped, 6);
+}
+
+bool VulkanHelper::KTX2::IsKTX2(const void* data, size_t size)
+{
+	return data != nullptr && size >= sizeof(s_Identifier) && memcmp(data, s_Identifier, sizeof(s_Identifier)) == 0;
+}
+
+bool VulkanHelper::KTX2::Parse(const void* data, size_t size, Info* outInfo, std::string* outError)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	if (!IsKTX2(data, size) || size < s_HeaderSize)
+	{
+		*outError = "Not a KTX2 file";
+		return false;
+	}
+
+	outInfo->Format = (VkFormat)ReadValue<uint32_t>(bytes, 12);
+	outInfo->Width = ReadValue<uint32_t>(bytes, 20);
+	outInfo->Height = std::max(ReadValue<uint32_t>(bytes, 24), 1u); // 0 for 1D textures
+	uint32_t depth = ReadValue<uint32_t>(bytes, 28);
+	outInfo->LayerCount = std::max(ReadValue<uint32_t>(bytes, 32), 1u);
+	outInfo->FaceCount = ReadValue<uint32_t>(bytes, 36);
+	outInfo->LevelCount = std::max(ReadValue<uint32_t>(bytes, 40), 1u); // 0 asks the loader to generate mips, only the base level is stored then
+	outInfo->Supercompression = (SupercompressionScheme)ReadValue<uint32_t>(bytes, 44);
+
+	if (outInfo->Format == VK_FORMAT_UNDEFINED)
+	{
+		*outError = "Basis Universal payloads have to be transcoded, which isn't supported";
+		return false;
+	}
+
+	if (depth > 1)
+	{
+		*outError = "3D textures aren't supported";
+		return false;
+	}
+
+	if (outInfo->Width == 0 || (outInfo->FaceCount != 1 && outInfo->FaceCount != 6))
+	{
+		*outError = "Invalid extent or face count";
+		return false;
+	}
+
+	// A full mip chain ends at 1x1, more levels than that would shift the extent by 32 or more bits below
+	uint32_t maxLevelCount = (uint32_t)std::bit_width(std::max(outInfo->Width, outInfo->Height));
+	if (outInfo->LevelCount > maxLevelCount)
+	{
+		*outError = "Level count " + std::to_string(outInfo->LevelCount) + " exceeds the full mip chain of " + std::to_string(maxLevelCount);
+		return false;
+	}
+
+	if (outInfo->Supercompression != SupercompressionScheme::None && outInfo->Supercompression != SupercompressionScheme::ZLIB)
+	{
+		*outError = "Unsupported supercompression scheme " + std::to_string((uint32_t)outInfo->Supercompression);
+		return false;
+	}
+
+	uint32_t blockWidth, blockHeight, blockSize;
+	if (!GetBlockInfo(outInfo->Format, &blockWidth, &blockHeight, &blockSize))
+	{
+		*outError = "Unsupported format " + std::to_string((uint32_t)outInfo->Format);
+		return false;
+	}
+
+	if (size < s_HeaderSize + (uint64_t)outInfo->LevelCount * s_LevelIndexEntrySize)
+	{
+		*outError = "Truncated level index";
+		return false;
+	}
+
+	// Key/value data, every entry is its uint32_t length, a null terminated key and the value, padded to 4 bytes
+	uint64_t kvdOffset = ReadValue<uint32_t>(bytes, 56);
+	uint64_t kvdSize = ReadValue<uint32_t>(bytes, 60);
+	if (kvdOffset > size || kvdSize > size - kvdOffset)
+	{
+		*outError = "Key/value data lies outside of the file";
+		return false;
+	}
+
+	outInfo->TopDown = true;
+	for (uint64_t offset = 0; offset + 4 <= kvdSize;)
+	{
+		uint32_t entrySize = ReadValue<uint32_t>(bytes, (size_t)(kvdOffset + offset));
+		offset += 4;
+		if (entrySize > kvdSize - offset)
+		{
+			*outError = "Truncated key/value data";
+			return false;
+		}
+
+		std::string_view entry((const char*)bytes + kvdOffset + offset, entrySize);
+		if (entry.size() > sizeof(s_OrientationKey) && entry.starts_with(std::string_view(s_OrientationKey, sizeof(s_OrientationKey))))
+		{
+			// Value is one letter per dimension, "r" or "l" for x, "d" or "u" for y
+			std::string_view value = entry.substr(sizeof(s_OrientationKey));
+			outInfo->TopDown = value.size() < 2 || value[1] != 'u';
+		}
+
+		offset = (offset + entrySize + 3) & ~3ull;
+	}
+
+	uint64_t subresourceCount = (uint64_t)outInfo->LayerCount * outInfo->FaceCount;
+	outInfo->Levels.resize(outInfo->LevelCount);
+	for (uint32_t i = 0; i < outInfo->LevelCount; i++)
+	{
+		size_t entry = s_HeaderSize + (size_t)i * s_LevelIndexEntrySize;
+		Level& level = outInfo->Levels[i];
+		level.Offset = ReadValue<uint64_t>(bytes, entry);
+		level.Size = ReadValue<uint64_t>(bytes, entry + 8);
+		level.UncompressedSize = ReadValue<uint64_t>(bytes, entry + 16);
+
+		uint32_t width = std::max(outInfo->Width >> i, 1u);
+		uint32_t height = std::max(outInfo->Height >> i, 1u);
+		uint64_t expectedSize = GetImageSize(outInfo->Format, width, height) * subresourceCount;
+
+		if (level.Offset > size || level.Size > size - level.Offset)
+		{
+			*outError = "Level " + std::to_string(i) + " lies outside of the file";
+			return false;
+		}
+
+		if (outInfo->Supercompression == SupercompressionScheme::None)
+			level.UncompressedSize = level.Size;
+
+		if (level.UncompressedSize != expectedSize)
+		{
+			*outError = "Level " + std::to_string(i) + " has " + std::to_string(level.UncompressedSize) + " bytes, expected " + std::to_string(expectedSize);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool VulkanHelper::KTX2::Write(VkFormat format, uint32_t width, uint32_t height, std::span<const std::vector<uint8_t>> levels, bool topDown, std::vector<uint8_t>* outData)
+{
+	uint32_t channelCount;
+	switch (format)
+	{
+	case VK_FORMAT_R8_UNORM: channelCount = 1; break;
+	case VK_FORMAT_R8G8_UNORM: channelCount = 2; break;
+	case VK_FORMAT_R8G8B8A8_UNORM: channelCount = 4; break;
+	default: return false;
+	}
+
+	if (levels.empty() || width == 0 || height == 0)
+		return false;
+
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		if (levels[i].size() != GetImageSize(format, std::max(width >> i, 1u), std::max(height >> i, 1u)))
+			return false;
+	}
+
+	// Basic data format descriptor, one 8 bit sample per channel
+	static constexpr uint32_t s_ChannelIDs[4] = { 0, 1, 2, 15 }; // R, G, B, A of KHR_DF_MODEL_RGBSDA
+	uint32_t descriptorBlockSize = 24 + 16 * channelCount;
+	uint32_t dfdSize = 4 + descriptorBlockSize;
+
+	// A single KTXorientation entry, the value is null terminated as well
+	const char* orientation = topDown ? "rd" : "ru";
+	uint32_t orientationEntrySize = (uint32_t)sizeof(s_OrientationKey) + 3;
+	uint32_t kvdSize = 4 + ((orientationEntrySize + 3) & ~3u);
+
+	size_t dfdOffset = s_HeaderSize + levels.size() * s_LevelIndexEntrySize;
+	size_t kvdOffset = (dfdOffset + dfdSize + 3) & ~(size_t)3;
+	size_t dataOffset = kvdOffset + kvdSize;
+
+	// Levels are stored smallest first, every one aligned to 4 bytes
+	std::vector<size_t> levelOffsets(levels.size());
+	size_t fileSize = dataOffset;
+	for (size_t i = levels.size(); i > 0; i--)
+	{
+		fileSize = (fileSize + 3) & ~(size_t)3;
+		levelOffsets[i - 1] = fileSize;
+		fileSize += levels[i - 1].size();
+	}
+
+	std::vector<uint8_t>& data = *outData;
+	data.assign(fileSize, 0);
+
+	memcpy(data.data(), s_Identifier, sizeof(s_Identifier));
+	WriteValue<uint32_t>(data, 12, (uint32_t)format);
+	WriteValue<uint32_t>(data, 16, 1); // typeSize
+	WriteValue<uint32_t>(data, 20, width);
+	WriteValue<uint32_t>(data, 24, height);
+	WriteValue<uint32_t>(data, 28, 0); // depth
+	WriteValue<uint32_t>(data, 32, 0); // layers, 0 for non array textures
+	WriteValue<uint32_t>(data, 36, 1); // faces
+	WriteValue<uint32_t>(data, 40, (uint32_t)levels.size());
+	WriteValue<uint32_t>(data, 44, (uint32_t)SupercompressionScheme::None);
+	WriteValue<uint32_t>(data, 48, (uint32_t)dfdOffset);
+	WriteValue<uint32_t>(data, 52, dfdSize);
+	WriteValue<uint32_t>(data, 56, (uint32_t)kvdOffset);
+	WriteValue<uint32_t>(data, 60, kvdSize);
+	// No supercompression global data, offset and length stay 0
+
+	WriteValue<uint32_t>(data, kvdOffset, orientationEntrySize);
+	memcpy(data.data() + kvdOffset + 4, s_OrientationKey, sizeof(s_OrientationKey));
+	memcpy(data.data() + kvdOffset + 4 + sizeof(s_OrientationKey), orientation, 3);
+
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		size_t entry = s_HeaderSize + i * s_LevelIndexEntrySize;
+		WriteValue<uint64_t>(data, entry, levelOffsets[i]);
+		WriteValue<uint64_t>(data, entry + 8, levels[i].size());
+		WriteValue<uint64_t>(data, entry + 16, levels[i].size());
+		memcpy(data.data() + levelOffsets[i], levels[i].data(), levels[i].size());
+	}
+
+	WriteValue<uint32_t>(data, dfdOffset, dfdSize);
+	WriteValue<uint32_t>(data, dfdOffset + 4, 0); // Khronos vendor, basic descriptor type
+	WriteValue<uint32_t>(data, dfdOffset + 8, 2 | (descriptorBlockSize << 16)); // Version 1.3
+	WriteValue<uint32_t>(data, dfdOffset + 12, 1 | (1 << 8) | (1 << 16)); // RGBSDA, BT.709 primaries, linear transfer
+	WriteValue<uint32_t>(data, dfdOffset + 16, 0); // 1x1x1x1 texel block
+	WriteValue<uint32_t>(data, dfdOffset + 20, channelCount); // Bytes in plane 0
+	WriteValue<uint32_t>(data, dfdOffset + 24, 0);
+	for (uint32_t c = 0; c < channelCount; c++)
+	{
+		size_t sample = dfdOffset + 28 + (size_t)c * 16;
+		uint32_t channelID = channelCount == 4 ? s_ChannelIDs[c] : c;
+		WriteValue<uint32_t>(data, sample, (c * 8) | (7 << 16) | (channelID << 24)); // Bit offset, length - 1, channel
+		WriteValue<uint32_t>(data, sample + 4, 0);
+		WriteValue<uint32_t>(data, sample + 8, 0);
+		WriteValue<uint32_t>(data, sample + 12, 255);
+	}
+
+	return true;
+}
+
+bool VulkanHelper::KTX2::DecompressLevel(const Info& info, const void* fileData, const Level& level, void* outData)
+{
+	const char* src = (const char*)fileData + level.Offset;
+
+	switch (info.Supercompression)
+	{
+	case SupercompressionScheme::None:
+		memcpy(outData, src, level.Size);
+		return true;
+	case SupercompressionScheme::ZLIB:
+	{
+		// stb_image's inflate takes int sizes
+		if (level.Size > INT32_MAX || level.UncompressedSize > INT32_MAX)
+			return false;
+
+		int written = stbi_zlib_decode_buffer((char*)outData, (int)level.UncompressedSize, src, (int)level.Size);
+		return written == (int)level.UncompressedSize;
+	}
+	default:
+		return false;
+	}
+}
+
+bool VulkanHelper::KTX2::CanFlipVertically(const Info& info)
+{
+	uint32_t blockWidth, blockHeight, blockSize;
+	if (!GetBlockInfo(info.Format, &blockWidth, &blockHeight, &blockSize))
+		return false;
+
+	if (blockHeight == 1)
+		return true;
+
+	if (info.Format < VK_FORMAT_BC1_RGB_UNORM_BLOCK || info.Format > VK_FORMAT_BC5_SNORM_BLOCK)
+		return false;
+
+	// Flipping a partially filled last row of blocks would have to move texels across blocks
+	for (uint32_t level = 0; level < info.LevelCount; level++)
+	{
+		uint32_t height = std::max(info.Height >> level, 1u);
+		if (height > blockHeight && height % blockHeight != 0)
+			return false;
+	}
+
+	return true;
+}
+
+void VulkanHelper::KTX2::FlipVertically(const Info& info, uint32_t level, void* levelData)
+{
+	uint32_t blockWidth, blockHeight, blockSize;
+	if (!GetBlockInfo(info.Format, &blockWidth, &blockHeight, &blockSize))
+		return;
+
+	uint32_t width = std::max(info.Width >> level, 1u);
+	uint32_t height = std::max(info.Height >> level, 1u);
+	uint32_t blocksX = (width + blockWidth - 1) / blockWidth;
+	uint32_t blocksY = (height + blockHeight - 1) / blockHeight;
+	uint32_t rowsPerBlock = std::min(height, blockHeight);
+	size_t rowSize = (size_t)blocksX * blockSize;
+	size_t imageSize = rowSize * blocksY;
+
+	uint8_t* image = (uint8_t*)levelData;
+	for (uint64_t i = 0; i < (uint64_t)info.LayerCount * info.FaceCount; i++, image += imageSize)
+	{
+		ReverseRows(image, blocksY, rowSize);
+		if (blockHeight == 1)
+			continue;
+
+		// Texels inside every block have to be flipped as well
+		for (size_t block = 0; block < (size_t)blocksX * blocksY; block++)
+		{
+			uint8_t* data = image + block * blockSize;
+			switch (info.Format)
+			{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+				FlipColorBlock(data, rowsPerBlock);
+				break;
+			case VK_FORMAT_BC2_UNORM_BLOCK:
+			case VK_FORMAT_BC2_SRGB_BLOCK:
+				ReverseRows(data, rowsPerBlock, 2); // Explicit 4 bit alpha, 2 bytes per row
+				FlipColorBlock(data + 8, rowsPerBlock);
+				break;
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+				FlipInterpolatedBlock(data, rowsPerBlock);
+				FlipColorBlock(data + 8, rowsPerBlock);
+				break;
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+			case VK_FORMAT_BC4_SNORM_BLOCK:
+				FlipInterpolatedBlock(data, rowsPerBlock);
+				break;
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC5_SNORM_BLOCK:
+				FlipInterpolatedBlock(data, rowsPerBlock);
+				FlipInterpolatedBlock(data + 8, rowsPerBlock);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+bool VulkanHelper::KTX2::GetBlockInfo(VkFormat format, uint32_t* outBlockWidth, uint32_t* outBlockHeight, uint32_t* outBlockSize)
+{
+	*outBlockWidth = 1;
+	*outBlockHeight = 1;
+
+	switch (format)
+	{
+	case VK_FORMAT_R8_UNORM:
+	case VK_FORMAT_R8_SRGB:
+		*outBlockSize = 1;
+		return true;
+	case VK_FORMAT_R8G8_UNORM:
+	case VK_FORMAT_R8G8_SRGB:
+	case VK_FORMAT_R16_SFLOAT:
+	case VK_FORMAT_R16_UNORM:
+		*outBlockSize = 2;
+		return true;
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+	case VK_FORMAT_B8G8R8A8_SRGB:
+	case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+	case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+	case VK_FORMAT_R16G16_SFLOAT:
+	case VK_FORMAT_R32_SFLOAT:
+		*outBlockSize = 4;
+		return true;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+	case VK_FORMAT_R16G16B16A16_UNORM:
+	case VK_FORMAT_R32G32_SFLOAT:
+		*outBlockSize = 8;
+		return true;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		*outBlockSize = 16;
+		return true;
+	default:
+		break;
+	}
+
+	// BC1 and BC4 use 8 byte blocks, every other BCn format 16
+	if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK)
+	{
+		bool smallBlock = format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC4_UNORM_BLOCK || format == VK_FORMAT_BC4_SNORM_BLOCK;
+		*outBlockWidth = 4;
+		*outBlockHeight = 4;
+		*outBlockSize = smallBlock ? 8 : 16;
+		return true;
+	}
+
+	// ETC2 RGB, RGB A1 and EAC R11 use 8 byte blocks
+	if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK)
+	{
+		bool smallBlock = format <= VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK || format == VK_FORMAT_EAC_R11_UNORM_BLOCK || format == VK_FORMAT_EAC_R11_SNORM_BLOCK;
+		*outBlockWidth = 4;
+		*outBlockHeight = 4;
+		*outBlockSize = smallBlock ? 8 : 16;
+		return true;
+	}
+
+	// ASTC LDR formats come in UNORM / SRGB pairs, every block is 16 bytes
+	if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+	{
+		static constexpr uint32_t s_ASTCBlocks[14][2] = {
+			{ 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+			{ 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+		};
+
+		uint32_t index = ((uint32_t)format - (uint32_t)VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2;
+		*outBlockWidth = s_ASTCBlocks[index][0];
+		*outBlockHeight = s_ASTCBlocks[index][1];
+		*outBlockSize = 16;
+		return true;
+	}
+
+	return false;
+}
+
+uint64_t VulkanHelper::KTX2::GetImageSize(VkFormat format, uint32_t width, uint32_t height)
+{
+	uint32_t blockWidth, blockHeight, blockSize;
+	if (!GetBlockInfo(format, &blockWidth, &blockHeight, &blockSize))
+		return 0;
+
+	uint64_t blocksX = (width + blockWidth - 1) / blockWidth;
+	uint64_t blocksY = (height + blockHeight - 1) / blockHeight;
+	return blocksX * blocksY * blockSize;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Pch.h"
+
+#include "vulkan/vulkan_core.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Reader for KTX2 texture containers.
+	 *
+	 * Only parses and validates the header and level index, texel data stays in the caller's buffer.
+	 * Every level stores all array layers and cube faces tightly packed, which is exactly what a single
+	 * VkBufferImageCopy per level expects.
+	 */
+	class KTX2
+	{
+	public:
+		enum class SupercompressionScheme : uint32_t
+		{
+			None = 0,
+			BasisLZ = 1,
+			Zstandard = 2,
+			ZLIB = 3,
+		};
+
+		struct Level
+		{
+			uint64_t Offset = 0; // From the start of the file
+			uint64_t Size = 0; // Stored size, compressed if the file is supercompressed
+			uint64_t UncompressedSize = 0;
+		};
+
+		struct Info
+		{
+			VkFormat Format = VK_FORMAT_UNDEFINED;
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			uint32_t LayerCount = 1; // Array layers, 1 for non array textures
+			uint32_t FaceCount = 1; // 6 for cube maps
+			uint32_t LevelCount = 1;
+			SupercompressionScheme Supercompression = SupercompressionScheme::None;
+			bool TopDown = true; // From the KTXorientation key, the first row is the top one unless it says "ru"
+			std::vector<Level> Levels; // Level 0 is the full resolution image
+		};
+
+		[[nodiscard]] static bool IsKTX2(const void* data, size_t size);
+
+		/**
+		 * @brief Parses the header and level index and checks that every level lies inside the file and has the size its format and extent require.
+		 */
+		[[nodiscard]] static bool Parse(const void* data, size_t size, Info* outInfo, std::string* outError);
+
+		/**
+		 * @brief Builds a file holding a single 2D image and its mip chain, levels[0] is the full resolution.
+		 *
+		 * Only 8 bit UNORM formats with 1, 2 or 4 channels are supported, stored without supercompression. The row
+		 * order is recorded in the KTXorientation key, "rd" for topDown and "ru" otherwise.
+		 */
+		[[nodiscard]] static bool Write(VkFormat format, uint32_t width, uint32_t height, std::span<const std::vector<uint8_t>> levels, bool topDown, std::vector<uint8_t>* outData);
+
+		// Decompresses a supercompressed level, outData has to hold level.UncompressedSize bytes
+		[[nodiscard]] static bool DecompressLevel(const Info& info, const void* fileData, const Level& level, void* outData);
+
+		/**
+		 * @brief False if FlipVertically() can't flip every level of the texture exactly.
+		 *
+		 * Uncompressed formats always can. Of the block compressed ones only BC1 to BC5, whose texel indices are stored
+		 * per row, and only if every level's height is a multiple of the block height or fits into a single block.
+		 */
+		[[nodiscard]] static bool CanFlipVertically(const Info& info);
+
+		// Flips every layer and face of a decompressed level upside down in place, check CanFlipVertically() first
+		static void FlipVertically(const Info& info, uint32_t level, void* levelData);
+
+		// False for formats whose block layout isn't known
+		[[nodiscard]] static bool GetBlockInfo(VkFormat format, uint32_t* outBlockWidth, uint32_t* outBlockHeight, uint32_t* outBlockSize);
+		// Bytes of a single layer and face of the given extent
+		[[nodiscard]] static uint64_t GetImageSize(VkFormat format, uint32_t width, uint32_t height);
+	};
+}
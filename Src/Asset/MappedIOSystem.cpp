@@ -0,0 +1,93 @@
+#include "Pch.h"
+#include "MappedIOSystem.h"
+
+#include "AssetManager.h"
+
+#include <cstring>
+
+size_t VulkanHelper::MappedIOStream::Read(void* buffer, size_t size, size_t count)
+{
+	if (size == 0 || count == 0)
+		return 0;
+
+	// Same as fread, only whole elements are read
+	size_t available = (m_File.Size - m_Position) / size;
+	count = std::min(count, available);
+
+	memcpy(buffer, m_File.Data + m_Position, size * count);
+	m_Position += size * count;
+
+	return count;
+}
+
+size_t VulkanHelper::MappedIOStream::Write(const void* buffer, size_t size, size_t count)
+{
+	return 0;
+}
+
+aiReturn VulkanHelper::MappedIOStream::Seek(size_t offset, aiOrigin origin)
+{
+	size_t position;
+	switch (origin)
+	{
+	case aiOrigin_SET:
+		position = offset;
+		break;
+	case aiOrigin_CUR:
+		position = m_Position + offset;
+		break;
+	case aiOrigin_END:
+		position = m_File.Size - offset;
+		break;
+	default:
+		return aiReturn_FAILURE;
+	}
+
+	if (position > m_File.Size)
+		return aiReturn_FAILURE;
+
+	m_Position = position;
+	return aiReturn_SUCCESS;
+}
+
+size_t VulkanHelper::MappedIOStream::Tell() const
+{
+	return m_Position;
+}
+
+size_t VulkanHelper::MappedIOStream::FileSize() const
+{
+	return m_File.Size;
+}
+
+void VulkanHelper::MappedIOStream::Flush()
+{
+}
+
+bool VulkanHelper::MappedIOSystem::Exists(const char* file) const
+{
+	return AssetManager::FileExists(file);
+}
+
+char VulkanHelper::MappedIOSystem::getOsSeparator() const
+{
+	return '/';
+}
+
+Assimp::IOStream* VulkanHelper::MappedIOSystem::Open(const char* file, const char* mode /*= "rb"*/)
+{
+	// Writing isn't supported
+	if (strchr(mode, 'w') || strchr(mode, 'a') || strchr(mode, '+'))
+		return nullptr;
+
+	AssetFile assetFile;
+	if (!AssetManager::OpenFile(file, &assetFile))
+		return nullptr;
+
+	return new MappedIOStream(std::move(assetFile));
+}
+
+void VulkanHelper::MappedIOSystem::Close(Assimp::IOStream* file)
+{
+	delete file;
+}
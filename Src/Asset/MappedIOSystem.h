@@ -0,0 +1,48 @@
+#pragma once
+#include "Pch.h"
+
+#include "Package.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+namespace VulkanHelper
+{
+	// Read only Assimp stream reading straight out of a memory mapped file or mounted package
+	class MappedIOStream : public Assimp::IOStream
+	{
+	public:
+		MappedIOStream(AssetFile&& file) : m_File(std::move(file)) {}
+		~MappedIOStream() override = default;
+
+		size_t Read(void* buffer, size_t size, size_t count) override;
+		size_t Write(const void* buffer, size_t size, size_t count) override;
+		aiReturn Seek(size_t offset, aiOrigin origin) override;
+		size_t Tell() const override;
+		size_t FileSize() const override;
+		void Flush() override;
+
+	private:
+		AssetFile m_File;
+		size_t m_Position = 0;
+	};
+
+	/**
+	 * @brief Assimp IOSystem that maps files instead of reading them through stdio.
+	 *
+	 * Files are opened through AssetManager::OpenFile(), so models and their dependencies can come from mounted packages.
+	 *
+	 * Only supports reading, opening a file for writing fails.
+	 */
+	class MappedIOSystem : public Assimp::IOSystem
+	{
+	public:
+		MappedIOSystem() = default;
+		~MappedIOSystem() override = default;
+
+		bool Exists(const char* file) const override;
+		char getOsSeparator() const override;
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override;
+		void Close(Assimp::IOStream* file) override;
+	};
+}
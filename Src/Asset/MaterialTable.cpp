@@ -0,0 +1,166 @@
+#include "Pch.h"
+#include "MaterialTable.h"
+
+#include "Logger/Logger.h"
+
+VulkanHelper::ResultCode VulkanHelper::MaterialTable::Init(const CreateInfo& createInfo)
+{
+	m_Device = createInfo.Device;
+	m_MaxMaterials = createInfo.MaxMaterials;
+
+	m_Materials.clear();
+	m_DirtyRanges.clear();
+	m_Textures.clear();
+	m_TextureIndices.clear();
+
+	Buffer::CreateInfo bufferInfo{};
+	bufferInfo.Device = m_Device;
+	bufferInfo.BufferSize = (VkDeviceSize)m_MaxMaterials * sizeof(GPUMaterial);
+	bufferInfo.MemoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	bufferInfo.UsageFlags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	return m_Buffer.Init(bufferInfo);
+}
+
+uint32_t VulkanHelper::MaterialTable::AddMaterial(const Material& material)
+{
+	// Flush() would copy past the end of the buffer otherwise
+	if (m_Materials.size() >= m_MaxMaterials)
+	{
+		VH_ERROR("Material table is full, increase MaxMaterials! Max: {}", m_MaxMaterials);
+		return UINT32_MAX;
+	}
+
+	uint32_t index = (uint32_t)m_Materials.size();
+	m_Materials.push_back(ToGPUMaterial(material));
+	MarkDirty(index);
+
+	return index;
+}
+
+uint32_t VulkanHelper::MaterialTable::AddModel(const ModelAsset* model)
+{
+	if (model->Materials.size() > m_MaxMaterials - m_Materials.size())
+	{
+		VH_ERROR("Material table has no room for {} more materials, increase MaxMaterials! Max: {}", model->Materials.size(), m_MaxMaterials);
+		return UINT32_MAX;
+	}
+
+	uint32_t firstIndex = (uint32_t)m_Materials.size();
+	for (const Material& material : model->Materials)
+	{
+		(void)AddMaterial(material);
+	}
+
+	return firstIndex;
+}
+
+void VulkanHelper::MaterialTable::SetMaterial(uint32_t index, const Material& material)
+{
+	VH_ASSERT(index < m_Materials.size(), "Material index out of range!");
+
+	m_Materials[index] = ToGPUMaterial(material);
+	MarkDirty(index);
+}
+
+VulkanHelper::ResultCode VulkanHelper::MaterialTable::Flush(VkCommandBuffer cmd)
+{
+	if (m_DirtyRanges.empty())
+		return ResultCode::Success;
+
+	// Merge overlapping and touching ranges so every contiguous edit becomes a single copy
+	std::sort(m_DirtyRanges.begin(), m_DirtyRanges.end(), [](const Range& a, const Range& b) { return a.First < b.First; });
+
+	std::vector<Range> merged;
+	merged.push_back(m_DirtyRanges[0]);
+	for (size_t i = 1; i < m_DirtyRanges.size(); i++)
+	{
+		Range& last = merged.back();
+		const Range& range = m_DirtyRanges[i];
+		if (range.First <= last.First + last.Count)
+			last.Count = std::max(last.First + last.Count, range.First + range.Count) - last.First;
+		else
+			merged.push_back(range);
+	}
+
+	for (const Range& range : merged)
+	{
+		// Staging buffers go through the DeleteQueue so they outlive the frame that reads them
+		ResultCode res = m_Buffer.WriteToBuffer(
+			&m_Materials[range.First],
+			(VkDeviceSize)range.Count * sizeof(GPUMaterial),
+			(VkDeviceSize)range.First * sizeof(GPUMaterial),
+			cmd
+		);
+
+		if (res != ResultCode::Success)
+			return res;
+	}
+
+	m_Buffer.Barrier(
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT,
+		cmd
+	);
+
+	m_DirtyRanges.clear();
+
+	return ResultCode::Success;
+}
+
+VulkanHelper::GPUMaterial VulkanHelper::MaterialTable::ToGPUMaterial(const Material& material)
+{
+	GPUMaterial gpuMaterial{};
+	gpuMaterial.Color = material.Color;
+	gpuMaterial.EmissiveColor = material.EmissiveColor;
+	gpuMaterial.MediumColor = material.MediumColor;
+	gpuMaterial.Metallic = material.Metallic;
+	gpuMaterial.Roughness = material.Roughness;
+	gpuMaterial.SpecularTint = material.SpecularTint;
+	gpuMaterial.Ior = material.Ior;
+	gpuMaterial.Transparency = material.Transparency;
+	gpuMaterial.MediumDensity = material.MediumDensity;
+	gpuMaterial.MediumAnisotropy = material.MediumAnisotropy;
+	gpuMaterial.Anisotropy = material.Anisotropy;
+	gpuMaterial.AnisotropyRotation = material.AnisotropyRotation;
+	gpuMaterial.AlbedoTexture = GetTextureIndex(material.AlbedoTexture);
+	gpuMaterial.NormalTexture = GetTextureIndex(material.NormalTexture);
+	gpuMaterial.RoughnessTexture = GetTextureIndex(material.RoughnessTexture);
+	gpuMaterial.MetallnessTexture = GetTextureIndex(material.MetallnessTexture);
+
+	return gpuMaterial;
+}
+
+uint32_t VulkanHelper::MaterialTable::GetTextureIndex(const AssetHandle& texture)
+{
+	// Material without a texture
+	if (texture.GetID() == 0)
+		return UINT32_MAX;
+
+	auto iter = m_TextureIndices.find(texture.GetID());
+	if (iter != m_TextureIndices.end())
+		return iter->second;
+
+	uint32_t index = (uint32_t)m_Textures.size();
+	m_Textures.push_back(texture);
+	m_TextureIndices[texture.GetID()] = index;
+
+	return index;
+}
+
+void VulkanHelper::MaterialTable::MarkDirty(uint32_t index)
+{
+	// Extending the last range keeps the list short for the common case of adding materials one after another
+	if (!m_DirtyRanges.empty())
+	{
+		Range& last = m_DirtyRanges.back();
+		if (index >= last.First && index <= last.First + last.Count)
+		{
+			last.Count = std::max(last.Count, index - last.First + 1);
+			return;
+		}
+	}
+
+	m_DirtyRanges.push_back({ index, 1 });
+}
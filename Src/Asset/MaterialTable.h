@@ -0,0 +1,86 @@
+#pragma once
+#include "Pch.h"
+
+#include "Vulkan/ErrorCodes.h"
+#include "Vulkan/Buffer.h"
+#include "Asset.h"
+
+namespace VulkanHelper
+{
+	class Device;
+
+	/**
+	 * @brief Device local array of GPUMaterial records that shaders index into instead of binding descriptors per draw.
+	 *
+	 * A CPU copy is kept next to the buffer, edits only mark ranges dirty and Flush() uploads just those ranges.
+	 * Textures referenced by materials are collected into a deduplicated list, GPUMaterial texture fields
+	 * are indices into that list so it can be bound as a bindless texture array.
+	 */
+	class MaterialTable
+	{
+	public:
+		struct CreateInfo
+		{
+			Device* Device = nullptr;
+			uint32_t MaxMaterials = 1024;
+		};
+
+		[[nodiscard]] ResultCode Init(const CreateInfo& createInfo);
+		MaterialTable() = default;
+		~MaterialTable() = default;
+
+		MaterialTable(const MaterialTable& other) = delete;
+		MaterialTable& operator=(const MaterialTable& other) = delete;
+		MaterialTable(MaterialTable&& other) = delete;
+		MaterialTable& operator=(MaterialTable&& other) = delete;
+
+	public:
+
+		// Returns the index of the new material in the table, UINT32_MAX if the table is full
+		[[nodiscard]] uint32_t AddMaterial(const Material& material);
+
+		/**
+		 * @brief Adds every unique material of the model, nothing is added if they don't all fit.
+		 *
+		 * @return Index of the first added material, material of mesh i is at returned index + model->MeshMaterialIndices[i].
+		 * UINT32_MAX if the table doesn't have room for the model.
+		 */
+		[[nodiscard]] uint32_t AddModel(const ModelAsset* model);
+
+		void SetMaterial(uint32_t index, const Material& material);
+
+		/**
+		 * @brief Records uploads of all ranges changed since the last flush followed by a barrier for shader reads.
+		 *
+		 * Has to be recorded outside of a render pass. Does nothing if nothing changed.
+		 */
+		[[nodiscard]] ResultCode Flush(VkCommandBuffer cmd);
+
+		[[nodiscard]] inline Buffer* GetBuffer() { return &m_Buffer; }
+		[[nodiscard]] inline uint32_t GetMaterialCount() const { return (uint32_t)m_Materials.size(); }
+		[[nodiscard]] inline const GPUMaterial& GetMaterial(uint32_t index) const { return m_Materials[index]; }
+		[[nodiscard]] inline const std::vector<AssetHandle>& GetTextures() const { return m_Textures; }
+		[[nodiscard]] inline bool IsDirty() const { return !m_DirtyRanges.empty(); }
+
+	private:
+		struct Range
+		{
+			uint32_t First;
+			uint32_t Count;
+		};
+
+		GPUMaterial ToGPUMaterial(const Material& material);
+		uint32_t GetTextureIndex(const AssetHandle& texture);
+		void MarkDirty(uint32_t index);
+
+		Device* m_Device = nullptr;
+		Buffer m_Buffer;
+		uint32_t m_MaxMaterials = 0;
+
+		std::vector<GPUMaterial> m_Materials;
+		std::vector<Range> m_DirtyRanges;
+
+		std::vector<AssetHandle> m_Textures;
+		std::unordered_map<AssetID, uint32_t> m_TextureIndices;
+	};
+}
@@ -0,0 +1,163 @@
+#include "Pch.h"
+#include "Package.h"
+
+#include "Logger/Logger.h"
+#include "Utility/LZ4.h"
+
+#include <cstring>
+
+bool VulkanHelper::Package::Open(const std::string& path)
+{
+	m_Path = path;
+	if (!m_File.Open(path) || m_File.GetSize() < sizeof(Header))
+		return false;
+
+	Header header;
+	memcpy(&header, m_File.GetData(), sizeof(Header));
+	if (header.Magic != s_Magic || header.Version != s_Version)
+	{
+		VH_WARN("{} is not a version {} package", path, s_Version);
+		return false;
+	}
+
+	uint64_t size = m_File.GetSize();
+	if (header.EntriesOffset % alignof(Entry) != 0 || header.EntriesOffset > size || header.EntryCount > (size - header.EntriesOffset) / sizeof(Entry))
+	{
+		VH_WARN("Package {} has an invalid table of contents", path);
+		return false;
+	}
+
+	// The mapping is page aligned, so the table can be used in place
+	m_Entries = std::span<const Entry>((const Entry*)(m_File.GetData() + header.EntriesOffset), (size_t)header.EntryCount);
+
+	// Find() binary searches the table, on an unsorted one it would miss entries that are there
+	if (!std::is_sorted(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b) { return a.ID < b.ID; }))
+	{
+		VH_WARN("Package {} has a table of contents that isn't sorted by ID", path);
+		m_Entries = {};
+		return false;
+	}
+
+	for (const Entry& entry : m_Entries)
+	{
+		if (entry.Offset > size || entry.StoredSize > size - entry.Offset)
+		{
+			VH_WARN("Package {} has an entry outside of the file", path);
+			m_Entries = {};
+			return false;
+		}
+
+		// Uncompressed entries are read and mapped with Size, so it can't be allowed to run past the stored bytes
+		if (!(entry.Flags & EntryFlagCompressed) && entry.Size != entry.StoredSize)
+		{
+			VH_WARN("Package {} has an uncompressed entry whose size doesn't match its stored size", path);
+			m_Entries = {};
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const VulkanHelper::Package::Entry* VulkanHelper::Package::Find(AssetID id) const
+{
+	auto iter = std::lower_bound(m_Entries.begin(), m_Entries.end(), id, [](const Entry& entry, AssetID id) { return entry.ID < id; });
+	if (iter == m_Entries.end() || iter->ID != id)
+		return nullptr;
+
+	return &*iter;
+}
+
+bool VulkanHelper::Package::Read(const Entry& entry, void* outData) const
+{
+	if (entry.Flags & EntryFlagCompressed)
+		return LZ4::Decompress(GetStoredData(entry), entry.StoredSize, outData, entry.Size);
+
+	memcpy(outData, GetStoredData(entry), entry.Size);
+	return true;
+}
+
+void VulkanHelper::PackageWriter::AddFile(const std::string& path, std::vector<uint8_t> data, bool compress /*= true*/)
+{
+	File file;
+	file.Path = path;
+	file.Entry.ID = AssetManager::GetAssetID(path);
+	file.Entry.Size = data.size();
+
+	if (compress && !data.empty())
+	{
+		std::vector<uint8_t> compressed(LZ4::CompressBound(data.size()));
+		size_t compressedSize = LZ4::Compress(data.data(), data.size(), compressed.data());
+
+		// Stored entries are used in place, only worth giving up for a real gain
+		if (compressedSize <= data.size() - data.size() / 8)
+		{
+			compressed.resize(compressedSize);
+			data = std::move(compressed);
+			file.Entry.Flags |= Package::EntryFlagCompressed;
+		}
+	}
+
+	file.Entry.StoredSize = data.size();
+	file.Data = std::move(data);
+	m_Files.push_back(std::move(file));
+}
+
+bool VulkanHelper::PackageWriter::Write(const std::string& path, std::string* outError) const
+{
+	std::vector<const File*> files(m_Files.size());
+	for (size_t i = 0; i < m_Files.size(); i++)
+		files[i] = &m_Files[i];
+
+	std::sort(files.begin(), files.end(), [](const File* a, const File* b) { return a->Entry.ID < b->Entry.ID; });
+	for (size_t i = 1; i < files.size(); i++)
+	{
+		if (files[i]->Entry.ID == files[i - 1]->Entry.ID)
+		{
+			*outError = "\"" + files[i - 1]->Path + "\" and \"" + files[i]->Path + "\" resolve to the same ID";
+			return false;
+		}
+	}
+
+	auto alignUp = [](uint64_t value) { return (value + Package::s_Alignment - 1) & ~(Package::s_Alignment - 1); };
+
+	Package::Header header;
+	header.EntryCount = files.size();
+	header.EntriesOffset = sizeof(Package::Header);
+
+	std::vector<Package::Entry> entries(files.size());
+	uint64_t offset = alignUp(header.EntriesOffset + entries.size() * sizeof(Package::Entry));
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		entries[i] = files[i]->Entry;
+		entries[i].Offset = offset;
+		offset = alignUp(offset + entries[i].StoredSize);
+	}
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		*outError = "Can't open " + path + " for writing";
+		return false;
+	}
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(Package::Entry));
+
+	static const std::vector<char> s_Zeros(Package::s_Alignment, 0);
+	uint64_t position = sizeof(header) + entries.size() * sizeof(Package::Entry);
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		stream.write(s_Zeros.data(), entries[i].Offset - position);
+		stream.write((const char*)files[i]->Data.data(), files[i]->Data.size());
+		position = entries[i].Offset + entries[i].StoredSize;
+	}
+
+	if (!stream)
+	{
+		*outError = "Failed writing " + path;
+		return false;
+	}
+
+	return true;
+}
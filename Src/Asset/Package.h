@@ -0,0 +1,114 @@
+#pragma once
+#include "Pch.h"
+
+#include "AssetManager.h"
+#include "Utility/MappedFile.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Read only archive holding many asset files in a single memory mapped file.
+	 *
+	 * Layout is a header, the table of contents sorted by AssetID for binary search and the entry data, every entry
+	 * starting on a 4 KiB boundary. Entries are stored either as is, in which case they are used straight from the
+	 * mapping, or LZ4 compressed when that saves enough space.
+	 */
+	class Package
+	{
+	public:
+		enum EntryFlags : uint32_t
+		{
+			EntryFlagCompressed = 1 << 0,
+		};
+
+		struct Entry
+		{
+			AssetID ID = 0; // AssetManager::GetAssetID() of the path
+			uint64_t Offset = 0; // From the start of the file
+			uint64_t StoredSize = 0;
+			uint64_t Size = 0;
+			uint32_t Flags = 0;
+			uint32_t Padding = 0;
+		};
+
+		struct Header
+		{
+			uint32_t Magic = s_Magic;
+			uint32_t Version = s_Version;
+			uint64_t EntryCount = 0;
+			uint64_t EntriesOffset = 0;
+			uint64_t Reserved = 0;
+		};
+
+		inline static constexpr uint32_t s_Magic = 0x4B504856; // "VHPK"
+		inline static constexpr uint32_t s_Version = 1;
+		inline static constexpr uint64_t s_Alignment = 4096;
+
+		Package() = default;
+		~Package() = default;
+
+		Package(const Package& other) = delete;
+		Package& operator=(const Package& other) = delete;
+
+	public:
+
+		// Returns false if the file can't be mapped or isn't a valid package
+		[[nodiscard]] bool Open(const std::string& path);
+
+		[[nodiscard]] const Entry* Find(AssetID id) const;
+
+		// Stored bytes of the entry inside the mapping, compressed if the entry is
+		[[nodiscard]] inline const uint8_t* GetStoredData(const Entry& entry) const { return m_File.GetData() + entry.Offset; }
+
+		// outData has to hold entry.Size bytes
+		[[nodiscard]] bool Read(const Entry& entry, void* outData) const;
+
+		[[nodiscard]] inline const std::string& GetPath() const { return m_Path; }
+		[[nodiscard]] inline size_t GetEntryCount() const { return m_Entries.size(); }
+
+	private:
+		std::string m_Path;
+		MappedFile m_File;
+		std::span<const Entry> m_Entries;
+	};
+
+	/**
+	 * @brief Builds package files, see Package for the layout.
+	 */
+	class PackageWriter
+	{
+	public:
+		/**
+		 * @brief Adds a file under the path it will be requested with at runtime, e.g. "assets/white.png".
+		 *
+		 * The data is only kept compressed if that saves at least an eighth of its size.
+		 */
+		void AddFile(const std::string& path, std::vector<uint8_t> data, bool compress = true);
+
+		// Fails on IO errors and on two paths that hash to the same ID
+		[[nodiscard]] bool Write(const std::string& path, std::string* outError) const;
+
+		[[nodiscard]] inline size_t GetFileCount() const { return m_Files.size(); }
+
+	private:
+		struct File
+		{
+			std::string Path;
+			Package::Entry Entry;
+			std::vector<uint8_t> Data; // As stored
+		};
+
+		std::vector<File> m_Files;
+	};
+
+	// Bytes of an asset file, either a mapped loose file, a view into a mounted package or decompressed from one
+	struct AssetFile
+	{
+		const uint8_t* Data = nullptr;
+		size_t Size = 0;
+
+		MappedFile Mapping;
+		std::shared_ptr<const Package> SourcePackage; // Keeps the mapping alive for entries used in place
+		std::vector<uint8_t> Owned;
+	};
+}
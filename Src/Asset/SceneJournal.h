@@ -0,0 +1,589 @@
+#pragma once
+#include "pch.h"
+#include "Serializer.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Incremental scene saves, a full snapshot plus a journal of the entities changed since it was written.
+	 *
+	 * While tracking, the journal listens to on_construct, on_update and on_destroy of Components and remembers
+	 * which entities changed. SaveDelta() appends only those to the journal file, as their whole current state or
+	 * as destroyed, so an autosave costs as much as the changes instead of the scene. Once the journal outgrows
+	 * CompactionRatio of the snapshot, it's folded into a new snapshot and starts over.
+	 *
+	 * Entities are identified by their number in the snapshot, entities created later get the numbers after it.
+	 * on_update only fires for Entity::PatchComponent() and registry patch() or replace(), components modified
+	 * through plain references have to be reported with MarkModified(). The scene has to outlive the journal.
+	 */
+	template<typename... Components>
+	class SceneJournal
+	{
+	public:
+		static_assert((RegisteredComponent<Components> && ...), "Register every component with VH_REGISTER_COMPONENT!");
+		static_assert(sizeof...(Components) <= UINT16_MAX, "Type indices are stored as uint16_t!");
+
+		inline static constexpr uint32_t s_JournalMagic = 0x524A4856; // "VHJR"
+		inline static constexpr uint32_t s_JournalVersion = 1;
+
+		struct CreateInfo
+		{
+			Scene* Scene = nullptr;
+			std::string SnapshotPath;
+			std::string JournalPath;
+			float CompactionRatio = 0.5f; // Journal size relative to the snapshot that triggers a compaction
+			uint64_t MinCompactionSize = 4ull * 1024 * 1024; // Journals smaller than this are never compacted
+		};
+
+		SceneJournal() = default;
+		SceneJournal(const CreateInfo& createInfo) { Init(createInfo); }
+		~SceneJournal() { Destroy(); }
+
+		SceneJournal(const SceneJournal& other) = delete;
+		SceneJournal& operator=(const SceneJournal& other) = delete;
+
+		// Doesn't touch the files or start tracking yet, follow it with Load() or Compact()
+		void Init(const CreateInfo& createInfo)
+		{
+			Destroy();
+
+			m_Scene = createInfo.Scene;
+			m_SnapshotPath = createInfo.SnapshotPath;
+			m_JournalPath = createInfo.JournalPath;
+			m_CompactionRatio = createInfo.CompactionRatio;
+			m_MinCompactionSize = createInfo.MinCompactionSize;
+		}
+
+		// Stops tracking, changes since the last save are lost
+		void Destroy()
+		{
+			if (m_Scene == nullptr)
+				return;
+
+			Disconnect();
+			m_Scene = nullptr;
+			m_Slots.clear();
+			m_Dirty.clear();
+		}
+
+		/**
+		 * @brief Loads the snapshot, replays the journal on top and starts tracking.
+		 *
+		 * A journal written for another snapshot is ignored and a batch cut short by a crash ends the replay, the
+		 * next save compacts in both cases. Returns false if the snapshot is missing or invalid.
+		 */
+		bool Load(ThreadPool* threadPool = nullptr)
+		{
+			VH_ASSERT(m_Scene != nullptr, "Journal wasn't initialized!");
+			Disconnect();
+			m_Slots.clear();
+			m_Dirty.clear();
+
+			std::vector<entt::entity> entities;
+			if (!Serializer::DeserializeScene<Components...>(m_SnapshotPath, m_Scene, threadPool, &entities))
+				return false;
+
+			MappedFile snapshot;
+			if (!snapshot.Open(m_SnapshotPath))
+				return false;
+
+			m_SnapshotHash = Hash::XXH64(snapshot.GetData(), snapshot.GetSize());
+			m_SnapshotSize = snapshot.GetSize();
+			m_JournalSize = 0;
+			m_NeedsCompaction = !Replay(&entities);
+
+			for (uint32_t id = 0; id < (uint32_t)entities.size(); id++)
+			{
+				if (entities[id] != entt::null)
+					SetID(entities[id], id);
+			}
+
+			m_NextID = (uint32_t)entities.size();
+			Connect();
+			return true;
+		}
+
+		/**
+		 * @brief Writes the whole scene as the new snapshot and truncates the journal, also starts tracking.
+		 *
+		 * The snapshot is written next to the old one and renamed over it, so a crash leaves either the old
+		 * snapshot with its journal or the new one, whose hash the old journal doesn't match.
+		 */
+		bool Compact()
+		{
+			VH_ASSERT(m_Scene != nullptr, "Journal wasn't initialized!");
+
+			std::string tempPath = m_SnapshotPath + ".tmp";
+			std::vector<entt::entity> entities;
+			if (!Serializer::SerializeScene<Components...>(m_Scene, tempPath, &entities))
+				return false;
+
+			std::error_code error;
+			std::filesystem::rename(tempPath, m_SnapshotPath, error);
+			if (error)
+			{
+				VH_ERROR("Failed to replace snapshot {}: {}", m_SnapshotPath, error.message());
+				return false;
+			}
+
+			MappedFile snapshot;
+			if (!snapshot.Open(m_SnapshotPath))
+				return false;
+
+			m_SnapshotHash = Hash::XXH64(snapshot.GetData(), snapshot.GetSize());
+			m_SnapshotSize = snapshot.GetSize();
+			snapshot.Close();
+
+			if (!WriteJournalHeader())
+				return false;
+
+			m_Slots.clear();
+			for (uint32_t id = 0; id < (uint32_t)entities.size(); id++)
+				SetID(entities[id], id);
+
+			m_NextID = (uint32_t)entities.size();
+			m_Dirty.clear();
+			m_NeedsCompaction = false;
+			Connect();
+			return true;
+		}
+
+		/**
+		 * @brief Appends every entity that changed since the last save to the journal, compacts if it got too large.
+		 *
+		 * Falls back to Compact() if the journal can't be appended to, the changes would be lost otherwise. If that
+		 * fails as well, the changed entities are kept and the next save compacts.
+		 */
+		bool SaveDelta()
+		{
+			VH_ASSERT(m_Connected, "Journal isn't tracking, call Load() or Compact() first!");
+
+			if (m_NeedsCompaction)
+				return Compact();
+
+			entt::registry& reg = m_Scene->GetRegistry();
+
+			// Destroyed entities go first, their slot may have been taken by a new entity since. Entities that were
+			// never saved and are gone or have no Components left don't need a record, empty batches aren't written
+			std::vector<entt::entity> dirty;
+			dirty.reserve(m_Dirty.size());
+			for (entt::entity entity : m_Dirty)
+			{
+				if (FindID(entity) != UINT32_MAX || (reg.valid(entity) && reg.any_of<Components...>(entity)))
+					dirty.push_back(entity);
+			}
+
+			if (dirty.empty())
+			{
+				m_Dirty.clear();
+				return true;
+			}
+
+			std::partition(dirty.begin(), dirty.end(), [&reg](entt::entity entity) { return !reg.valid(entity); });
+
+			StreamWriter writer;
+			if (!writer.OpenForAppend(m_JournalPath))
+			{
+				VH_ERROR("Failed to open journal {}, compacting instead", m_JournalPath);
+				m_NeedsCompaction = true;
+				return Compact();
+			}
+
+			BatchHeader batch;
+			uint64_t batchOffset = writer.GetPosition();
+			writer.Write(batch);
+
+			for (entt::entity entity : dirty)
+			{
+				uint32_t id = FindID(entity);
+				if (!reg.valid(entity) || !reg.any_of<Components...>(entity))
+				{
+					writer.Write(RecordHeader{ id, RecordDestroyed, 0 });
+					m_Slots[(size_t)entt::to_entity(entity)] = {};
+				}
+				else
+				{
+					if (id == UINT32_MAX)
+					{
+						id = m_NextID++;
+						SetID(entity, id);
+					}
+
+					WriteState(reg, entity, id, writer);
+				}
+
+				batch.RecordCount++;
+			}
+
+			// The size is patched in last, a batch that never got it is cut off at load
+			batch.Size = writer.GetPosition() - batchOffset - sizeof(BatchHeader);
+			writer.Patch(batchOffset, batch);
+			m_JournalSize = writer.GetPosition();
+
+			// IDs given out above may be in a partially written batch now, only a new snapshot is certain to be consistent
+			if (!writer.Close())
+			{
+				VH_ERROR("Failed to append to journal {}, compacting instead", m_JournalPath);
+				m_NeedsCompaction = true;
+				return Compact();
+			}
+
+			m_Dirty.clear();
+
+			uint64_t compactionSize = std::max(m_MinCompactionSize, (uint64_t)((double)m_SnapshotSize * m_CompactionRatio));
+			if (m_JournalSize > compactionSize)
+				return Compact();
+
+			return true;
+		}
+
+		// Reports changes that didn't go through patch() or replace()
+		inline void MarkModified(entt::entity entity) { m_Dirty.insert(entity); }
+
+		[[nodiscard]] inline size_t GetChangedEntityCount() const { return m_Dirty.size(); }
+		[[nodiscard]] inline uint64_t GetJournalSize() const { return m_JournalSize; }
+		[[nodiscard]] inline uint64_t GetSnapshotSize() const { return m_SnapshotSize; }
+
+	private:
+		enum RecordKind : uint16_t
+		{
+			RecordState, // Every component of Components the entity has, the ones it doesn't have are removed
+			RecordDestroyed,
+		};
+
+		struct BatchHeader
+		{
+			uint64_t RecordCount = 0;
+			uint64_t Size = 0; // Bytes of records following the header
+		};
+
+		struct RecordHeader
+		{
+			uint32_t ID = 0;
+			uint16_t Kind = RecordState;
+			uint16_t ComponentCount = 0; // State records only, each a uint16_t type index, uint64_t size and the data
+		};
+
+		struct EntitySlot
+		{
+			entt::entity Handle = entt::null; // ID belongs to this version of the entity only
+			uint32_t ID = UINT32_MAX;
+		};
+
+		// A record of a batch that passed validation, its components are already decoded
+		struct PendingRecord
+		{
+			uint32_t ID = 0;
+			uint16_t Kind = RecordState;
+			size_t FirstComponent = 0; // Into the batch's pending components
+			size_t ComponentCount = 0;
+		};
+
+		struct PendingComponent
+		{
+			uint16_t Type = 0; // Index into Components
+			std::shared_ptr<void> Component;
+		};
+
+		using ReadComponentFunction = std::shared_ptr<void>(*)(std::span<const char> bytes);
+		using EmplaceComponentFunction = void(*)(entt::registry& registry, entt::entity entity, void* component);
+		using RemoveComponentFunction = void(*)(entt::registry& registry, entt::entity entity);
+
+		// Returns null if the bytes are invalid
+		template<typename T>
+		static std::shared_ptr<void> ReadComponent(std::span<const char> bytes)
+		{
+			std::shared_ptr<T> component = std::make_shared<T>();
+			if (!bytes.empty() && !component->Deserialize(bytes))
+				return nullptr;
+
+			return component;
+		}
+
+		template<typename T>
+		static void EmplaceComponent(entt::registry& registry, entt::entity entity, void* component)
+		{
+			// Not emplace_or_replace(), that needs an assignment operator
+			registry.remove<T>(entity);
+			registry.emplace<T>(entity, std::move(*(T*)component));
+		}
+
+		template<typename T>
+		static void RemoveComponent(entt::registry& registry, entt::entity entity)
+		{
+			registry.remove<T>(entity);
+		}
+
+		template<typename T>
+		static void WriteComponent(const entt::registry& registry, entt::entity entity, uint16_t typeIndex, StreamWriter& writer, uint16_t* componentCount)
+		{
+			const T* component = registry.try_get<T>(entity);
+			if (component == nullptr)
+				return;
+
+			writer.Write(typeIndex);
+			uint64_t sizeOffset = writer.Reserve<uint64_t>();
+			uint64_t componentStart = writer.GetPosition();
+
+			component->Serialize(writer);
+
+			writer.Patch(sizeOffset, writer.GetPosition() - componentStart);
+			(*componentCount)++;
+		}
+
+		static void WriteState(const entt::registry& registry, entt::entity entity, uint32_t id, StreamWriter& writer)
+		{
+			RecordHeader record{ id, RecordState, 0 };
+			uint64_t recordOffset = writer.Reserve<RecordHeader>();
+
+			uint16_t typeIndex = 0;
+			(WriteComponent<Components>(registry, entity, typeIndex++, writer, &record.ComponentCount), ...);
+
+			writer.Patch(recordOffset, record);
+		}
+
+		bool WriteJournalHeader()
+		{
+			StreamWriter writer;
+			if (!writer.Open(m_JournalPath))
+			{
+				VH_ERROR("Failed to open journal {}", m_JournalPath);
+				return false;
+			}
+
+			writer.Write(s_JournalMagic);
+			writer.Write(s_JournalVersion);
+			writer.Write(m_SnapshotHash);
+
+			// Same type table as scene files, records reference their types by index into it
+			writer.Write((uint32_t)sizeof...(Components));
+			([&writer]()
+				{
+					writer.Write(ComponentTraits<Components>::ID);
+					writer.WriteString(ComponentTraits<Components>::Name);
+				}(), ...);
+
+			m_JournalSize = writer.GetPosition();
+			if (!writer.Close())
+			{
+				VH_ERROR("Failed to write journal {}", m_JournalPath);
+				return false;
+			}
+
+			return true;
+		}
+
+		// Applies the journal to entities, indexed by ID. Returns false if it has to be rewritten before appending
+		bool Replay(std::vector<entt::entity>* entities)
+		{
+			MappedFile file;
+			if (!file.Open(m_JournalPath) || file.GetSize() == 0)
+				return false;
+
+			ByteReader reader{ file.GetData(), file.GetSize() };
+
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			uint64_t snapshotHash = 0;
+			uint32_t typeCount = 0;
+			if (!reader.Read(&magic) || !reader.Read(&version) || !reader.Read(&snapshotHash) || !reader.Read(&typeCount) || magic != s_JournalMagic || version != s_JournalVersion)
+			{
+				VH_WARN("{} isn't a scene journal of version {}, ignoring it", m_JournalPath, s_JournalVersion);
+				return false;
+			}
+
+			if (snapshotHash != m_SnapshotHash)
+			{
+				VH_WARN("Journal {} belongs to another snapshot, ignoring it", m_JournalPath);
+				return false;
+			}
+
+			static constexpr std::array<uint64_t, sizeof...(Components)> ids = { ComponentTraits<Components>::ID... };
+			static constexpr std::array<ReadComponentFunction, sizeof...(Components)> reads = { &ReadComponent<Components>... };
+			static constexpr std::array<EmplaceComponentFunction, sizeof...(Components)> emplaces = { &EmplaceComponent<Components>... };
+			static constexpr std::array<RemoveComponentFunction, sizeof...(Components)> removes = { &RemoveComponent<Components>... };
+
+			// File type index to index into Components, types that aren't part of it map to UINT16_MAX
+			std::vector<uint16_t> typeMap(typeCount, UINT16_MAX);
+			for (uint16_t& type : typeMap)
+			{
+				uint64_t typeID = 0;
+				std::string_view name;
+				if (!reader.Read(&typeID) || !reader.ReadCString(&name) || typeID != Hash::FNV1a(name))
+				{
+					VH_WARN("Corrupted component type table in {}, ignoring it", m_JournalPath);
+					return false;
+				}
+
+				for (uint16_t i = 0; i < (uint16_t)ids.size(); i++)
+				{
+					if (ids[i] == typeID)
+						type = i;
+				}
+			}
+
+			entt::registry& reg = m_Scene->GetRegistry();
+			std::vector<uint8_t> present(sizeof...(Components));
+			std::vector<PendingRecord> records;
+			std::vector<PendingComponent> components;
+
+			size_t validEnd = reader.Offset;
+			while (!reader.IsAtEnd())
+			{
+				BatchHeader batch;
+				if (!reader.Read(&batch) || batch.Size == 0 || batch.Size > reader.Size - reader.Offset)
+					break;
+
+				ByteReader batchReader{ reader.Data, reader.Offset + (size_t)batch.Size, reader.Offset };
+				reader.Offset = batchReader.Size;
+
+				// The whole batch is read and decoded first, so a corrupted one leaves the scene untouched. Every
+				// record introduces at most one new ID, which bounds the IDs a valid batch can hold
+				uint64_t maxID = (uint64_t)entities->size() + batch.RecordCount;
+				records.clear();
+				components.clear();
+
+				bool valid = batch.RecordCount <= batch.Size / sizeof(RecordHeader);
+				for (uint64_t r = 0; valid && r < batch.RecordCount; r++)
+				{
+					RecordHeader header;
+					valid = batchReader.Read(&header) && header.ID < maxID && (header.Kind == RecordState || header.Kind == RecordDestroyed);
+					if (!valid)
+						break;
+
+					PendingRecord& record = records.emplace_back();
+					record.ID = header.ID;
+					record.Kind = header.Kind;
+					record.FirstComponent = components.size();
+					if (header.Kind == RecordDestroyed)
+						continue;
+
+					for (uint16_t c = 0; valid && c < header.ComponentCount; c++)
+					{
+						uint16_t typeIndex = 0;
+						uint64_t size = 0;
+						const uint8_t* data = nullptr;
+						valid = batchReader.Read(&typeIndex) && batchReader.Read(&size) && (data = batchReader.Skip(size, 1)) != nullptr && typeIndex < typeCount;
+						if (valid && typeMap[typeIndex] != UINT16_MAX)
+						{
+							std::shared_ptr<void> component = reads[typeMap[typeIndex]](std::span<const char>((const char*)data, (size_t)size));
+							valid = component != nullptr;
+							components.push_back({ typeMap[typeIndex], std::move(component) });
+						}
+					}
+
+					record.ComponentCount = components.size() - record.FirstComponent;
+				}
+
+				if (!valid || !batchReader.IsAtEnd())
+				{
+					VH_WARN("Journal {} has a corrupted batch, the changes after it are lost", m_JournalPath);
+					return false;
+				}
+
+				for (const PendingRecord& record : records)
+				{
+					if (record.ID >= entities->size())
+						entities->resize((size_t)record.ID + 1, entt::null);
+
+					entt::entity& entity = (*entities)[record.ID];
+					if (record.Kind == RecordDestroyed)
+					{
+						if (entity != entt::null)
+							reg.destroy(entity);
+
+						entity = entt::null;
+						continue;
+					}
+
+					if (entity == entt::null)
+						entity = reg.create();
+
+					std::fill(present.begin(), present.end(), (uint8_t)0);
+					for (size_t c = record.FirstComponent; c < record.FirstComponent + record.ComponentCount; c++)
+					{
+						emplaces[components[c].Type](reg, entity, components[c].Component.get());
+						present[components[c].Type] = 1;
+					}
+
+					for (size_t i = 0; i < present.size(); i++)
+					{
+						if (!present[i])
+							removes[i](reg, entity);
+					}
+				}
+
+				validEnd = reader.Offset;
+			}
+
+			m_JournalSize = file.GetSize();
+			if (validEnd != file.GetSize())
+			{
+				VH_WARN("Journal {} ends with an incomplete batch, dropping it", m_JournalPath);
+				return false;
+			}
+
+			return true;
+		}
+
+		void OnChange(entt::registry& registry, entt::entity entity) { m_Dirty.insert(entity); }
+
+		void Connect()
+		{
+			if (m_Connected)
+				return;
+
+			entt::registry& reg = m_Scene->GetRegistry();
+			(reg.on_construct<Components>().template connect<&SceneJournal::OnChange>(*this), ...);
+			(reg.on_update<Components>().template connect<&SceneJournal::OnChange>(*this), ...);
+			(reg.on_destroy<Components>().template connect<&SceneJournal::OnChange>(*this), ...);
+			m_Connected = true;
+		}
+
+		void Disconnect()
+		{
+			if (!m_Connected)
+				return;
+
+			entt::registry& reg = m_Scene->GetRegistry();
+			(reg.on_construct<Components>().template disconnect<&SceneJournal::OnChange>(*this), ...);
+			(reg.on_update<Components>().template disconnect<&SceneJournal::OnChange>(*this), ...);
+			(reg.on_destroy<Components>().template disconnect<&SceneJournal::OnChange>(*this), ...);
+			m_Connected = false;
+		}
+
+		uint32_t FindID(entt::entity entity) const
+		{
+			size_t index = (size_t)entt::to_entity(entity);
+			if (index >= m_Slots.size() || m_Slots[index].Handle != entity)
+				return UINT32_MAX;
+
+			return m_Slots[index].ID;
+		}
+
+		void SetID(entt::entity entity, uint32_t id)
+		{
+			size_t index = (size_t)entt::to_entity(entity);
+			if (index >= m_Slots.size())
+				m_Slots.resize(index + 1);
+
+			m_Slots[index] = { entity, id };
+		}
+
+		Scene* m_Scene = nullptr;
+		std::string m_SnapshotPath;
+		std::string m_JournalPath;
+		float m_CompactionRatio = 0.5f;
+		uint64_t m_MinCompactionSize = 0;
+
+		std::vector<EntitySlot> m_Slots; // Indexed by entity number
+		std::unordered_set<entt::entity> m_Dirty;
+		uint32_t m_NextID = 0;
+
+		uint64_t m_SnapshotHash = 0;
+		uint64_t m_SnapshotSize = 0;
+		uint64_t m_JournalSize = 0;
+		bool m_NeedsCompaction = false;
+		bool m_Connected = false;
+	};
+}
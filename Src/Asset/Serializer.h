@@ -2,110 +2,262 @@
 #include "pch.h"
 #include "Scene/Scene.h"
 #include "Scene/Components.h"
+#include "Scene/ComponentRegistry.h"
 
 #include "Logger/Logger.h"
-#include "Utility/Bytes.h"
+#include "Utility/ByteReader.h"
+#include "Utility/Hash.h"
+#include "Utility/MappedFile.h"
+#include "Utility/StreamWriter.h"
+#include "Utility/ThreadPool.h"
 
 namespace VulkanHelper
 {
+	/**
+	 * @brief Scene files: a header with a table of the component types used, followed by one section per type.
+	 *
+	 * Header is the magic, version, overall file size, entity count and the type count, then per type its
+	 * ComponentTraits ID and null terminated name. Entities are only numbered, 0 to count - 1. A section is a
+	 * SectionHeader, the uint32_t entity numbers of its components and the components. Packed sections hold the
+	 * components back to back as raw bytes, aligned to s_SectionAlignment, others a uint64_t size and the data
+	 * per component.
+	 */
 	class Serializer
 	{
 	public:
+		inline static constexpr uint32_t s_SceneMagic = 0x43534856; // "VHSC"
+		inline static constexpr uint32_t s_SceneVersion = 5; // 1 was the unversioned format with a name per component
+		inline static constexpr size_t s_SectionAlignment = 16;
+
+		enum SectionFlags : uint16_t
+		{
+			SectionFlagPacked = 1 << 0,
+		};
+
+		struct SectionHeader
+		{
+			uint16_t TypeIndex = 0;
+			uint16_t Flags = 0;
+			uint32_t ElementSize = 0; // Packed sections only
+			uint64_t Count = 0;
+			uint64_t Size = 0; // Bytes following the header, lets readers skip unknown types
+		};
+
+		/**
+		 * @brief Streams every entity holding at least one of Components to the file.
+		 *
+		 * Components are written straight into the file buffer, sizes only known afterwards are patched in, so
+		 * memory use doesn't grow with the scene. outEntities receives the entity stored under each number if set.
+		 * Returns false if the file couldn't be written.
+		 */
 		template <typename... Components>
-		static void SerializeScene(Scene* scene, const std::string& filepath)
+		static bool SerializeScene(Scene* scene, const std::string& filepath, std::vector<entt::entity>* outEntities = nullptr)
 		{
-			std::vector<char> bytesOut;
+			static_assert((RegisteredComponent<Components> && ...), "Register every component with VH_REGISTER_COMPONENT!");
+			static_assert(sizeof...(Components) <= UINT16_MAX, "Type indices are stored as uint16_t!");
+
+			StreamWriter writer;
+			if (!writer.Open(filepath))
+			{
+				VH_ERROR("Failed to open {} for writing", filepath);
+				return false;
+			}
 
 			auto& reg = scene->GetRegistry();
 
+			// Entities are numbered densely in the file, indexed by their entt entity number here
+			std::vector<uint32_t> entityIndices;
+			uint64_t entityCount = 0;
+			if (outEntities)
+				outEntities->clear();
+
 			for (auto entity : reg.view<entt::entity>())
 			{
-				std::tuple<Components*...> tuple = reg.try_get<Components...>(entity);
+				if (!reg.any_of<Components...>(entity))
+					continue;
 
-				uint32_t componentsCount = 0;
-				TupleNonNullMemberCount(tuple, componentsCount);
-				if (componentsCount != 0)
-				{
-					std::vector<char> bytesSize = VulkanHelper::Bytes::ToBytes(&componentsCount, 4);
-					bytesOut.insert(bytesOut.end(), bytesSize.begin(), bytesSize.end()); // number of components on the entity
+				uint32_t number = (uint32_t)entt::to_entity(entity);
+				if (number >= entityIndices.size())
+					entityIndices.resize((size_t)number + 1);
 
-					SerializeComponents(tuple, bytesOut);
-				}
-			};
+				entityIndices[number] = (uint32_t)entityCount++;
+				if (outEntities)
+					outEntities->push_back(entity);
+			}
+
+			writer.Write(s_SceneMagic);
+			writer.Write(s_SceneVersion);
+			uint64_t sizeOffset = writer.Reserve<uint64_t>();
+			writer.Write(entityCount);
+
+			// Type table, sections reference their type by index into it
+			const auto& types = GetComponentTable<Components...>();
+			writer.Write((uint32_t)types.size());
+			for (const ComponentType& type : types)
+			{
+				writer.Write(type.ID);
+				writer.WriteString(type.Name);
+			}
 
-			uint64_t size = (uint64_t)bytesOut.size() + 8; // + 8 to account for this 8 size bytes
-			std::vector<char> bytesSize = VulkanHelper::Bytes::ToBytes((char*)&size, 8);
-			bytesOut.insert(bytesOut.begin(), bytesSize.begin(), bytesSize.end()); // first 8 bytes are overall size of the file
+			for (size_t i = 0; i < types.size(); i++)
+				types[i].WriteSection(reg, (uint16_t)i, entityIndices, writer);
 
-			std::ofstream ofstream;
-			ofstream.open(filepath, std::ios_base::binary | std::ios_base::trunc);
+			writer.Patch(sizeOffset, writer.GetPosition());
 
-			ofstream.write(bytesOut.data(), bytesOut.size());
-			ofstream.flush();
+			if (!writer.Close())
+			{
+				VH_ERROR("Failed to write scene {}", filepath);
+				return false;
+			}
 
-			ofstream.close();
+			return true;
 		}
 
+		/**
+		 * @brief Creates the entities stored in the file in outScene, returns false if the file is missing or invalid.
+		 *
+		 * The file is mapped and components are deserialized straight from the mapping. Sections are split into
+		 * chunks of up to s_ChunkSize components. Chunks of packed types and types that opt in with s_ParallelDecode
+		 * are decoded in parallel on threadPool, everything else and all of them if it's null on the calling
+		 * thread. Storages are only touched from the calling thread afterwards, all entities are created
+		 * with a single call up front and every section is inserted into its storage at once, packed sections
+		 * without deserializing. Types in the file that aren't part of Components are skipped. outEntities receives
+		 * the entity created for each number if set.
+		 */
 		template <typename... Components>
-		static void DeserializeScene(const std::string& filepath, Scene* outScene)
+		static bool DeserializeScene(const std::string& filepath, Scene* outScene, ThreadPool* threadPool = nullptr, std::vector<entt::entity>* outEntities = nullptr)
 		{
-			std::ifstream ifstream(filepath, std::ios_base::binary);
+			static_assert((RegisteredComponent<Components> && ...), "Register every component with VH_REGISTER_COMPONENT!");
 
+			MappedFile file;
+			if (!file.Open(filepath))
+			{
+				VH_ERROR("Scene file {} doesn't exist", filepath);
+				return false;
+			}
+
+			ByteReader reader{ file.GetData(), file.GetSize() };
+
+			uint32_t magic = 0;
+			uint32_t version = 0;
 			uint64_t size = 0;
-			ifstream.read((char*)&size, 8);
-			ifstream.seekg(0);
+			uint64_t entityCount = 0;
+			uint32_t typeCount = 0;
+			if (!reader.Read(&magic) || !reader.Read(&version) || magic != s_SceneMagic || version != s_SceneVersion)
+			{
+				VH_ERROR("{} isn't a scene file of version {}", filepath, s_SceneVersion);
+				return false;
+			}
 
-			std::vector<char> bytes(size);
-			ifstream.read(bytes.data(), size);
+			if (!reader.Read(&size) || !reader.Read(&entityCount) || !reader.Read(&typeCount) || size != file.GetSize() || entityCount > UINT32_MAX)
+			{
+				VH_ERROR("Scene file {} is truncated", filepath);
+				return false;
+			}
 
-			ifstream.seekg(8); // skip first 8 bytes of size data
-			uint64_t currentPos = 8;
-			while (currentPos < size)
+			// Types are looked up by ID once here, sections index straight into this table
+			std::vector<const ComponentType*> types(typeCount);
+			for (const ComponentType*& type : types)
 			{
-				// Get the component count on this entity
-				uint32_t componentCount = 0;
-				ifstream.read((char*)&componentCount, 4);
-				currentPos += 4;
+				uint64_t typeID = 0;
+				std::string_view name;
+				if (!reader.Read(&typeID) || !reader.ReadCString(&name) || typeID != Hash::FNV1a(name))
+				{
+					VH_ERROR("Corrupted component type table in {}", filepath);
+					return false;
+				}
 
-				VulkanHelper::Entity entity = outScene->CreateEntity();
+				type = FindComponentType<Components...>(typeID);
+				if (type == nullptr)
+				{
+					VH_WARN("Scene {} holds component {} which wasn't requested, skipping it", filepath, name);
+				}
+				else if (std::count(types.begin(), types.end(), type) > 1)
+				{
+					// Sections of one type have to share a type index for the duplicate check below
+					VH_ERROR("Component {} is listed twice in the type table of {}", name, filepath);
+					return false;
+				}
+			}
 
-				for (uint64_t i = 0; i < componentCount; i++)
+			// Validates every section and finds where its chunks start, nothing is decoded yet
+			std::vector<LoadedSection> sections;
+			std::vector<SectionChunk> chunks;
+			std::vector<std::vector<bool>> usedNumbers(typeCount); // Per type, an entity can hold only one component of it
+			while (!reader.IsAtEnd())
+			{
+				if (!ReadSection(reader, types, entityCount, &usedNumbers, &sections, &chunks))
 				{
-					// Get the component name
-					std::string compName;
-					while (true)
-					{
-						char ch;
-						ifstream.read(&ch, 1);
-						currentPos += 1;
+					VH_ERROR("Invalid component section in {}", filepath);
+					return false;
+				}
+			}
 
-						if (ch == '\0')
-						{
-							break;
-						}
+			entt::registry& reg = outScene->GetRegistry();
+
+			std::vector<entt::entity> entities((size_t)entityCount);
+			reg.create(entities.begin(), entities.end());
 
-						compName.push_back(ch);
+			// Chunks only write to their own range of their section's arrays, storages aren't touched
+			std::atomic<bool> failed = false;
+			auto decodeChunk = [&](uint32_t i)
+				{
+					const SectionChunk& chunk = chunks[i];
+					LoadedSection& section = sections[chunk.Section];
+
+					// Numbers were range and duplicate checked by ReadSection()
+					const uint8_t* numbers = reader.Data + section.NumbersOffset;
+					for (uint64_t j = chunk.First; j < chunk.First + chunk.Count; j++)
+					{
+						uint32_t number;
+						memcpy(&number, numbers + j * sizeof(uint32_t), sizeof(uint32_t));
+						section.Entities[(size_t)j] = entities[number];
 					}
 
-					// Create a component from a registered constructor
-					void* component = CreateRegisteredClass(compName);
+					if (section.Decoded)
+					{
+						ByteReader chunkReader{ reader.Data, section.End, chunk.Offset };
+						if (!section.Type->DecodeComponents(section.Decoded.get(), chunk.First, chunk.Count, chunkReader))
+							failed = true;
+					}
+				};
 
-					// Read 8 bytes of data size
-					uint64_t componentDataSize = 0;
-					ifstream.read((char*)&componentDataSize, 8);
-					currentPos += 8;
+			// Deserialize() of other types may run user code that isn't safe off the calling thread
+			std::vector<uint32_t> parallelChunks;
+			std::vector<uint32_t> serialChunks;
+			for (uint32_t i = 0; i < (uint32_t)chunks.size(); i++)
+			{
+				const LoadedSection& section = sections[chunks[i].Section];
+				if (threadPool != nullptr && (!section.Decoded || section.Type->ParallelDecode))
+					parallelChunks.push_back(i);
+				else
+					serialChunks.push_back(i);
+			}
 
-					// read the data
-					std::vector<char> componentByteData(componentDataSize);
-					ifstream.read(componentByteData.data(), componentDataSize);
-					currentPos += componentDataSize;
+			if (!parallelChunks.empty())
+				threadPool->ParallelFor((uint32_t)parallelChunks.size(), [&](uint32_t i) { decodeChunk(parallelChunks[i]); });
 
-					// Push component onto the entity
-					DeduceObjectTypeAndAddToEntity<Components...>(component, compName, entity, componentByteData);
+			for (uint32_t i : serialChunks)
+				decodeChunk(i);
 
-					delete component;
-				}
+			if (failed)
+			{
+				VH_ERROR("Invalid component section in {}", filepath);
+				reg.destroy(entities.begin(), entities.end());
+				return false;
 			}
+
+			// One batch per section, in file order
+			for (LoadedSection& section : sections)
+			{
+				const uint8_t* packedData = section.Decoded ? nullptr : reader.Data + section.DataOffset;
+				section.Type->InsertComponents(reg, section.Entities, packedData, section.Decoded.get());
+			}
+
+			if (outEntities)
+				*outEntities = std::move(entities);
+
+			return true;
 		}
 
 #define REGISTER_CLASS_IN_SERIALIZER(className) VulkanHelper::Serializer::RegisterClass<className>(#className)
@@ -116,166 +268,297 @@ namespace VulkanHelper
 			s_ReflectionMap[className] = []() { return (void*)(new T()); };
 		}
 
+		// Returns nullptr if className wasn't registered. Never inserts, so it can be called while scenes are decoded on several threads
 		static void* CreateRegisteredClass(const std::string& className)
 		{
-			VH_ASSERT(s_ReflectionMap.find(className) != s_ReflectionMap.end(), "class {} wasn't registered!", className);
+			auto iter = s_ReflectionMap.find(className);
+			if (iter == s_ReflectionMap.end())
+			{
+				VH_ERROR("Class {} wasn't registered!", className);
+				return nullptr;
+			}
 
-			return s_ReflectionMap[className]();
+			return iter->second();
 		}
 
 	private:
+		using WriteSectionFunction = void(*)(const entt::registry& registry, uint16_t typeIndex, const std::vector<uint32_t>& entityIndices, StreamWriter& writer);
+		using AllocateComponentsFunction = std::shared_ptr<void>(*)(size_t count);
+		using DecodeComponentsFunction = bool(*)(void* components, uint64_t first, uint64_t count, ByteReader& reader);
+		using InsertComponentsFunction = void(*)(entt::registry& registry, std::span<const entt::entity> entities, const uint8_t* packedData, void* components);
 
-		template<typename T>
-		static void PushComponent(T&& comp, VulkanHelper::Entity& entity)
+		// Jump table entry, everything the serializer does per type goes through these
+		struct ComponentType
 		{
-			entity.AddComponent<T>(std::move(comp));
-		}
-
-		template<typename T>
-		static T* TryCast(void* obj, const std::string& compName)
+			std::string_view Name;
+			uint64_t ID;
+			bool Packed;
+			bool ParallelDecode; // Non packed sections of the type can be decoded on worker threads
+			uint32_t ElementSize; // Packed types only
+			WriteSectionFunction WriteSection;
+			AllocateComponentsFunction AllocateComponents;
+			DecodeComponentsFunction DecodeComponents;
+			InsertComponentsFunction InsertComponents;
+		};
+
+		// A section of a known type that passed validation, filled in by the chunks of it
+		struct LoadedSection
 		{
-			// Check and parse the name
-			std::string name = typeid(T).name();
-			if (name.find("class ") != std::string::npos)
-				name = name.substr(6, name.size() - 6);
+			const ComponentType* Type = nullptr;
+			size_t NumbersOffset = 0;
+			size_t DataOffset = 0; // Start of the components, aligned for packed sections
+			size_t End = 0;
+			std::vector<entt::entity> Entities;
+			std::shared_ptr<void> Decoded; // std::vector of the type, null for packed sections
+		};
+
+		// Range of a section's components decoded by one task
+		struct SectionChunk
+		{
+			uint32_t Section = 0;
+			uint64_t First = 0;
+			uint64_t Count = 0;
+			size_t Offset = 0; // Of the size of the first component in non packed sections
+		};
 
-			if (name.find(" * __ptr64") != std::string::npos)
-				name = name.substr(0, name.size() - 10);
+		// Enough work to outweigh scheduling a task, small enough to spread a single large section over all workers
+		inline static constexpr uint64_t s_ChunkSize = 16 * 1024;
 
-			if (name.find(" * __ptr32") != std::string::npos)
-				name = name.substr(0, name.size() - 10);
+		// Built at compile time, function bodies see the complete class so the table can point at private members
+		template<typename... T>
+		static const std::array<ComponentType, sizeof...(T)>& GetComponentTable()
+		{
+			static constexpr std::array<ComponentType, sizeof...(T)> types = { ComponentType{
+				ComponentTraits<T>::Name, ComponentTraits<T>::ID, IsPacked<T>(), IsParallelDecoded<T>(), IsPacked<T>() ? (uint32_t)sizeof(T) : 0,
+				&WriteSection<T>, &AllocateComponents<T>, &DecodeComponents<T>, &InsertComponents<T> }... };
 
-			if (name.find("VulkanHelper::") != std::string::npos)
-				name = name.substr(14, name.size() - 14);
+			static_assert([]()
+				{
+					for (size_t i = 0; i < types.size(); i++)
+					{
+						for (size_t j = i + 1; j < types.size(); j++)
+						{
+							if (types[i].ID == types[j].ID)
+								return false;
+						}
+					}
 
-			// If the name matches that of a component then return it
-			if (name == compName)
-				return (T*)(obj);
-			else
-				return nullptr;
+					return true;
+				}(), "Two components are registered under the same name or their name hashes collide!");
 
-			//return dynamic_cast<T*>(obj);
+			return types;
 		}
 
 		template<typename... T>
-		static void DeduceObjectTypeAndAddToEntity(void* obj, const std::string& compName, VulkanHelper::Entity& entity, const std::vector<char>& deserializedData)
+		static const ComponentType* FindComponentType(uint64_t id)
 		{
-			if constexpr (sizeof...(T) == 0)
-				return;
-			else
+			for (const ComponentType& type : GetComponentTable<T...>())
 			{
-				// Try casting the obj into one of the components given in T
-				// It will fill the tuple with nullptrs except for the original obj type
-				std::tuple<T*...> tuple = { TryCast<T>(obj, compName)... };
+				if (type.ID == id)
+					return &type;
+			}
+
+			return nullptr;
+		}
 
-				IterateTupleAndAddComponent(tuple, entity, deserializedData);
+		// Components opt into packed sections with s_Packed, their bytes have to be their whole state
+		template<typename T>
+		static constexpr bool IsPacked()
+		{
+			if constexpr (requires { T::s_Packed; })
+			{
+				static_assert(!T::s_Packed || std::is_trivially_copyable_v<T>, "Packed components are stored and loaded as raw bytes, they have to be trivially copyable!");
+				return T::s_Packed;
 			}
+			else
+				return false;
 		}
 
-		template<size_t I = 0, typename... T>
-		constexpr static void IterateTupleAndAddComponent(const std::tuple<T...>& tuple, VulkanHelper::Entity& entity, const std::vector<char>& deserializedData)
+		// Components opt into decoding on worker threads with s_ParallelDecode, Deserialize() must only touch the component then
+		template<typename T>
+		static constexpr bool IsParallelDecoded()
 		{
-			// Iterate the tuple and check if the component != nullptr. If true then add the component to the entity
-			// otherwise keep iterating
+			if constexpr (requires { T::s_ParallelDecode; })
+				return T::s_ParallelDecode;
+			else
+				return false;
+		}
 
-			if constexpr (I == sizeof...(T))
+		template<typename T>
+		static void WriteSection(const entt::registry& registry, uint16_t typeIndex, const std::vector<uint32_t>& entityIndices, StreamWriter& writer)
+		{
+			auto view = registry.view<T>();
+			if (view.begin() == view.end())
 				return;
+
+			SectionHeader header;
+			header.TypeIndex = typeIndex;
+			header.Flags = IsPacked<T>() ? SectionFlagPacked : 0;
+			header.ElementSize = IsPacked<T>() ? (uint32_t)sizeof(T) : 0;
+
+			// Count and size are patched in, storages with tombstones only know an upper bound of their size
+			uint64_t headerOffset = writer.GetPosition();
+			writer.Write(header);
+			uint64_t dataStart = writer.GetPosition();
+
+			for (auto entity : view)
+			{
+				writer.Write(entityIndices[(size_t)entt::to_entity(entity)]);
+				header.Count++;
+			}
+
+			if constexpr (IsPacked<T>())
+			{
+				writer.Align(s_SectionAlignment);
+				for (auto [entity, component] : view.each())
+					writer.Write(&component, sizeof(T));
+			}
 			else
 			{
-				auto comp = std::get<I>(tuple);
-				if (comp != nullptr)
+				for (auto [entity, component] : view.each())
 				{
-					if (!deserializedData.empty())
-						comp->Deserialize(deserializedData);
+					// Size of the component data bytes, known once the component wrote itself
+					uint64_t sizeOffset = writer.Reserve<uint64_t>();
+					uint64_t componentStart = writer.GetPosition();
 
-					PushComponent(std::move(*comp), entity);
-					return;
-				}
+					component.Serialize(writer);
 
-				IterateTupleAndAddComponent<I + 1>(tuple, entity, deserializedData);
+					writer.Patch(sizeOffset, writer.GetPosition() - componentStart);
+				}
 			}
+
+			header.Size = writer.GetPosition() - dataStart;
+			writer.Patch(headerOffset, header);
 		}
 
-		template<size_t I = 0, typename... T>
-		constexpr static void SerializeComponents(const std::tuple<T...>& tuple, std::vector<char>& bytesOut)
+		// Reads one section, sections of skipped types aren't added but still have to be valid
+		static bool ReadSection(
+			ByteReader& reader,
+			const std::vector<const ComponentType*>& types,
+			uint64_t entityCount,
+			std::vector<std::vector<bool>>* usedNumbers,
+			std::vector<LoadedSection>* sections,
+			std::vector<SectionChunk>* chunks
+		)
 		{
-			if constexpr (I == sizeof...(T))
-				return;
-			else
+			SectionHeader header;
+			if (!reader.Read(&header) || header.TypeIndex >= types.size() || header.Count > entityCount || header.Size > reader.Size - reader.Offset)
+				return false;
+
+			size_t sectionEnd = reader.Offset + (size_t)header.Size;
+			ByteReader sectionReader{ reader.Data, sectionEnd, reader.Offset };
+			reader.Offset = sectionEnd;
+
+			size_t numbersOffset = sectionReader.Offset;
+			if (sectionReader.Skip(header.Count, sizeof(uint32_t)) == nullptr)
+				return false;
+
+			const ComponentType* type = types[header.TypeIndex];
+			if (type == nullptr)
+				return true;
+
+			// A number out of range or given twice, also across sections of the same type, would corrupt the storage
+			std::vector<bool>& used = (*usedNumbers)[header.TypeIndex];
+			if (used.empty())
+				used.resize((size_t)entityCount);
+
+			for (uint64_t i = 0; i < header.Count; i++)
 			{
-				// Tuple is filled with nullptr except for the components that the entity contains
-				// so iterate over the tuple and check if they are nullptr or not
-				auto comp = std::get<I>(tuple);
-				if (comp != nullptr)
-					SerializeComponent(comp, bytesOut);
+				uint32_t number;
+				memcpy(&number, reader.Data + numbersOffset + i * sizeof(uint32_t), sizeof(uint32_t));
+				if (number >= entityCount || used[number])
+					return false;
 
-				SerializeComponents<I + 1>(tuple, bytesOut);
+				used[number] = true;
 			}
-		}
 
-		template<size_t I = 0, typename... T>
-		constexpr static void TupleNonNullMemberCount(const std::tuple<T...>& tuple, uint32_t& outSize)
-		{
-			if constexpr (I == sizeof...(T))
-				return;
+			LoadedSection section;
+			section.Type = type;
+			section.NumbersOffset = numbersOffset;
+			section.End = sectionEnd;
+			section.Entities.resize((size_t)header.Count);
+
+			uint32_t sectionIndex = (uint32_t)sections->size();
+			if (header.Flags & SectionFlagPacked)
+			{
+				// Straight from the mapping, which is page aligned, so aligned file offsets are aligned addresses
+				if (!type->Packed || header.ElementSize != type->ElementSize || !sectionReader.Align(s_SectionAlignment))
+					return false; // Type stopped being packed or changed its layout since the file was written
+
+				section.DataOffset = sectionReader.Offset;
+				if (sectionReader.Skip(header.Count, type->ElementSize) == nullptr)
+					return false;
+
+				for (uint64_t first = 0; first < header.Count; first += s_ChunkSize)
+					chunks->push_back({ sectionIndex, first, std::min(s_ChunkSize, header.Count - first), 0 });
+			}
 			else
 			{
-				auto obj = std::get<I>(tuple);
-				if (obj != nullptr)
-					outSize += 1;
+				section.DataOffset = sectionReader.Offset;
+				section.Decoded = type->AllocateComponents((size_t)header.Count);
+
+				// Only hops over the sizes to find where chunks start, decoding them is left to the tasks
+				for (uint64_t i = 0; i < header.Count; i++)
+				{
+					if (i % s_ChunkSize == 0)
+						chunks->push_back({ sectionIndex, i, std::min(s_ChunkSize, header.Count - i), sectionReader.Offset });
 
-				TupleNonNullMemberCount<I + 1>(tuple, outSize);
+					uint64_t componentDataSize = 0;
+					if (!sectionReader.Read(&componentDataSize) || sectionReader.Skip(componentDataSize, 1) == nullptr)
+						return false;
+				}
 			}
+
+			sections->push_back(std::move(section));
+			return true;
 		}
 
 		template<typename T>
-		static void SerializeComponent(T component, std::vector<char>& bytesOut)
+		static std::shared_ptr<void> AllocateComponents(size_t count)
 		{
-			std::string name = typeid(T).name();
-			if (name.find("class ") != std::string::npos)
-				name = name.substr(6, name.size() - 6);
+			return std::make_shared<std::vector<T>>(count);
+		}
 
-			if (name.find("struct ") != std::string::npos)
-				name = name.substr(7, name.size() - 7);
+		// Deserializes components [first, first + count) of a non packed section, the reader is at the first one
+		template<typename T>
+		static bool DecodeComponents(void* components, uint64_t first, uint64_t count, ByteReader& reader)
+		{
+			std::vector<T>& decoded = *(std::vector<T>*)components;
+			for (uint64_t i = first; i < first + count; i++)
+			{
+				uint64_t componentDataSize = 0;
+				const uint8_t* componentData = nullptr;
+				if (!reader.Read(&componentDataSize) || (componentData = reader.Skip(componentDataSize, 1)) == nullptr)
+					return false;
 
-			if (name.find(" * __ptr64") != std::string::npos)
-				name = name.substr(0, name.size() - 10);
+				if (componentDataSize != 0 && !decoded[(size_t)i].Deserialize(std::span<const char>((const char*)componentData, (size_t)componentDataSize)))
+					return false;
+			}
 
-			if (name.find(" * __ptr32") != std::string::npos)
-				name = name.substr(0, name.size() - 10);
+			return true;
+		}
 
-			if (name.find("VulkanHelper::") != std::string::npos)
-				name = name.substr(14, name.size() - 14);
+		// Either packedData points at the components in the mapping or components is the vector they were decoded into
+		template<typename T>
+		static void InsertComponents(entt::registry& registry, std::span<const entt::entity> entities, const uint8_t* packedData, void* components)
+		{
+			auto& storage = registry.storage<T>();
+			storage.reserve(storage.size() + entities.size());
 
-			std::vector<char> nameBytes;
-			for (int i = 0; i < name.size(); i++)
+			if constexpr (IsPacked<T>())
 			{
-				nameBytes.push_back(name[i]);
+				if (packedData != nullptr)
+				{
+					registry.insert<T>(entities.begin(), entities.end(), (const T*)packedData);
+					return;
+				}
 			}
-			nameBytes.push_back('\0');
-
-			std::vector<char> componentBytes = component->Serialize();
-
-			std::vector<char> combinedBytes;
-			combinedBytes.reserve(nameBytes.size() + 8 + componentBytes.size());
-
-			// First the name of the component class
-			combinedBytes.insert(combinedBytes.end(), nameBytes.begin(), nameBytes.end());
-
-			// Size of the component data bytes
-			uint64_t size = (uint64_t)componentBytes.size();
-			std::vector<char> bytesSize = VulkanHelper::Bytes::ToBytes((char*)&size, 8);
-			combinedBytes.insert(combinedBytes.end(), bytesSize.begin(), bytesSize.end()); // first 8 bytes are overall size of the file
-
-			// Component Data
-			combinedBytes.insert(combinedBytes.end(), componentBytes.begin(), componentBytes.end());
 
-			// Push the data out
-			bytesOut.reserve(bytesOut.size() + combinedBytes.size());
-			bytesOut.insert(bytesOut.end(), combinedBytes.begin(), combinedBytes.end());
+			std::vector<T>& decoded = *(std::vector<T>*)components;
+			registry.insert<T>(entities.begin(), entities.end(), std::make_move_iterator(decoded.begin()));
 		}
 
 		static inline std::unordered_map<std::string, std::function<void* ()>> s_ReflectionMap;
 	};
 
-}
\ No newline at end of file
+}
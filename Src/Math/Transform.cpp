@@ -11,38 +11,6 @@ namespace VulkanHelper
 		m_Scale = scale;
 	}
 
-	Transform::Transform(const Transform& other)
-	{
-		m_Rotation = other.m_Rotation;
-		m_Scale = other.m_Scale;
-		m_Translation = other.m_Translation;
-	}
-
-	Transform::Transform(Transform&& other) noexcept
-	{
-		m_Rotation = std::move(other.m_Rotation);
-		m_Scale = std::move(other.m_Scale);
-		m_Translation = std::move(other.m_Translation);
-	}
-
-	Transform& Transform::operator=(const Transform& other)
-	{
-		m_Rotation = other.m_Rotation;
-		m_Scale = other.m_Scale;
-		m_Translation = other.m_Translation;
-
-		return *this;
-	}
-
-	Transform& Transform::operator=(Transform&& other) noexcept
-	{
-		m_Rotation = std::move(other.m_Rotation);
-		m_Scale = std::move(other.m_Scale);
-		m_Translation = std::move(other.m_Translation);
-
-		return *this;
-	}
-
 	VkTransformMatrixKHR Transform::GetKhrMat()
 	{
 		glm::mat4 temp = glm::transpose(GetMat4());
@@ -18,10 +18,10 @@ namespace VulkanHelper
 		Transform(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale);
 
 		~Transform() = default;
-		Transform(const Transform& other);
-		Transform(Transform&& other) noexcept;
-		Transform& operator=(const Transform& other);
-		Transform& operator=(Transform&& other) noexcept;
+		Transform(const Transform& other) = default;
+		Transform(Transform&& other) noexcept = default;
+		Transform& operator=(const Transform& other) = default;
+		Transform& operator=(Transform&& other) noexcept = default;
 
 		VkTransformMatrixKHR GetKhrMat();
 		glm::mat4 GetMat4();
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <span>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -0,0 +1,32 @@
+#pragma once
+#include "pch.h"
+
+#include "Utility/Hash.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Compile time description of a serializable component, filled in by VH_REGISTER_COMPONENT.
+	 *
+	 * Name is what scene files identify the type by, so it has to stay the same when the type is renamed or moved
+	 * to another namespace. ID is the FNV-1a hash of the name, computed at compile time.
+	 */
+	template<typename T>
+	struct ComponentTraits
+	{
+		static constexpr bool Registered = false;
+	};
+
+	template<typename T>
+	concept RegisteredComponent = ComponentTraits<T>::Registered;
+}
+
+// Use at global scope with the fully qualified type, e.g. VH_REGISTER_COMPONENT(Game::Health, "Health")
+#define VH_REGISTER_COMPONENT(type, name) \
+	template<> \
+	struct VulkanHelper::ComponentTraits<type> \
+	{ \
+		static constexpr bool Registered = true; \
+		static constexpr std::string_view Name = name; \
+		static constexpr uint64_t ID = VulkanHelper::Hash::FNV1a(name); \
+	}
@@ -3,7 +3,7 @@
 #include "Renderer/Renderer.h"
 
 #include "Logger/Logger.h"
-#include "Utility/Bytes.h"
+#include "Utility/StreamWriter.h"
 
 #include "Asset/Serializer.h"
 
@@ -33,52 +33,38 @@ namespace VulkanHelper
 		}
 	}
 
-	std::vector<char> ScriptComponent::Serialize()
+	void ScriptComponent::Serialize(StreamWriter& writer) const
 	{
-		std::vector<char> bytes;
-
 		for (int i = 0; i < ScriptClassesNames.size(); i++)
 		{
-			for (int j = 0; j < ScriptClassesNames[i].size(); j++)
-			{
-				bytes.push_back(ScriptClassesNames[i][j]);
-			}
+			writer.WriteString(ScriptClassesNames[i]);
 		}
-
-		bytes.push_back('\0');
-
-		return bytes;
 	}
 
-	void ScriptComponent::Deserialize(const std::vector<char>& bytes)
+	bool ScriptComponent::Deserialize(std::span<const char> bytes)
 	{
-		std::vector<std::string> scriptClassNames(1);
-
-		if (bytes[0] == '\0') // No scripts attached
-			return;
-
-		for (int i = 0; i < bytes.size(); i++)
+		// Null terminated class names back to back
+		size_t start = 0;
+		for (size_t i = 0; i < bytes.size(); i++)
 		{
-			if (bytes[i] == '\0')
-			{
-				scriptClassNames.emplace_back("");
-			}
-
-			scriptClassNames[scriptClassNames.size() - 1].push_back(bytes[i]);
-		}
+			if (bytes[i] != '\0')
+				continue;
 
-		scriptClassNames.erase(scriptClassNames.end() - 1); // last index is always empty due to for loop above
+			if (i != start)
+			{
+				ScriptClassesNames.emplace_back(bytes.data() + start, i - start);
 
-		ScriptClassesNames = scriptClassNames;
+				ScriptInterface* scInterface = (ScriptInterface*)Serializer::CreateRegisteredClass(ScriptClassesNames.back());
+				if (scInterface == nullptr)
+					return false;
 
-		for (int i = 0; i < scriptClassNames.size(); i++)
-		{
-			ScriptInterface* scInterface = (ScriptInterface*)Serializer::CreateRegisteredClass(scriptClassNames[i]);
-
-			VH_ASSERT(scInterface != nullptr, "Script doesn't inherit from script interface!");
+				Scripts.push_back(scInterface);
+			}
 
-			Scripts.push_back(scInterface);
+			start = i + 1;
 		}
+
+		return true;
 	}
 
 	ScriptComponent::~ScriptComponent()
@@ -95,46 +81,30 @@ namespace VulkanHelper
 		ScriptClassesNames = std::move(other.ScriptClassesNames);
 	}
 
-	std::vector<char> TransformComponent::Serialize()
+	void TransformComponent::Serialize(StreamWriter& writer) const
 	{
-		return VulkanHelper::Bytes::ToBytes(this, sizeof(TransformComponent));
+		writer.Write(this, sizeof(TransformComponent));
 	}
 
-	void TransformComponent::Deserialize(const std::vector<char>& bytes)
+	bool TransformComponent::Deserialize(std::span<const char> bytes)
 	{
-		TransformComponent comp = VulkanHelper::Bytes::FromBytes<TransformComponent>(bytes);
-		memcpy(&Transform, &comp.Transform, sizeof(VulkanHelper::Transform));
+		if (bytes.size() < sizeof(VulkanHelper::Transform))
+			return false;
+
+		memcpy(&Transform, bytes.data(), sizeof(VulkanHelper::Transform));
+		return true;
 	}
 
-	std::vector<char> NameComponent::Serialize()
+	void NameComponent::Serialize(StreamWriter& writer) const
 	{
-		std::vector<char> bytes;
-		for (int i = 0; i < Name.size(); i++)
-		{
-			bytes.push_back(Name[i]);
-		}
-		bytes.push_back('\0');
-
-		return bytes;
+		writer.WriteString(Name);
 	}
 
-	void NameComponent::Deserialize(const std::vector<char>& bytes)
+	bool NameComponent::Deserialize(std::span<const char> bytes)
 	{
-		std::string name;
-
-		int index = 0;
-		while (true)
-		{
-			char ch = bytes[index];
-			index++;
-
-			if (ch == '\0')
-				break;
-			else
-				name.push_back(ch);
-		}
-
-		Name = std::move(name);
+		const char* end = (const char*)memchr(bytes.data(), '\0', bytes.size());
+		Name.assign(bytes.data(), end ? end : bytes.data() + bytes.size());
+		return true;
 	}
 
 }
\ No newline at end of file
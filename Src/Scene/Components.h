@@ -2,10 +2,13 @@
 #include "pch.h"
 
 #include "Entity.h"
+#include "ComponentRegistry.h"
 #include "Math/Transform.h"
 
 namespace VulkanHelper
 {
+	class StreamWriter;
+
 	class ScriptInterface
 	{
 	public:
@@ -78,8 +81,8 @@ namespace VulkanHelper
 
 		inline uint32_t GetScriptCount() const { return (uint32_t)Scripts.size(); }
 
-		std::vector<char> Serialize();
-		void Deserialize(const std::vector<char>& bytes);
+		void Serialize(StreamWriter& writer) const;
+		[[nodiscard]] bool Deserialize(std::span<const char> bytes); // False if a script class wasn't registered
 	};
 
 	class TransformComponent
@@ -87,13 +90,17 @@ namespace VulkanHelper
 	public:
 		TransformComponent() = default;
 		~TransformComponent() = default;
-		TransformComponent(TransformComponent&& other) noexcept { Transform = std::move(other.Transform); };
-		TransformComponent(const TransformComponent& other) { Transform = other.Transform; };
-		TransformComponent& operator=(const TransformComponent& other) { Transform = other.Transform; return *this; };
-		TransformComponent& operator=(TransformComponent&& other) noexcept { Transform = std::move(other.Transform); return *this; };
+		TransformComponent(TransformComponent&& other) noexcept = default;
+		TransformComponent(const TransformComponent& other) = default;
+		TransformComponent& operator=(const TransformComponent& other) = default;
+		TransformComponent& operator=(TransformComponent&& other) noexcept = default;
+
+		void Serialize(StreamWriter& writer) const;
+		[[nodiscard]] bool Deserialize(std::span<const char> bytes);
 
-		std::vector<char> Serialize();
-		void Deserialize(const std::vector<char>& bytes);
+		// Plain data, scene files store all transforms back to back and load them with one bulk insert, keep it trivially copyable
+		inline static constexpr bool s_Packed = true;
+		inline static constexpr bool s_ParallelDecode = true;
 
 		VulkanHelper::Transform Transform;
 	};
@@ -108,9 +115,16 @@ namespace VulkanHelper
 		NameComponent& operator=(const NameComponent& other) { Name = other.Name; return *this; };
 		NameComponent& operator=(NameComponent&& other) noexcept { Name = std::move(other.Name); return *this; };
 
-		std::vector<char> Serialize();
-		void Deserialize(const std::vector<char>& bytes);
+		void Serialize(StreamWriter& writer) const;
+		[[nodiscard]] bool Deserialize(std::span<const char> bytes);
+
+		// Only copies the string, safe to decode on worker threads
+		inline static constexpr bool s_ParallelDecode = true;
 
 		std::string Name;
 	};
-}
\ No newline at end of file
+}
+
+VH_REGISTER_COMPONENT(VulkanHelper::ScriptComponent, "ScriptComponent");
+VH_REGISTER_COMPONENT(VulkanHelper::TransformComponent, "TransformComponent");
+VH_REGISTER_COMPONENT(VulkanHelper::NameComponent, "NameComponent");
@@ -37,6 +37,13 @@ namespace VulkanHelper
 			return m_Scene->GetRegistry().get<T>(m_Handle);
 		}
 
+		// Modifies the component through func and notifies on_update listeners, writes through GetComponent() don't
+		template<typename T, typename... Func>
+		T& PatchComponent(Func&&... func)
+		{
+			return m_Scene->GetRegistry().patch<T>(m_Handle, std::forward<Func>(func)...);
+		}
+
 		inline Scene* GetScene() const { return m_Scene; }
 
 		operator entt::entity() const { return m_Handle; }
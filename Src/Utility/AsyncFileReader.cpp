@@ -0,0 +1,448 @@
+#include "pch.h"
+#include "AsyncFileReader.h"
+
+#include "Logger/Logger.h"
+
+#ifdef LIN
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace VulkanHelper
+{
+	AsyncFileReader::~AsyncFileReader()
+	{
+		Destroy();
+	}
+
+	void AsyncFileReader::Init(const CreateInfo& createInfo)
+	{
+		Destroy();
+
+		m_Stop = false;
+
+		if (InitRing(createInfo.QueueDepth))
+		{
+			m_Threads.emplace_back([this] { CompletionWorker(); });
+		}
+		else
+		{
+			for (uint32_t i = 0; i < std::max(createInfo.FallbackThreadCount, 1u); i++)
+			{
+				m_Threads.emplace_back([this] { FallbackWorker(); });
+			}
+		}
+
+		m_Initialized = true;
+	}
+
+	void AsyncFileReader::Read(const std::string& path, ReadCallback callback)
+	{
+		VH_ASSERT(m_Initialized, "AsyncFileReader has to be initialized before reading!");
+
+		std::unique_ptr<ReadRequest> request = std::make_unique<ReadRequest>();
+		request->Path = path;
+		request->Callback = std::move(callback);
+		m_PendingCount++;
+
+		if (!IsUsingIoUring())
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Queue.push_back(std::move(request));
+			lock.unlock();
+			m_CV.notify_one();
+			return;
+		}
+
+		// Opening and sizing the buffer happen on the completion thread too, the caller only queues the request.
+		// The completion thread takes every queued open at once, so it only has to be woken for the first one
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		bool wake = m_OpenQueue.empty();
+		m_OpenQueue.push_back(std::move(request));
+		if (wake)
+			WakeCompletionWorker();
+	}
+
+	void AsyncFileReader::WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_IdleCV.wait(lock, [this] { return m_PendingCount == 0; });
+	}
+
+	void AsyncFileReader::Finish(std::unique_ptr<ReadRequest> request, bool success)
+	{
+#ifdef LIN
+		if (request->FileDescriptor >= 0)
+			close(request->FileDescriptor);
+		request->FileDescriptor = -1;
+#endif
+
+		if (!success)
+			VH_ERROR("Failed to read file: {}", request->Path);
+
+		request->Callback(success, request->Data);
+		request.reset();
+
+		if (m_PendingCount.fetch_sub(1) == 1)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_IdleCV.notify_all();
+		}
+	}
+
+	bool AsyncFileReader::ReadBlocking(ReadRequest* request)
+	{
+		std::ifstream file(request->Path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return false;
+
+		request->Data.resize((size_t)file.tellg());
+		file.seekg(0);
+		file.read((char*)request->Data.data(), request->Data.size());
+
+		return !file.fail();
+	}
+
+	void AsyncFileReader::FallbackWorker()
+	{
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_CV.wait(lock, [this] { return m_Stop || !m_Queue.empty(); });
+			if (m_Stop && m_Queue.empty())
+				return;
+
+			std::unique_ptr<ReadRequest> request = std::move(m_Queue.front());
+			m_Queue.pop_front();
+			lock.unlock();
+
+			bool success = ReadBlocking(request.get());
+			Finish(std::move(request), success);
+		}
+	}
+
+	void AsyncFileReader::Destroy()
+	{
+		if (!m_Initialized)
+			return;
+
+		WaitIdle();
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+
+		// The completion thread sleeps inside the kernel, a NOP wakes it up
+		if (IsUsingIoUring())
+			WakeCompletionWorker();
+		lock.unlock();
+		m_CV.notify_all();
+
+		for (std::thread& thread : m_Threads)
+		{
+			thread.join();
+		}
+		m_Threads.clear();
+
+		DestroyRing();
+
+		m_Initialized = false;
+	}
+
+#ifdef LIN
+	static int IoUringEnter(int ringFd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags)
+	{
+		return (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+	}
+
+	bool AsyncFileReader::InitRing(uint32_t queueDepth)
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+
+		int ringFd = (int)syscall(__NR_io_uring_setup, queueDepth, &params);
+		if (ringFd < 0)
+		{
+			// Old kernels and most container seccomp profiles end up here
+			VH_WARN("io_uring unavailable ({}), falling back to blocking reads on I/O threads", strerror(errno));
+			return false;
+		}
+
+		m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMap)
+		{
+			m_SqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+			m_CqRingSize = m_SqRingSize;
+		}
+
+		m_SqRing = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+		if (m_SqRing == MAP_FAILED)
+		{
+			m_SqRing = nullptr;
+			close(ringFd);
+			return false;
+		}
+
+		if (singleMap)
+		{
+			m_CqRing = m_SqRing;
+		}
+		else
+		{
+			m_CqRing = mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+			if (m_CqRing == MAP_FAILED)
+			{
+				m_CqRing = nullptr;
+				munmap(m_SqRing, m_SqRingSize);
+				m_SqRing = nullptr;
+				close(ringFd);
+				return false;
+			}
+		}
+
+		m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		m_Sqes = mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (m_Sqes == MAP_FAILED)
+		{
+			m_Sqes = nullptr;
+			if (!singleMap)
+				munmap(m_CqRing, m_CqRingSize);
+			munmap(m_SqRing, m_SqRingSize);
+			m_SqRing = nullptr;
+			m_CqRing = nullptr;
+			close(ringFd);
+			return false;
+		}
+
+		uint8_t* sq = (uint8_t*)m_SqRing;
+		m_SqHead = (uint32_t*)(sq + params.sq_off.head);
+		m_SqTail = (uint32_t*)(sq + params.sq_off.tail);
+		m_SqMask = (uint32_t*)(sq + params.sq_off.ring_mask);
+		m_SqArray = (uint32_t*)(sq + params.sq_off.array);
+
+		uint8_t* cq = (uint8_t*)m_CqRing;
+		m_CqHead = (uint32_t*)(cq + params.cq_off.head);
+		m_CqTail = (uint32_t*)(cq + params.cq_off.tail);
+		m_CqMask = (uint32_t*)(cq + params.cq_off.ring_mask);
+		m_Cqes = cq + params.cq_off.cqes;
+
+		m_RingFd = ringFd;
+		m_RingEntries = params.sq_entries;
+		m_InFlight = 0;
+
+		return true;
+	}
+
+	void AsyncFileReader::DestroyRing()
+	{
+		if (m_RingFd < 0)
+			return;
+
+		munmap(m_Sqes, m_SqesSize);
+		if (m_CqRing != m_SqRing)
+			munmap(m_CqRing, m_CqRingSize);
+		munmap(m_SqRing, m_SqRingSize);
+		close(m_RingFd);
+
+		m_RingFd = -1;
+		m_SqRing = nullptr;
+		m_CqRing = nullptr;
+		m_Sqes = nullptr;
+	}
+
+	bool AsyncFileReader::OpenForRing(ReadRequest* request)
+	{
+		request->FileDescriptor = open(request->Path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (request->FileDescriptor < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(request->FileDescriptor, &fileStat) != 0)
+			return false;
+
+		request->Data.resize((size_t)fileStat.st_size);
+		return true;
+	}
+
+	// Completion thread only, files are opened without holding m_Mutex so Read() never waits on them
+	void AsyncFileReader::OpenPending()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		std::deque<std::unique_ptr<ReadRequest>> requests = std::move(m_OpenQueue);
+		m_OpenQueue.clear();
+		lock.unlock();
+
+		for (std::unique_ptr<ReadRequest>& request : requests)
+		{
+			if (!OpenForRing(request.get()))
+			{
+				Finish(std::move(request), false);
+				continue;
+			}
+
+			if (request->Data.empty())
+			{
+				Finish(std::move(request), true);
+				continue;
+			}
+
+			lock.lock();
+			m_Queue.push_back(std::move(request));
+			lock.unlock();
+		}
+	}
+
+	// Has to be called with m_Mutex locked
+	void AsyncFileReader::SubmitPending()
+	{
+		// CQ is twice the SQ size, so limiting in flight reads to the SQ size means completions can't overflow
+		uint32_t submitted = 0;
+		while (!m_Queue.empty() && m_InFlight < m_RingEntries)
+		{
+			if (!SubmitToRing(m_Queue.front().get()))
+				break;
+
+			// Owned by the ring until its completion arrives
+			(void)m_Queue.front().release();
+			m_Queue.pop_front();
+			m_InFlight++;
+			submitted++;
+		}
+
+		if (submitted > 0)
+			IoUringEnter(m_RingFd, submitted, 0, 0);
+	}
+
+	// Has to be called with m_Mutex locked, request of nullptr submits a NOP
+	bool AsyncFileReader::SubmitToRing(ReadRequest* request)
+	{
+		uint32_t tail = *m_SqTail;
+		uint32_t head = std::atomic_ref<uint32_t>(*m_SqHead).load(std::memory_order_acquire);
+		if (tail - head >= m_RingEntries)
+			return false;
+
+		uint32_t index = tail & *m_SqMask;
+		io_uring_sqe* sqe = (io_uring_sqe*)m_Sqes + index;
+		memset(sqe, 0, sizeof(io_uring_sqe));
+
+		if (request)
+		{
+			// Single reads are capped below 2GB, larger files are read in several steps
+			size_t remaining = request->Data.size() - request->Offset;
+			sqe->opcode = IORING_OP_READ;
+			sqe->fd = request->FileDescriptor;
+			sqe->addr = (uint64_t)(request->Data.data() + request->Offset);
+			sqe->len = (uint32_t)std::min<size_t>(remaining, 1u << 30);
+			sqe->off = request->Offset;
+			sqe->user_data = (uint64_t)request;
+		}
+		else
+		{
+			sqe->opcode = IORING_OP_NOP;
+			sqe->user_data = 0;
+		}
+
+		m_SqArray[index] = index;
+		std::atomic_ref<uint32_t>(*m_SqTail).store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Has to be called with m_Mutex locked
+	void AsyncFileReader::WakeCompletionWorker()
+	{
+		SubmitToRing(nullptr);
+		IoUringEnter(m_RingFd, 1, 0, 0);
+	}
+
+	void AsyncFileReader::CompletionWorker()
+	{
+		while (true)
+		{
+			int res = IoUringEnter(m_RingFd, 0, 1, IORING_ENTER_GETEVENTS);
+			if (res < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			{
+				VH_ERROR("io_uring_enter failed: {}", strerror(errno));
+				return;
+			}
+
+			bool wakeUp = false;
+			uint32_t head = *m_CqHead;
+			uint32_t tail = std::atomic_ref<uint32_t>(*m_CqTail).load(std::memory_order_acquire);
+			while (head != tail)
+			{
+				io_uring_cqe cqe = ((io_uring_cqe*)m_Cqes)[head & *m_CqMask];
+				head++;
+				std::atomic_ref<uint32_t>(*m_CqHead).store(head, std::memory_order_release);
+
+				if (cqe.user_data == 0)
+				{
+					wakeUp = true;
+					continue;
+				}
+
+				ReadRequest* request = (ReadRequest*)cqe.user_data;
+				bool done = true;
+				bool success = false;
+				if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)
+				{
+					// Kernels before 5.6 don't know IORING_OP_READ
+					success = ReadBlocking(request);
+				}
+				else if (cqe.res > 0)
+				{
+					request->Offset += (size_t)cqe.res;
+					success = true;
+					done = request->Offset >= request->Data.size();
+				}
+
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				if (!done)
+				{
+					// Short read, ask for the rest
+					if (SubmitToRing(request))
+					{
+						IoUringEnter(m_RingFd, 1, 0, 0);
+						continue;
+					}
+
+					// SQ is still full, an earlier enter can fail with EAGAIN or EBUSY and leave its entries unconsumed.
+					// Dropping the request would leave its callback uncalled forever, so the rest is read right here
+					lock.unlock();
+					success = ReadBlocking(request);
+					lock.lock();
+				}
+
+				m_InFlight--;
+				lock.unlock();
+
+				Finish(std::unique_ptr<ReadRequest>(request), success);
+			}
+
+			OpenPending();
+
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			SubmitPending();
+
+			if (wakeUp && m_Stop && m_InFlight == 0 && m_Queue.empty() && m_OpenQueue.empty())
+				return;
+		}
+	}
+#else
+	bool AsyncFileReader::InitRing(uint32_t queueDepth) { return false; }
+	void AsyncFileReader::DestroyRing() {}
+	bool AsyncFileReader::OpenForRing(ReadRequest* request) { return false; }
+	void AsyncFileReader::OpenPending() {}
+	void AsyncFileReader::SubmitPending() {}
+	bool AsyncFileReader::SubmitToRing(ReadRequest* request) { return false; }
+	void AsyncFileReader::WakeCompletionWorker() {}
+	void AsyncFileReader::CompletionWorker() {}
+#endif
+}
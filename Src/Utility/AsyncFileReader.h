@@ -0,0 +1,107 @@
+#pragma once
+#include "Pch.h"
+
+#include <deque>
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Reads whole files in the background with many reads in flight at once.
+	 *
+	 * On Linux reads go through io_uring, everywhere else (or when the kernel doesn't allow io_uring) a small
+	 * set of dedicated I/O threads does blocking reads so worker threads of other pools never wait on the disk.
+	 */
+	class AsyncFileReader
+	{
+	public:
+		// Called once per read from an I/O thread as soon as the bytes arrive, data can be moved out.
+		// Keep it short and hand heavy work like decoding over to another pool.
+		using ReadCallback = std::function<void(bool success, std::vector<uint8_t>& data)>;
+
+		struct CreateInfo
+		{
+			uint32_t QueueDepth = 64; // Max reads submitted to the kernel at once
+			uint32_t FallbackThreadCount = 4; // Used when io_uring isn't available
+		};
+
+		AsyncFileReader() = default;
+		AsyncFileReader(const CreateInfo& createInfo) { Init(createInfo); }
+		~AsyncFileReader();
+
+		void Init(const CreateInfo& createInfo);
+
+		AsyncFileReader(const AsyncFileReader& other) = delete;
+		AsyncFileReader& operator=(const AsyncFileReader& other) = delete;
+		AsyncFileReader(AsyncFileReader&& other) = delete;
+		AsyncFileReader& operator=(AsyncFileReader&& other) = delete;
+
+	public:
+
+		void Read(const std::string& path, ReadCallback callback);
+
+		// Blocks until every read requested so far has finished and its callback returned
+		void WaitIdle();
+
+		[[nodiscard]] inline bool IsUsingIoUring() const { return m_RingFd >= 0; }
+		[[nodiscard]] inline bool IsInitialized() const { return m_Initialized; }
+		[[nodiscard]] inline uint32_t GetPendingCount() const { return m_PendingCount; }
+
+	private:
+		struct ReadRequest
+		{
+			std::string Path;
+			int FileDescriptor = -1;
+			std::vector<uint8_t> Data;
+			size_t Offset = 0;
+			ReadCallback Callback;
+		};
+
+		void Finish(std::unique_ptr<ReadRequest> request, bool success);
+		static bool ReadBlocking(ReadRequest* request);
+
+		// Fallback
+		void FallbackWorker();
+
+		// io_uring, only implemented on LIN
+		bool InitRing(uint32_t queueDepth);
+		void DestroyRing();
+		bool OpenForRing(ReadRequest* request);
+		void OpenPending();
+		void SubmitPending();
+		bool SubmitToRing(ReadRequest* request);
+		void WakeCompletionWorker();
+		void CompletionWorker();
+
+		bool m_Initialized = false;
+		std::atomic<uint32_t> m_PendingCount = 0; // Requested but not finished reads
+
+		std::mutex m_Mutex;
+		std::condition_variable m_CV;
+		std::condition_variable m_IdleCV;
+		std::deque<std::unique_ptr<ReadRequest>> m_Queue; // Not yet submitted requests
+		std::deque<std::unique_ptr<ReadRequest>> m_OpenQueue; // io_uring only, not yet opened requests
+		bool m_Stop = false;
+
+		std::vector<std::thread> m_Threads;
+
+		int m_RingFd = -1;
+		uint32_t m_RingEntries = 0;
+		uint32_t m_InFlight = 0;
+		void* m_SqRing = nullptr;
+		void* m_CqRing = nullptr;
+		void* m_Sqes = nullptr;
+		size_t m_SqRingSize = 0;
+		size_t m_CqRingSize = 0;
+		size_t m_SqesSize = 0;
+		uint32_t* m_SqHead = nullptr;
+		uint32_t* m_SqTail = nullptr;
+		uint32_t* m_SqMask = nullptr;
+		uint32_t* m_SqArray = nullptr;
+		uint32_t* m_CqHead = nullptr;
+		uint32_t* m_CqTail = nullptr;
+		uint32_t* m_CqMask = nullptr;
+		void* m_Cqes = nullptr;
+
+		void Destroy();
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Pch.h"
+
+#include <cstring>
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Bounds checked reads from a byte range, usually a mapped file.
+	 *
+	 * Every read returns false or null instead of reading past the end, so corrupted files can be rejected without
+	 * validating every size up front. Values are read as stored, little endian and unaligned.
+	 */
+	struct ByteReader
+	{
+		const uint8_t* Data = nullptr;
+		size_t Size = 0;
+		size_t Offset = 0;
+
+		inline bool Read(void* outValue, size_t size)
+		{
+			if (size > Size - Offset)
+				return false;
+
+			memcpy(outValue, Data + Offset, size);
+			Offset += size;
+			return true;
+		}
+
+		template<typename T>
+		inline bool Read(T* outValue) { return Read(outValue, sizeof(T)); }
+
+		// uint32_t length followed by the characters
+		inline bool ReadString(std::string* outString)
+		{
+			uint32_t length;
+			if (!Read(&length) || length > Size - Offset)
+				return false;
+
+			outString->assign((const char*)Data + Offset, length);
+			Offset += length;
+			return true;
+		}
+
+		// Null terminated, the view points into the data and doesn't include the terminator
+		inline bool ReadCString(std::string_view* outString)
+		{
+			const void* end = memchr(Data + Offset, '\0', Size - Offset);
+			if (end == nullptr)
+				return false;
+
+			size_t length = (size_t)((const uint8_t*)end - (Data + Offset));
+			*outString = std::string_view((const char*)Data + Offset, length);
+			Offset += length + 1;
+			return true;
+		}
+
+		// Returns a pointer to count elements of elementSize bytes and skips them
+		inline const uint8_t* Skip(uint64_t count, size_t elementSize)
+		{
+			if (elementSize != 0 && count > (Size - Offset) / elementSize)
+				return nullptr;
+
+			const uint8_t* data = Data + Offset;
+			Offset += (size_t)count * elementSize;
+			return data;
+		}
+
+		// Skips padding up to the next multiple of alignment, offsets count from the start of the data
+		inline bool Align(size_t alignment)
+		{
+			size_t padding = (alignment - Offset % alignment) % alignment;
+			return Skip(padding, 1) != nullptr;
+		}
+
+		[[nodiscard]] inline bool IsAtEnd() const { return Offset == Size; }
+	};
+}
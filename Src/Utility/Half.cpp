@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "Half.h"
+
+#include <cstring>
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(_M_X64))
+#define VH_HAS_F16C_INTRINSICS
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace VulkanHelper
+{
+	static inline uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(float));
+		return bits;
+	}
+
+	uint16_t Half::FromFloat(float value)
+	{
+		uint32_t bits = FloatBits(value);
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t absBits = bits & 0x7FFFFFFF;
+
+		if (absBits >= 0x7F800000) // Inf or NaN
+			return (uint16_t)(sign | 0x7C00 | (absBits > 0x7F800000 ? 0x0200 : 0));
+
+		if (absBits >= 0x477FF000) // Rounds to a value larger than the max half, clamp to Inf
+			return (uint16_t)(sign | 0x7C00);
+
+		if (absBits < 0x38800000) // Denormal half or zero
+		{
+			if (absBits < 0x33000000) // Too small, flushes to zero
+				return (uint16_t)sign;
+
+			uint32_t exponent = absBits >> 23;
+			uint32_t mantissa = (absBits & 0x007FFFFF) | 0x00800000;
+			uint32_t shift = 126 - exponent;
+			uint32_t halfMantissa = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (halfMantissa & 1)))
+				halfMantissa++;
+
+			return (uint16_t)(sign | halfMantissa);
+		}
+
+		// Normal, rebias the exponent and round the mantissa to nearest even
+		uint32_t rounded = absBits + 0x00000FFF + ((absBits >> 13) & 1);
+		return (uint16_t)(sign | ((rounded - 0x38000000) >> 13));
+	}
+
+	float Half::ToFloat(uint16_t value)
+	{
+		uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+		uint32_t exponent = (value >> 10) & 0x1F;
+		uint32_t mantissa = value & 0x03FF;
+
+		uint32_t bits;
+		if (exponent == 0)
+		{
+			if (mantissa == 0)
+			{
+				bits = sign;
+			}
+			else
+			{
+				// Denormal, normalize it
+				exponent = 113;
+				while ((mantissa & 0x0400) == 0)
+				{
+					mantissa <<= 1;
+					exponent--;
+				}
+				mantissa &= 0x03FF;
+				bits = sign | (exponent << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 31)
+		{
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		}
+		else
+		{
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+
+		float result;
+		memcpy(&result, &bits, sizeof(float));
+		return result;
+	}
+
+#ifdef VH_HAS_F16C_INTRINSICS
+	static bool CpuSupportsF16C()
+	{
+#if defined(__F16C__)
+		return true;
+#else
+		int info[4];
+		__cpuid(info, 1);
+		bool f16c = (info[2] & (1 << 29)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		return f16c && avx;
+#endif
+	}
+#endif
+
+	void Half::FromFloats(const float* src, uint16_t* dst, size_t count)
+	{
+		size_t i = 0;
+
+#ifdef VH_HAS_F16C_INTRINSICS
+		static const bool s_HasF16C = CpuSupportsF16C();
+		if (s_HasF16C)
+		{
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 floats = _mm256_loadu_ps(src + i);
+				__m128i halfs = _mm256_cvtps_ph(floats, _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128((__m128i*)(dst + i), halfs);
+			}
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			dst[i] = FromFloat(src[i]);
+		}
+	}
+
+	// Converts a non negative float into an unsigned float with 5 exponent bits and mantissaBits mantissa bits
+	static inline uint32_t ToSmallUnsignedFloat(float value, uint32_t mantissaBits)
+	{
+		uint32_t bits = FloatBits(value);
+		if (bits & 0x80000000) // Negative values and -0 clamp to 0
+			return 0;
+
+		uint32_t maxValue = (0x1Eu << mantissaBits) | ((1u << mantissaBits) - 1);
+		if ((bits & 0x7FFFFFFF) > 0x7F800000) // NaN
+			return (0x1Fu << mantissaBits) | 1;
+
+		if (bits >= 0x7F800000) // Inf
+			return 0x1Fu << mantissaBits;
+
+		uint32_t dropBits = 23 - mantissaBits;
+		if (bits < 0x38800000) // Denormal or zero
+		{
+			uint32_t exponent = bits >> 23;
+			if (exponent < 113 - mantissaBits)
+				return 0;
+
+			uint32_t mantissa = (bits & 0x007FFFFF) | 0x00800000;
+			return mantissa >> (dropBits + 113 - exponent);
+		}
+
+		uint32_t rounded = bits + ((1u << (dropBits - 1)) - 1) + ((bits >> dropBits) & 1);
+		uint32_t result = (rounded - 0x38000000) >> dropBits;
+		return result > maxValue ? maxValue : result;
+	}
+
+	void Half::ToB10G11R11(const float* srcRGBA, uint32_t* dst, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const float* pixel = srcRGBA + i * 4;
+			uint32_t r = ToSmallUnsignedFloat(pixel[0], 6);
+			uint32_t g = ToSmallUnsignedFloat(pixel[1], 6);
+			uint32_t b = ToSmallUnsignedFloat(pixel[2], 5);
+			dst[i] = r | (g << 11) | (b << 22);
+		}
+	}
+}
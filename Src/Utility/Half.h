@@ -0,0 +1,24 @@
+#pragma once
+#include "pch.h"
+
+namespace VulkanHelper
+{
+	class Half
+	{
+	public:
+		static uint16_t FromFloat(float value);
+		static float ToFloat(uint16_t value);
+
+		/**
+		 * @brief Converts count floats to IEEE half floats (round to nearest even).
+		 *
+		 * Uses F16C 8 values at a time when the CPU supports it and falls back to a scalar loop otherwise.
+		 */
+		static void FromFloats(const float* src, uint16_t* dst, size_t count);
+
+		/**
+		 * @brief Packs RGBA float pixels into VK_FORMAT_B10G11R11_UFLOAT_PACK32, alpha is dropped.
+		 */
+		static void ToB10G11R11(const float* srcRGBA, uint32_t* dst, size_t pixelCount);
+	};
+}
@@ -0,0 +1,116 @@
+#include "pch.h"
+#include "Hash.h"
+
+#include <cstring>
+
+namespace VulkanHelper
+{
+	static constexpr uint64_t s_Prime1 = 0x9E3779B185EBCA87ULL;
+	static constexpr uint64_t s_Prime2 = 0xC2B2AE3D27D4EB4FULL;
+	static constexpr uint64_t s_Prime3 = 0x165667B19E3779F9ULL;
+	static constexpr uint64_t s_Prime4 = 0x85EBCA77C2B2AE63ULL;
+	static constexpr uint64_t s_Prime5 = 0x27D4EB2F165667C5ULL;
+
+	static inline uint64_t RotateLeft(uint64_t value, int count)
+	{
+		return (value << count) | (value >> (64 - count));
+	}
+
+	static inline uint64_t Read64(const uint8_t* ptr)
+	{
+		uint64_t value;
+		memcpy(&value, ptr, sizeof(uint64_t));
+		return value;
+	}
+
+	static inline uint32_t Read32(const uint8_t* ptr)
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(uint32_t));
+		return value;
+	}
+
+	static inline uint64_t Round(uint64_t acc, uint64_t input)
+	{
+		acc += input * s_Prime2;
+		acc = RotateLeft(acc, 31);
+		return acc * s_Prime1;
+	}
+
+	static inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+	{
+		acc ^= Round(0, value);
+		return acc * s_Prime1 + s_Prime4;
+	}
+
+	uint64_t Hash::XXH64(const void* data, size_t size, uint64_t seed /*= 0*/)
+	{
+		const uint8_t* ptr = (const uint8_t*)data;
+		const uint8_t* end = ptr + size;
+		uint64_t hash;
+
+		if (size >= 32)
+		{
+			const uint8_t* limit = end - 32;
+			uint64_t v1 = seed + s_Prime1 + s_Prime2;
+			uint64_t v2 = seed + s_Prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - s_Prime1;
+
+			do
+			{
+				v1 = Round(v1, Read64(ptr)); ptr += 8;
+				v2 = Round(v2, Read64(ptr)); ptr += 8;
+				v3 = Round(v3, Read64(ptr)); ptr += 8;
+				v4 = Round(v4, Read64(ptr)); ptr += 8;
+			} while (ptr <= limit);
+
+			hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+			hash = MergeRound(hash, v1);
+			hash = MergeRound(hash, v2);
+			hash = MergeRound(hash, v3);
+			hash = MergeRound(hash, v4);
+		}
+		else
+		{
+			hash = seed + s_Prime5;
+		}
+
+		hash += (uint64_t)size;
+
+		while (ptr + 8 <= end)
+		{
+			hash ^= Round(0, Read64(ptr));
+			hash = RotateLeft(hash, 27) * s_Prime1 + s_Prime4;
+			ptr += 8;
+		}
+
+		if (ptr + 4 <= end)
+		{
+			hash ^= (uint64_t)Read32(ptr) * s_Prime1;
+			hash = RotateLeft(hash, 23) * s_Prime2 + s_Prime3;
+			ptr += 4;
+		}
+
+		while (ptr < end)
+		{
+			hash ^= (uint64_t)(*ptr) * s_Prime5;
+			hash = RotateLeft(hash, 11) * s_Prime1;
+			ptr++;
+		}
+
+		// Final avalanche
+		hash ^= hash >> 33;
+		hash *= s_Prime2;
+		hash ^= hash >> 29;
+		hash *= s_Prime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	uint64_t Hash::Combine(uint64_t hash, uint64_t value)
+	{
+		return MergeRound(hash, value);
+	}
+}
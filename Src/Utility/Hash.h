@@ -0,0 +1,33 @@
+#pragma once
+#include "pch.h"
+
+namespace VulkanHelper
+{
+	class Hash
+	{
+	public:
+		/**
+		 * @brief 64-bit xxHash (XXH64) of the given bytes.
+		 *
+		 * Unlike std::hash the result doesn't depend on the compiler, platform or run, so it's safe to store on disk.
+		 */
+		static uint64_t XXH64(const void* data, size_t size, uint64_t seed = 0);
+
+		static inline uint64_t XXH64(const std::string& str, uint64_t seed = 0) { return XXH64(str.data(), str.size(), seed); }
+
+		static uint64_t Combine(uint64_t hash, uint64_t value);
+
+		// 64-bit FNV-1a, slower than XXH64 but usable at compile time, meant for short strings like type names
+		static constexpr uint64_t FNV1a(std::string_view str)
+		{
+			uint64_t hash = 0xCBF29CE484222325ULL;
+			for (char c : str)
+			{
+				hash ^= (uint8_t)c;
+				hash *= 0x100000001B3ULL;
+			}
+
+			return hash;
+		}
+	};
+}
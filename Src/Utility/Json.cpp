@@ -0,0 +1,384 @@
+#include "Pch.h"
+#include "Json.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace VulkanHelper
+{
+	class JsonParser
+	{
+	public:
+		JsonParser(const char* data, size_t size) : m_Cursor(data), m_End(data + size) {}
+
+		bool ParseDocument(JsonValue* outValue)
+		{
+			Consume("\xEF\xBB\xBF"); // UTF-8 BOM
+			SkipWhitespace();
+			if (!ParseValue(outValue, 0))
+				return false;
+
+			SkipWhitespace();
+			if (m_Cursor != m_End)
+				return Fail("Unexpected data after the root value");
+
+			return true;
+		}
+
+		inline const std::string& GetError() const { return m_Error; }
+
+	private:
+		// Deeper documents are rejected instead of overflowing the stack
+		inline static constexpr uint32_t s_MaxDepth = 256;
+
+		const char* m_Cursor;
+		const char* m_End;
+		const char* m_Begin = m_Cursor;
+		std::string m_Error;
+
+		bool Fail(const char* message)
+		{
+			m_Error = std::string(message) + " at offset " + std::to_string(m_Cursor - m_Begin);
+			return false;
+		}
+
+		void SkipWhitespace()
+		{
+			while (m_Cursor < m_End && (*m_Cursor == ' ' || *m_Cursor == '\t' || *m_Cursor == '\n' || *m_Cursor == '\r'))
+				m_Cursor++;
+		}
+
+		bool Consume(const char* literal)
+		{
+			size_t length = strlen(literal);
+			if ((size_t)(m_End - m_Cursor) < length || memcmp(m_Cursor, literal, length) != 0)
+				return false;
+
+			m_Cursor += length;
+			return true;
+		}
+
+		bool ParseValue(JsonValue* outValue, uint32_t depth)
+		{
+			if (depth > s_MaxDepth)
+				return Fail("Document is nested too deep");
+
+			if (m_Cursor == m_End)
+				return Fail("Unexpected end of document");
+
+			switch (*m_Cursor)
+			{
+			case '{': return ParseObject(outValue, depth);
+			case '[': return ParseArray(outValue, depth);
+			case '"':
+				outValue->m_Type = JsonValue::Type::String;
+				return ParseString(&outValue->m_String);
+			case 't':
+				if (!Consume("true"))
+					return Fail("Invalid literal");
+				outValue->m_Type = JsonValue::Type::Bool;
+				outValue->m_Bool = true;
+				return true;
+			case 'f':
+				if (!Consume("false"))
+					return Fail("Invalid literal");
+				outValue->m_Type = JsonValue::Type::Bool;
+				outValue->m_Bool = false;
+				return true;
+			case 'n':
+				if (!Consume("null"))
+					return Fail("Invalid literal");
+				outValue->m_Type = JsonValue::Type::Null;
+				return true;
+			default:
+				return ParseNumber(outValue);
+			}
+		}
+
+		bool ParseNumber(JsonValue* outValue)
+		{
+			// from_chars doesn't accept a leading '+' and is locale independent, which is exactly JSON
+			std::from_chars_result result = std::from_chars(m_Cursor, m_End, outValue->m_Number);
+			if (result.ec != std::errc() || result.ptr == m_Cursor)
+				return Fail("Invalid number");
+
+			m_Cursor = result.ptr;
+			outValue->m_Type = JsonValue::Type::Number;
+			return true;
+		}
+
+		static void AppendUTF8(uint32_t codepoint, std::string* outString)
+		{
+			if (codepoint < 0x80)
+			{
+				outString->push_back((char)codepoint);
+			}
+			else if (codepoint < 0x800)
+			{
+				outString->push_back((char)(0xC0 | (codepoint >> 6)));
+				outString->push_back((char)(0x80 | (codepoint & 0x3F)));
+			}
+			else if (codepoint < 0x10000)
+			{
+				outString->push_back((char)(0xE0 | (codepoint >> 12)));
+				outString->push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+				outString->push_back((char)(0x80 | (codepoint & 0x3F)));
+			}
+			else
+			{
+				outString->push_back((char)(0xF0 | (codepoint >> 18)));
+				outString->push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+				outString->push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+				outString->push_back((char)(0x80 | (codepoint & 0x3F)));
+			}
+		}
+
+		bool ParseHex4(uint32_t* outValue)
+		{
+			if (m_End - m_Cursor < 4)
+				return Fail("Truncated unicode escape");
+
+			std::from_chars_result result = std::from_chars(m_Cursor, m_Cursor + 4, *outValue, 16);
+			if (result.ec != std::errc() || result.ptr != m_Cursor + 4)
+				return Fail("Invalid unicode escape");
+
+			m_Cursor += 4;
+			return true;
+		}
+
+		bool ParseString(std::string* outString)
+		{
+			m_Cursor++; // Opening quote
+
+			// Most strings have no escapes, those are copied in one go
+			const char* runStart = m_Cursor;
+			while (true)
+			{
+				if (m_Cursor == m_End)
+					return Fail("Unterminated string");
+
+				char c = *m_Cursor;
+				if (c == '"')
+				{
+					outString->append(runStart, m_Cursor);
+					m_Cursor++;
+					return true;
+				}
+
+				if (c != '\\')
+				{
+					m_Cursor++;
+					continue;
+				}
+
+				outString->append(runStart, m_Cursor);
+				m_Cursor++;
+				if (m_Cursor == m_End)
+					return Fail("Unterminated string");
+
+				char escape = *m_Cursor++;
+				switch (escape)
+				{
+				case '"': outString->push_back('"'); break;
+				case '\\': outString->push_back('\\'); break;
+				case '/': outString->push_back('/'); break;
+				case 'b': outString->push_back('\b'); break;
+				case 'f': outString->push_back('\f'); break;
+				case 'n': outString->push_back('\n'); break;
+				case 'r': outString->push_back('\r'); break;
+				case 't': outString->push_back('\t'); break;
+				case 'u':
+				{
+					uint32_t codepoint;
+					if (!ParseHex4(&codepoint))
+						return false;
+
+					// Surrogate pair
+					if (codepoint >= 0xD800 && codepoint <= 0xDBFF && Consume("\\u"))
+					{
+						uint32_t low;
+						if (!ParseHex4(&low))
+							return false;
+
+						if (low >= 0xDC00 && low <= 0xDFFF)
+							codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+
+					AppendUTF8(codepoint, outString);
+					break;
+				}
+				default:
+					return Fail("Invalid escape sequence");
+				}
+
+				runStart = m_Cursor;
+			}
+		}
+
+		bool ParseArray(JsonValue* outValue, uint32_t depth)
+		{
+			m_Cursor++;
+			outValue->m_Type = JsonValue::Type::Array;
+
+			SkipWhitespace();
+			if (m_Cursor < m_End && *m_Cursor == ']')
+			{
+				m_Cursor++;
+				return true;
+			}
+
+			while (true)
+			{
+				SkipWhitespace();
+				JsonValue& element = outValue->m_Elements.emplace_back();
+				if (!ParseValue(&element, depth + 1))
+					return false;
+
+				SkipWhitespace();
+				if (m_Cursor == m_End)
+					return Fail("Unterminated array");
+
+				char c = *m_Cursor++;
+				if (c == ']')
+					return true;
+				if (c != ',')
+					return Fail("Expected ',' or ']'");
+			}
+		}
+
+		bool ParseObject(JsonValue* outValue, uint32_t depth)
+		{
+			m_Cursor++;
+			outValue->m_Type = JsonValue::Type::Object;
+
+			SkipWhitespace();
+			if (m_Cursor < m_End && *m_Cursor == '}')
+			{
+				m_Cursor++;
+				return true;
+			}
+
+			while (true)
+			{
+				SkipWhitespace();
+				if (m_Cursor == m_End || *m_Cursor != '"')
+					return Fail("Expected member name");
+
+				std::pair<std::string, JsonValue>& member = outValue->m_Members.emplace_back();
+				if (!ParseString(&member.first))
+					return false;
+
+				SkipWhitespace();
+				if (m_Cursor == m_End || *m_Cursor != ':')
+					return Fail("Expected ':'");
+				m_Cursor++;
+
+				SkipWhitespace();
+				if (!ParseValue(&member.second, depth + 1))
+					return false;
+
+				SkipWhitespace();
+				if (m_Cursor == m_End)
+					return Fail("Unterminated object");
+
+				char c = *m_Cursor++;
+				if (c == '}')
+					return true;
+				if (c != ',')
+					return Fail("Expected ',' or '}'");
+			}
+		}
+	};
+}
+
+bool VulkanHelper::JsonValue::Parse(const char* data, size_t size, JsonValue* outValue, std::string* outError /*= nullptr*/)
+{
+	*outValue = JsonValue();
+
+	JsonParser parser(data, size);
+	if (parser.ParseDocument(outValue))
+		return true;
+
+	if (outError)
+		*outError = parser.GetError();
+
+	*outValue = JsonValue();
+	return false;
+}
+
+size_t VulkanHelper::JsonValue::GetSize() const
+{
+	if (m_Type == Type::Array)
+		return m_Elements.size();
+	if (m_Type == Type::Object)
+		return m_Members.size();
+
+	return 0;
+}
+
+bool VulkanHelper::JsonValue::Has(std::string_view key) const
+{
+	for (const std::pair<std::string, JsonValue>& member : m_Members)
+	{
+		if (member.first == key)
+			return true;
+	}
+
+	return false;
+}
+
+const VulkanHelper::JsonValue& VulkanHelper::JsonValue::operator[](std::string_view key) const
+{
+	static const JsonValue s_Null;
+
+	for (const std::pair<std::string, JsonValue>& member : m_Members)
+	{
+		if (member.first == key)
+			return member.second;
+	}
+
+	return s_Null;
+}
+
+const VulkanHelper::JsonValue& VulkanHelper::JsonValue::operator[](size_t index) const
+{
+	static const JsonValue s_Null;
+
+	if (index >= m_Elements.size())
+		return s_Null;
+
+	return m_Elements[index];
+}
+
+std::string VulkanHelper::JsonValue::Quote(std::string_view string)
+{
+	std::string quoted;
+	quoted.reserve(string.size() + 2);
+
+	quoted += '"';
+	for (char c : string)
+	{
+		switch (c)
+		{
+		case '"': quoted += "\\\""; break;
+		case '\\': quoted += "\\\\"; break;
+		case '\n': quoted += "\\n"; break;
+		case '\r': quoted += "\\r"; break;
+		case '\t': quoted += "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+				quoted += escaped;
+			}
+			else
+			{
+				quoted += c;
+			}
+		}
+	}
+	quoted += '"';
+
+	return quoted;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Pch.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Minimal read only JSON document, meant for asset metadata like glTF headers.
+	 *
+	 * Missing members and out of range indices return a null value, so lookups can be chained
+	 * without checking every step.
+	 */
+	class JsonValue
+	{
+	public:
+		enum class Type : uint8_t
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object,
+		};
+
+		JsonValue() = default;
+
+		/**
+		 * @brief Parses a complete document, returns false and fills outError on malformed input.
+		 */
+		[[nodiscard]] static bool Parse(const char* data, size_t size, JsonValue* outValue, std::string* outError = nullptr);
+
+		// Quoted and escaped, for writing JSON by hand
+		[[nodiscard]] static std::string Quote(std::string_view string);
+
+	public:
+
+		[[nodiscard]] inline Type GetType() const { return m_Type; }
+		[[nodiscard]] inline bool IsNull() const { return m_Type == Type::Null; }
+		[[nodiscard]] inline bool IsBool() const { return m_Type == Type::Bool; }
+		[[nodiscard]] inline bool IsNumber() const { return m_Type == Type::Number; }
+		[[nodiscard]] inline bool IsString() const { return m_Type == Type::String; }
+		[[nodiscard]] inline bool IsArray() const { return m_Type == Type::Array; }
+		[[nodiscard]] inline bool IsObject() const { return m_Type == Type::Object; }
+
+		[[nodiscard]] inline bool GetBool(bool defaultValue = false) const { return m_Type == Type::Bool ? m_Bool : defaultValue; }
+		[[nodiscard]] inline double GetNumber(double defaultValue = 0.0) const { return m_Type == Type::Number ? m_Number : defaultValue; }
+		[[nodiscard]] inline float GetFloat(float defaultValue = 0.0f) const { return m_Type == Type::Number ? (float)m_Number : defaultValue; }
+		[[nodiscard]] inline int64_t GetInt(int64_t defaultValue = 0) const { return m_Type == Type::Number ? (int64_t)m_Number : defaultValue; }
+		[[nodiscard]] inline const std::string& GetString() const { return m_String; }
+
+		// Element count of arrays and member count of objects, 0 for everything else
+		[[nodiscard]] size_t GetSize() const;
+
+		[[nodiscard]] bool Has(std::string_view key) const;
+		[[nodiscard]] const JsonValue& operator[](std::string_view key) const;
+		[[nodiscard]] const JsonValue& operator[](size_t index) const;
+
+		[[nodiscard]] inline const std::vector<JsonValue>& GetElements() const { return m_Elements; }
+		[[nodiscard]] inline const std::vector<std::pair<std::string, JsonValue>>& GetMembers() const { return m_Members; }
+
+	private:
+		Type m_Type = Type::Null;
+		bool m_Bool = false;
+		double m_Number = 0.0;
+		std::string m_String;
+		std::vector<JsonValue> m_Elements;
+		std::vector<std::pair<std::string, JsonValue>> m_Members; // Kept in document order, objects are small enough for linear lookups
+
+		friend class JsonParser;
+	};
+}
@@ -0,0 +1,189 @@
+#include "Pch.h"
+#include "LZ4.h"
+
+#include <cstring>
+
+// Constants of the block format
+static constexpr size_t s_MinMatch = 4;
+static constexpr size_t s_LastLiterals = 5; // The last 5 bytes are always literals
+static constexpr size_t s_MatchFindLimit = 12; // A match can't start within the last 12 bytes
+static constexpr size_t s_MaxOffset = 65535;
+
+static constexpr uint32_t s_HashLog = 12;
+
+static inline uint32_t Read32(const uint8_t* data)
+{
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static inline uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - s_HashLog);
+}
+
+static inline uint8_t* WriteLength(uint8_t* out, size_t length)
+{
+	while (length >= 255)
+	{
+		*out++ = 255;
+		length -= 255;
+	}
+
+	*out++ = (uint8_t)length;
+	return out;
+}
+
+static uint8_t* WriteSequence(uint8_t* out, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	uint8_t* token = out++;
+	*token = (uint8_t)(std::min<size_t>(literalLength, 15) << 4);
+	if (literalLength >= 15)
+		out = WriteLength(out, literalLength - 15);
+
+	memcpy(out, literals, literalLength);
+	out += literalLength;
+
+	// Last sequence has no match
+	if (matchLength == 0)
+		return out;
+
+	*out++ = (uint8_t)(offset & 0xFF);
+	*out++ = (uint8_t)(offset >> 8);
+
+	size_t encodedMatch = matchLength - s_MinMatch;
+	*token |= (uint8_t)std::min<size_t>(encodedMatch, 15);
+	if (encodedMatch >= 15)
+		out = WriteLength(out, encodedMatch - 15);
+
+	return out;
+}
+
+size_t VulkanHelper::LZ4::Compress(const void* data, size_t size, void* outData)
+{
+	const uint8_t* src = (const uint8_t*)data;
+	uint8_t* out = (uint8_t*)outData;
+
+	const uint8_t* anchor = src;
+	if (size >= s_MatchFindLimit + 1)
+	{
+		std::vector<uint32_t> table((size_t)1 << s_HashLog, 0);
+
+		const uint8_t* cursor = src + 1;
+		const uint8_t* matchLimit = src + size - s_MatchFindLimit;
+		const uint8_t* matchEnd = src + size - s_LastLiterals;
+
+		while (cursor < matchLimit)
+		{
+			uint32_t sequence = Read32(cursor);
+			uint32_t& entry = table[HashSequence(sequence)];
+			const uint8_t* candidate = src + entry;
+			entry = (uint32_t)(cursor - src);
+
+			if (candidate >= cursor || (size_t)(cursor - candidate) > s_MaxOffset || Read32(candidate) != sequence)
+			{
+				cursor++;
+				continue;
+			}
+
+			// Extend backwards over pending literals, then forwards up to the last literals
+			while (cursor > anchor && candidate > src && cursor[-1] == candidate[-1])
+			{
+				cursor--;
+				candidate--;
+			}
+
+			size_t matchLength = s_MinMatch;
+			while (cursor + matchLength < matchEnd && cursor[matchLength] == candidate[matchLength])
+				matchLength++;
+
+			out = WriteSequence(out, anchor, (size_t)(cursor - anchor), (size_t)(cursor - candidate), matchLength);
+
+			cursor += matchLength;
+			anchor = cursor;
+
+			if (cursor < matchLimit)
+				table[HashSequence(Read32(cursor - 2))] = (uint32_t)(cursor - 2 - src);
+		}
+	}
+
+	out = WriteSequence(out, anchor, (size_t)(src + size - anchor), 0, 0);
+
+	return (size_t)(out - (uint8_t*)outData);
+}
+
+bool VulkanHelper::LZ4::Decompress(const void* data, size_t size, void* outData, size_t outSize)
+{
+	const uint8_t* src = (const uint8_t*)data;
+	const uint8_t* srcEnd = src + size;
+	uint8_t* out = (uint8_t*)outData;
+	uint8_t* outBegin = out;
+	uint8_t* outEnd = out + outSize;
+
+	auto readLength = [&](size_t* length) -> bool
+		{
+			uint8_t value;
+			do
+			{
+				if (src >= srcEnd)
+					return false;
+
+				value = *src++;
+				*length += value;
+			} while (value == 255);
+
+			return true;
+		};
+
+	while (src < srcEnd)
+	{
+		uint8_t token = *src++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLength(&literalLength))
+			return false;
+
+		if (literalLength > (size_t)(srcEnd - src) || literalLength > (size_t)(outEnd - out))
+			return false;
+
+		memcpy(out, src, literalLength);
+		src += literalLength;
+		out += literalLength;
+
+		// Last sequence ends after its literals
+		if (src == srcEnd)
+			break;
+
+		if (srcEnd - src < 2)
+			return false;
+
+		size_t offset = (size_t)src[0] | ((size_t)src[1] << 8);
+		src += 2;
+		if (offset == 0 || offset > (size_t)(out - outBegin))
+			return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(&matchLength))
+			return false;
+		matchLength += s_MinMatch;
+
+		if (matchLength > (size_t)(outEnd - out))
+			return false;
+
+		// Overlapping copies repeat the pattern, which is what the format expects
+		const uint8_t* match = out - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(out, match, matchLength);
+			out += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+				*out++ = match[i];
+		}
+	}
+
+	return out == outEnd;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Pch.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Compressor and decompressor for the LZ4 block format.
+	 *
+	 * Output is compatible with the reference LZ4_compress_default() / LZ4_decompress_safe(). The compressor is a plain
+	 * greedy matcher, it trades ratio for speed the same way the reference fast mode does.
+	 */
+	class LZ4
+	{
+	public:
+		// Worst case compressed size for incompressible input
+		[[nodiscard]] static inline size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+		// Returns the compressed size, outData has to hold CompressBound(size) bytes
+		[[nodiscard]] static size_t Compress(const void* data, size_t size, void* outData);
+
+		/**
+		 * @brief Decompresses a whole block, returns false on malformed input or if the result isn't exactly outSize bytes.
+		 *
+		 * Never reads or writes outside the given buffers, so it's safe on untrusted data.
+		 */
+		[[nodiscard]] static bool Decompress(const void* data, size_t size, void* outData, size_t outSize);
+	};
+}
@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef WIN
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#elif defined(LIN)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VulkanHelper
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		Move(std::move(other));
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Close();
+		Move(std::move(other));
+
+		return *this;
+	}
+
+#ifdef WIN
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_FileHandle = file;
+		m_Size = (size_t)size.QuadPart;
+		m_IsOpen = true;
+
+		// Mapping a zero sized file fails, there is nothing to read anyway
+		if (m_Size == 0)
+			return true;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		m_MappingHandle = mapping;
+		m_Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (m_Data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_MappingHandle)
+			CloseHandle((HANDLE)m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle((HANDLE)m_FileHandle);
+
+		Reset();
+	}
+
+	void MappedFile::Prefetch() const
+	{
+		if (m_Data == nullptr)
+			return;
+
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = (PVOID)m_Data;
+		range.NumberOfBytes = m_Size;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+
+	bool MappedFile::EvictFromCache(const std::string& path)
+	{
+		// Opening a file unbuffered makes the cache manager purge its cached pages, as long as no other handle is open
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		CloseHandle(file);
+		return true;
+	}
+#elif defined(LIN)
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		m_Size = (size_t)fileStat.st_size;
+		m_IsOpen = true;
+
+		// Mapping a zero sized file fails, there is nothing to read anyway
+		if (m_Size == 0)
+		{
+			close(fd);
+			return true;
+		}
+
+		void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		// The mapping keeps its own reference to the file
+		close(fd);
+
+		if (data == MAP_FAILED)
+		{
+			Reset();
+			return false;
+		}
+
+		m_Data = (const uint8_t*)data;
+		madvise(data, m_Size, MADV_SEQUENTIAL);
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+			munmap((void*)m_Data, m_Size);
+
+		Reset();
+	}
+
+	void MappedFile::Prefetch() const
+	{
+		if (m_Data == nullptr)
+			return;
+
+		madvise((void*)m_Data, m_Size, MADV_WILLNEED);
+	}
+
+	bool MappedFile::EvictFromCache(const std::string& path)
+	{
+		int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(fd);
+
+		return evicted;
+	}
+#endif
+
+	void MappedFile::Move(MappedFile&& other)
+	{
+		m_Data = other.m_Data;
+		m_Size = other.m_Size;
+		m_IsOpen = other.m_IsOpen;
+#ifdef WIN
+		m_FileHandle = other.m_FileHandle;
+		m_MappingHandle = other.m_MappingHandle;
+#endif
+
+		other.Reset();
+	}
+
+	void MappedFile::Reset()
+	{
+		m_Data = nullptr;
+		m_Size = 0;
+		m_IsOpen = false;
+#ifdef WIN
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+#endif
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Pch.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Read only memory mapping of a whole file.
+	 *
+	 * Pages are served straight from the OS page cache, so nothing gets copied into a user space buffer
+	 * and repeated loads of the same file don't touch the disk.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string& path) { (void)Open(path); }
+		~MappedFile();
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+	public:
+
+		// Returns false if the file doesn't exist or can't be mapped. Empty files open successfully with no data
+		[[nodiscard]] bool Open(const std::string& path);
+		void Close();
+
+		[[nodiscard]] inline const uint8_t* GetData() const { return m_Data; }
+		[[nodiscard]] inline size_t GetSize() const { return m_Size; }
+		[[nodiscard]] inline bool IsOpen() const { return m_IsOpen; }
+
+		// Hint that the whole file is about to be read, lets the OS start the reads ahead of the first page faults
+		void Prefetch() const;
+
+		/**
+		 * @brief Drops the cached pages of a file so the next read comes from disk, for measuring cold loads.
+		 *
+		 * Only takes effect for files nobody has open or mapped and whose pages aren't dirty. Returns false if the OS refused.
+		 */
+		static bool EvictFromCache(const std::string& path);
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		bool m_IsOpen = false;
+
+#ifdef WIN
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#endif
+
+		void Move(MappedFile&& other);
+		void Reset();
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "pch.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Hash map split into independently locked shards.
+	 *
+	 * Threads touching keys in different shards never wait on each other. Keys are expected to be well mixed
+	 * hashes (e.g. AssetIDs), the top bits pick the shard and the map buckets use the rest.
+	 */
+	template<typename Key, typename Value, uint32_t ShardCount = 64>
+	class ShardedMap
+	{
+		static_assert((ShardCount & (ShardCount - 1)) == 0, "ShardCount has to be a power of 2!");
+
+	public:
+		using Map = std::unordered_map<Key, Value>;
+
+		ShardedMap() = default;
+		~ShardedMap() = default;
+
+		ShardedMap(const ShardedMap& other) = delete;
+		ShardedMap& operator=(const ShardedMap& other) = delete;
+
+		/**
+		 * @brief Locks the shard that owns the key and calls func(Map&) on it.
+		 */
+		template<typename F>
+		decltype(auto) Access(const Key& key, F&& func)
+		{
+			Shard& shard = m_Shards[GetShardIndex(key)];
+			std::unique_lock<std::mutex> lock(shard.Mutex);
+			return func(shard.Entries);
+		}
+
+		/**
+		 * @brief Calls func(index, Map&) for every key, locking each touched shard only once.
+		 *
+		 * Keys are visited grouped by shard, not in the order they were given.
+		 */
+		template<typename F>
+		void AccessMany(std::span<const Key> keys, F&& func)
+		{
+			std::vector<uint32_t> order(keys.size());
+			for (uint32_t i = 0; i < (uint32_t)keys.size(); i++)
+				order[i] = i;
+
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return GetShardIndex(keys[a]) < GetShardIndex(keys[b]); });
+
+			size_t i = 0;
+			while (i < order.size())
+			{
+				uint32_t shardIndex = GetShardIndex(keys[order[i]]);
+				Shard& shard = m_Shards[shardIndex];
+				std::unique_lock<std::mutex> lock(shard.Mutex);
+
+				for (; i < order.size() && GetShardIndex(keys[order[i]]) == shardIndex; i++)
+				{
+					func(order[i], shard.Entries);
+				}
+			}
+		}
+
+		/**
+		 * @brief Locks every shard one by one and calls func(Map&) on each.
+		 */
+		template<typename F>
+		void ForEachShard(F&& func)
+		{
+			for (Shard& shard : m_Shards)
+			{
+				std::unique_lock<std::mutex> lock(shard.Mutex);
+				func(shard.Entries);
+			}
+		}
+
+		static inline uint32_t GetShardIndex(const Key& key)
+		{
+			uint64_t hash = (uint64_t)std::hash<Key>{}(key);
+			hash ^= hash >> 29;
+			return (uint32_t)(hash >> 32) & (ShardCount - 1);
+		}
+
+	private:
+		struct alignas(64) Shard
+		{
+			std::mutex Mutex;
+			Map Entries;
+		};
+
+		std::array<Shard, ShardCount> m_Shards;
+	};
+}
@@ -0,0 +1,137 @@
+#include "Pch.h"
+#include "StreamWriter.h"
+
+#include "Logger/Logger.h"
+
+#include <cstring>
+
+VulkanHelper::StreamWriter::~StreamWriter()
+{
+	Close();
+}
+
+bool VulkanHelper::StreamWriter::Open(const std::string& path, size_t bufferSize /*= s_DefaultBufferSize*/)
+{
+	Close();
+
+	m_Stream.open(path, std::ios_base::binary | std::ios_base::trunc);
+	if (!m_Stream)
+		return false;
+
+	InitBuffer(bufferSize, 0);
+	return true;
+}
+
+bool VulkanHelper::StreamWriter::OpenForAppend(const std::string& path, size_t bufferSize /*= s_DefaultBufferSize*/)
+{
+	Close();
+
+	// Not std::ios_base::app, that would send patches to the end too
+	m_Stream.open(path, std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+	if (!m_Stream)
+	{
+		m_Stream.clear();
+		m_Stream.open(path, std::ios_base::binary | std::ios_base::trunc);
+		if (!m_Stream)
+			return false;
+	}
+
+	m_Stream.seekp(0, std::ios_base::end);
+	std::streamoff fileSize = m_Stream.tellp();
+	if (!m_Stream || fileSize < 0)
+	{
+		m_Stream.close();
+		return false;
+	}
+
+	InitBuffer(bufferSize, (uint64_t)fileSize);
+	return true;
+}
+
+bool VulkanHelper::StreamWriter::Close()
+{
+	if (!m_Stream.is_open())
+		return !m_Failed;
+
+	Flush();
+	m_Stream.close();
+	m_Buffer.reset();
+
+	return !m_Failed;
+}
+
+void VulkanHelper::StreamWriter::Write(const void* data, size_t size)
+{
+	const char* bytes = (const char*)data;
+
+	if (size > m_BufferSize - m_BufferUsed)
+	{
+		Flush();
+
+		// Doesn't fit even into an empty buffer, copying it there first would only add work
+		if (size >= m_BufferSize)
+		{
+			m_Stream.write(bytes, (std::streamsize)size);
+			m_Failed |= !m_Stream;
+			m_FlushedSize += size;
+			return;
+		}
+	}
+
+	memcpy(m_Buffer.get() + m_BufferUsed, bytes, size);
+	m_BufferUsed += size;
+}
+
+void VulkanHelper::StreamWriter::WriteString(std::string_view string)
+{
+	Write(string.data(), string.size());
+	Write('\0');
+}
+
+void VulkanHelper::StreamWriter::Align(size_t alignment)
+{
+	static constexpr char zeros[64] = {};
+	VH_ASSERT(alignment <= sizeof(zeros), "Alignment of {} is too large!", alignment);
+
+	size_t padding = (size_t)((alignment - GetPosition() % alignment) % alignment);
+	Write(zeros, padding);
+}
+
+void VulkanHelper::StreamWriter::Patch(uint64_t offset, const void* data, size_t size)
+{
+	VH_ASSERT(offset + size <= GetPosition(), "Patching bytes that weren't written yet! Offset: {}, Size: {}", offset, size);
+
+	// Still buffered, the common case for per record sizes
+	if (offset >= m_FlushedSize)
+	{
+		memcpy(m_Buffer.get() + (offset - m_FlushedSize), data, size);
+		return;
+	}
+
+	Flush();
+
+	m_Stream.seekp((std::streamoff)offset);
+	m_Stream.write((const char*)data, (std::streamsize)size);
+	m_Stream.seekp(0, std::ios_base::end);
+	m_Failed |= !m_Stream;
+}
+
+void VulkanHelper::StreamWriter::Flush()
+{
+	if (m_BufferUsed == 0)
+		return;
+
+	m_Stream.write(m_Buffer.get(), (std::streamsize)m_BufferUsed);
+	m_Failed |= !m_Stream;
+	m_FlushedSize += m_BufferUsed;
+	m_BufferUsed = 0;
+}
+
+void VulkanHelper::StreamWriter::InitBuffer(size_t bufferSize, uint64_t fileSize)
+{
+	m_BufferSize = std::max(bufferSize, (size_t)64);
+	m_Buffer = std::make_unique<char[]>(m_BufferSize);
+	m_BufferUsed = 0;
+	m_FlushedSize = fileSize;
+	m_Failed = false;
+}
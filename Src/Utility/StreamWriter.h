@@ -0,0 +1,83 @@
+#pragma once
+#include "Pch.h"
+
+namespace VulkanHelper
+{
+	/**
+	 * @brief Buffered binary file writer that can fill in values it reserved earlier.
+	 *
+	 * Everything goes through one fixed size buffer that is flushed to the file when full, so large files are written
+	 * with a bounded amount of memory and no reallocations. Sizes and counts that are only known later are reserved
+	 * with Reserve() and filled in with Patch(), in the buffer if the bytes are still there, with a seek otherwise.
+	 */
+	class StreamWriter
+	{
+	public:
+		StreamWriter() = default;
+		~StreamWriter();
+
+		StreamWriter(const StreamWriter& other) = delete;
+		StreamWriter& operator=(const StreamWriter& other) = delete;
+
+	public:
+
+		// Truncates the file, returns false if it can't be opened for writing
+		[[nodiscard]] bool Open(const std::string& path, size_t bufferSize = s_DefaultBufferSize);
+		// Keeps the contents and writes after them, creates the file if it doesn't exist. Offsets still count from the start of the file
+		[[nodiscard]] bool OpenForAppend(const std::string& path, size_t bufferSize = s_DefaultBufferSize);
+		// Flushes and closes the file, returns false if any write failed
+		bool Close();
+
+		void Write(const void* data, size_t size);
+
+		template<typename T>
+		inline void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as bytes!");
+			Write(&value, sizeof(T));
+		}
+
+		// Writes the characters followed by a null terminator
+		void WriteString(std::string_view string);
+
+		// Pads with zeros until the position is a multiple of alignment
+		void Align(size_t alignment);
+
+		// Skips sizeof(T) bytes to be filled in later by Patch(), returns their offset
+		template<typename T>
+		[[nodiscard]] inline uint64_t Reserve()
+		{
+			uint64_t offset = GetPosition();
+			T zero{};
+			Write(zero);
+			return offset;
+		}
+
+		void Patch(uint64_t offset, const void* data, size_t size);
+
+		template<typename T>
+		inline void Patch(uint64_t offset, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as bytes!");
+			Patch(offset, &value, sizeof(T));
+		}
+
+		// Offset of the next written byte from the start of the file
+		[[nodiscard]] inline uint64_t GetPosition() const { return m_FlushedSize + m_BufferUsed; }
+		[[nodiscard]] inline bool IsOpen() const { return m_Stream.is_open(); }
+		[[nodiscard]] inline bool HasFailed() const { return m_Failed; }
+
+		inline static constexpr size_t s_DefaultBufferSize = 1024 * 1024;
+
+	private:
+		void Flush();
+		void InitBuffer(size_t bufferSize, uint64_t fileSize);
+
+		std::ofstream m_Stream;
+		std::unique_ptr<char[]> m_Buffer;
+		size_t m_BufferSize = 0;
+		size_t m_BufferUsed = 0;
+		uint64_t m_FlushedSize = 0; // Bytes already in the file, the buffer starts at this offset
+		bool m_Failed = false;
+	};
+}
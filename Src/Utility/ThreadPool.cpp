@@ -46,7 +46,9 @@ namespace VulkanHelper
 		for (uint32_t i = 0; i < createInfo.threadCount; i++)
 		{
 			m_WorkerThreads.emplace_back([this] {
-				m_Device->CreateCommandPoolsForThread();
+				s_CurrentPool = this;
+				if (m_Device) // Headless pools don't record commands
+					m_Device->CreateCommandPoolsForThread();
 				while (true)
 				{
 					std::unique_lock<std::mutex> lock(m_Mutex);
@@ -63,6 +65,68 @@ namespace VulkanHelper
 		}
 	}
 
+	void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+	{
+		if (count == 0)
+			return;
+
+		struct State
+		{
+			std::atomic<uint32_t> NextIndex = 0;
+			std::atomic<uint32_t> DoneCount = 0;
+			std::mutex Mutex;
+			std::condition_variable CV;
+		};
+
+		// Helpers that start after all indices are taken only touch the state, never func, so the state
+		// has to outlive this call while func doesn't
+		std::shared_ptr<State> state = std::make_shared<State>();
+		const std::function<void(uint32_t)>* funcPtr = &func;
+
+		auto work = [state, funcPtr, count]()
+			{
+				while (true)
+				{
+					uint32_t index = state->NextIndex.fetch_add(1);
+					if (index >= count)
+						return;
+
+					(*funcPtr)(index);
+
+					if (state->DoneCount.fetch_add(1) + 1 == count)
+					{
+						std::unique_lock<std::mutex> lock(state->Mutex);
+						state->CV.notify_all();
+					}
+				}
+			};
+
+		uint32_t helperCount = std::min(count - 1, GetThreadCount());
+		for (uint32_t i = 0; i < helperCount; i++)
+		{
+			PushTask(work);
+		}
+
+		work();
+
+		std::unique_lock<std::mutex> lock(state->Mutex);
+		state->CV.wait(lock, [&state, count] { return state->DoneCount.load() == count; });
+	}
+
+	bool ThreadPool::RunPendingTask()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (m_Tasks.empty())
+			return false;
+
+		auto task = std::move(m_Tasks.front());
+		m_Tasks.pop();
+		lock.unlock();
+
+		task();
+		return true;
+	}
+
 	void ThreadPool::Move(ThreadPool&& other)
 	{
 		m_WorkerThreads = std::move(other.m_WorkerThreads);
@@ -73,7 +137,8 @@ namespace VulkanHelper
 
 	void ThreadPool::Destroy()
 	{
-		if (m_Device == nullptr)
+		// Headless pools have no device, so whether there are workers tells if the pool was initialized
+		if (m_WorkerThreads.empty())
 			return;
 
 		std::unique_lock<std::mutex> lock(m_Mutex);
@@ -84,6 +149,9 @@ namespace VulkanHelper
 		{
 			worker.join();
 		}
+
+		m_WorkerThreads.clear();
+		m_Stop = false;
 	}
 
 }
\ No newline at end of file
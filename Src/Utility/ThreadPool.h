@@ -5,6 +5,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <future>
 
 namespace VulkanHelper
 {
@@ -15,7 +16,7 @@ namespace VulkanHelper
 	public:
 		struct CreateInfo
 		{
-			Device* Device = nullptr;
+			Device* Device = nullptr; // Optional, workers get their own command pools if set
 			uint32_t threadCount;
 		};
 
@@ -39,6 +40,37 @@ namespace VulkanHelper
 			m_CV.notify_one();
 		}
 
+		/**
+		 * @brief Calls func(i) for every i in [0, count) spread over the workers and blocks until all are done.
+		 *
+		 * The calling thread takes part in the work, so it's safe to call from inside a task of this same pool.
+		 */
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+		/**
+		 * @brief Waits for a future that may depend on tasks still queued in this pool.
+		 *
+		 * On a worker of this pool the wait runs queued tasks until the future is ready instead of blocking, so
+		 * tasks waiting on work queued behind them can't take every worker and deadlock the pool. Anywhere else
+		 * it's a plain wait, other threads don't have the per thread state tasks may rely on.
+		 */
+		template<typename T>
+		void WaitFor(const std::shared_future<T>& future)
+		{
+			if (s_CurrentPool != this)
+			{
+				future.wait();
+				return;
+			}
+
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				// Nothing queued, the result is in flight elsewhere, e.g. a file read that pushes its task once done
+				if (!RunPendingTask())
+					(void)future.wait_for(std::chrono::milliseconds(1));
+			}
+		}
+
 		inline uint32_t GetThreadCount() const { return (uint32_t)m_WorkerThreads.size(); }
 
 		inline size_t TasksLeft()
@@ -59,5 +91,10 @@ namespace VulkanHelper
 
 		void Move(ThreadPool&& other);
 		void Destroy();
+
+		// Pops a single task and runs it on the calling thread, returns false if the queue was empty
+		bool RunPendingTask();
+
+		inline static thread_local ThreadPool* s_CurrentPool = nullptr; // Pool the calling thread is a worker of
 	};
 }
\ No newline at end of file
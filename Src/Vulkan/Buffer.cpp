@@ -28,7 +28,15 @@ namespace VulkanHelper
 		bufferInfo.usage = m_UsageFlags;
 		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		return (ResultCode)m_Device->AllocateBuffer(&m_Handle, m_Allocation, bufferInfo, m_MemoryPropertyFlags, createInfo.DedicatedAllocation);
+		ResultCode res = (ResultCode)m_Device->AllocateBuffer(&m_Handle, m_Allocation, bufferInfo, m_MemoryPropertyFlags, createInfo.DedicatedAllocation);
+		if (res != ResultCode::Success)
+		{
+			// Nothing was created, so there's nothing to hand to the delete queue, just free the allocation holder
+			delete m_Allocation;
+			Reset();
+		}
+
+		return res;
 	}
 
 	void Buffer::Destroy()
@@ -21,6 +21,7 @@ VulkanHelper::ResultCode VulkanHelper::Image::Init(const CreateInfo& createInfo)
 	m_Size.height = createInfo.Height;
 
 	m_MipLevels = createInfo.MipMapCount;
+	m_LayerCount = createInfo.LayerCount;
 	m_Format = createInfo.Format;
 	m_Aspect = createInfo.Aspect;
 	m_ViewType = createInfo.ViewType;
@@ -242,7 +243,7 @@ void VulkanHelper::Image::GenerateMipmaps(VkCommandBuffer commandBuffer) const
 	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
+	barrier.subresourceRange.layerCount = m_LayerCount;
 	barrier.subresourceRange.levelCount = 1;
 
 	int32_t mipWidth = (int32_t)m_Size.width;
@@ -272,13 +273,13 @@ void VulkanHelper::Image::GenerateMipmaps(VkCommandBuffer commandBuffer) const
 		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		blit.srcSubresource.mipLevel = i;
 		blit.srcSubresource.baseArrayLayer = 0;
-		blit.srcSubresource.layerCount = 1;
+		blit.srcSubresource.layerCount = m_LayerCount;
 		blit.dstOffsets[0] = { 0, 0, 0 };
 		blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
 		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		blit.dstSubresource.mipLevel = i + 1;
 		blit.dstSubresource.baseArrayLayer = 0;
-		blit.dstSubresource.layerCount = 1;
+		blit.dstSubresource.layerCount = m_LayerCount;
 
 		vkCmdBlitImage(commandBuffer,
 			m_ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -349,6 +350,11 @@ void VulkanHelper::Image::CopyBufferToImage(VkBuffer buffer, uint32_t baseLayer,
 		m_Device->EndSingleTimeCommands(commandBuffer, m_Device->GetGraphicsQueue(), m_Device->GetGraphicsCommandPool()->GetHandle());
 }
 
+void VulkanHelper::Image::CopyBufferToImage(VkBuffer buffer, std::span<const VkBufferImageCopy> regions, VkCommandBuffer cmd)
+{
+	vkCmdCopyBufferToImage(cmd, buffer, m_ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+}
+
 VulkanHelper::ResultCode VulkanHelper::Image::CreateImage()
 {
 	VkImageCreateInfo imageCreateInfo{};
@@ -489,6 +495,9 @@ uint32_t VulkanHelper::Image::FormatToSize(VkFormat format)
 	case VK_FORMAT_R32G32B32A32_SFLOAT:
 		return 4 * 4;
 		break;
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		return 4;
+		break;
 	default:
 		VH_ASSERT(false, "Unsupported format! Format: {}", (int)format);
 		break;
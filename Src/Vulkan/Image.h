@@ -41,6 +41,8 @@ namespace VulkanHelper
 		void TransitionImageLayout(VkImageLayout newLayout, VkCommandBuffer cmdBuffer = 0, uint32_t baseLayer = 0, uint32_t layerCount = 1);
 		static void TransitionImageLayout(Device* device, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkCommandBuffer cmdBuffer = 0, const VkImageSubresourceRange& subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 });
 		void CopyBufferToImage(VkBuffer buffer, uint32_t baseLayer = 0, VkCommandBuffer cmd = 0, VkDeviceSize bufferOffset = 0, VkOffset2D imageOffset = { 0, 0 });
+		// Any number of mip levels and layers in one copy, image has to be in TRANSFER_DST_OPTIMAL layout
+		void CopyBufferToImage(VkBuffer buffer, std::span<const VkBufferImageCopy> regions, VkCommandBuffer cmd);
 		void CopyImageToImage(VkImage image, uint32_t width, uint32_t height, VkImageLayout layout, VkCommandBuffer cmd, VkOffset3D srcOffset = { 0, 0, 0 }, VkOffset3D dstOffset = { 0, 0, 0 });
 		void BlitImageToImage(Image* srcImage, VkCommandBuffer cmd);
 
@@ -56,6 +58,7 @@ namespace VulkanHelper
 		inline VkImageLayout GetLayout() const { return m_Layout; }
 		inline void SetLayout(VkImageLayout newLayout) { m_Layout = newLayout; }
 		inline uint32_t GetMipLevelsCount() const { return m_MipLevels; }
+		inline uint32_t GetLayerCount() const { return m_LayerCount; }
 		inline VmaAllocation* GetAllocation() { return m_Allocation; }
 
 	private:
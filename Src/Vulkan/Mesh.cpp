@@ -2,6 +2,7 @@
 
 #include "Mesh.h"
 #include "Device.h"
+#include "UploadBatch.h"
 
 #include "assimp/scene.h"
 #include "assimp/mesh.h"
@@ -23,7 +24,10 @@ VulkanHelper::ResultCode VulkanHelper::Mesh::Init(const CreateInfo& createInfo)
 	if (res != ResultCode::Success)
 		return res;
 
-	res = m_VertexBuffer.WriteToBuffer(createInfo.VertexData, createInfo.VertexDataSize);
+	if (createInfo.Batch)
+		res = createInfo.Batch->UploadToBuffer(&m_VertexBuffer, createInfo.VertexData, createInfo.VertexDataSize);
+	else
+		res = m_VertexBuffer.WriteToBuffer(createInfo.VertexData, createInfo.VertexDataSize);
 	if (res != ResultCode::Success)
 		return res;
 
@@ -40,7 +44,10 @@ VulkanHelper::ResultCode VulkanHelper::Mesh::Init(const CreateInfo& createInfo)
 		if (res != ResultCode::Success)
 			return res;
 
-		res = m_IndexBuffer.WriteToBuffer((void*)createInfo.IndexData.data(), (VkDeviceSize)createInfo.IndexData.size() * sizeof(uint32_t));
+		if (createInfo.Batch)
+			res = createInfo.Batch->UploadToBuffer(&m_IndexBuffer, createInfo.IndexData.data(), (VkDeviceSize)createInfo.IndexData.size() * sizeof(uint32_t));
+		else
+			res = m_IndexBuffer.WriteToBuffer((void*)createInfo.IndexData.data(), (VkDeviceSize)createInfo.IndexData.size() * sizeof(uint32_t));
 		if (res != ResultCode::Success)
 			return res;
 
@@ -57,10 +64,29 @@ VulkanHelper::ResultCode VulkanHelper::Mesh::Init(const CreateInfo& createInfo)
 	return res;
 }
 
-VulkanHelper::ResultCode VulkanHelper::Mesh::Init(Device* device, aiMesh* mesh, const aiScene* scene, glm::mat4 mat /*= glm::mat4(1.0f)*/)
+VulkanHelper::ResultCode VulkanHelper::Mesh::Init(Device* device, aiMesh* mesh, const aiScene* scene, glm::mat4 mat /*= glm::mat4(1.0f)*/, UploadBatch* batch /*= nullptr*/)
 {
 	std::vector<DefaultVertex> vertices;
 	std::vector<uint32_t> indices;
+	ConvertAssimpMesh(mesh, mat, &vertices, &indices);
+
+	CreateInfo createInfo{};
+	createInfo.Device = device;
+	createInfo.VertexData = vertices.data();
+	createInfo.VertexDataSize = vertices.size() * sizeof(DefaultVertex);
+	createInfo.VertexSize = sizeof(DefaultVertex);
+	createInfo.InputAttributes = GetDefaultInputAttributes();
+	createInfo.IndexData = std::move(indices);
+	createInfo.Batch = batch;
+	return Init(createInfo);
+}
+
+void VulkanHelper::Mesh::ConvertAssimpMesh(const aiMesh* mesh, glm::mat4 mat, std::vector<DefaultVertex>* outVertices, std::vector<uint32_t>* outIndices)
+{
+	std::vector<DefaultVertex>& vertices = *outVertices;
+	std::vector<uint32_t>& indices = *outIndices;
+	vertices.reserve(mesh->mNumVertices);
+	indices.reserve((size_t)mesh->mNumFaces * 3);
 
 	// vertices
 	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -106,19 +132,69 @@ VulkanHelper::ResultCode VulkanHelper::Mesh::Init(Device* device, aiMesh* mesh,
 		for (unsigned int j = 0; j < face.mNumIndices; j++)
 			indices.push_back(face.mIndices[j]);
 	}
+}
 
-	CreateInfo createInfo{};
-	createInfo.Device = device;
-	createInfo.VertexData = vertices.data();
-	createInfo.VertexDataSize = vertices.size() * sizeof(DefaultVertex);
-	createInfo.VertexSize = sizeof(DefaultVertex);
-	createInfo.InputAttributes = {
-		{ VK_FORMAT_R32G32B32_SFLOAT, offsetof(DefaultVertex, Position) },
-		{ VK_FORMAT_R32G32B32_SFLOAT, offsetof(DefaultVertex, Normal) },
-		{ VK_FORMAT_R32G32_SFLOAT, offsetof(DefaultVertex, TexCoord) }
-	};
-	createInfo.IndexData = indices;
-	return Init(createInfo);
+VulkanHelper::ResultCode VulkanHelper::Mesh::Init(Device* device, uint64_t vertexCount, uint64_t indexCount, UploadBatch* batch, const DefaultMeshWriter& writer)
+{
+	Destroy();
+
+	m_Device = device;
+
+	VkDeviceSize vertexDataSize = vertexCount * sizeof(DefaultVertex);
+	VkDeviceSize indexDataSize = indexCount * sizeof(uint32_t);
+
+	Buffer::CreateInfo vertexBufferInfo{};
+	vertexBufferInfo.Device = m_Device;
+	vertexBufferInfo.BufferSize = vertexDataSize;
+	vertexBufferInfo.MemoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	vertexBufferInfo.UsageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	ResultCode res = m_VertexBuffer.Init(vertexBufferInfo);
+	if (res != ResultCode::Success)
+		return res;
+
+	UploadBatch::StagingAllocation vertexStaging;
+	res = batch->AllocateStaging(vertexDataSize, &vertexStaging);
+	if (res != ResultCode::Success)
+		return res;
+
+	UploadBatch::StagingAllocation indexStaging;
+	if (indexCount > 0)
+	{
+		Buffer::CreateInfo indexBufferInfo{};
+		indexBufferInfo.Device = m_Device;
+		indexBufferInfo.BufferSize = indexDataSize;
+		indexBufferInfo.MemoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		indexBufferInfo.UsageFlags = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		res = m_IndexBuffer.Init(indexBufferInfo);
+		if (res != ResultCode::Success)
+			return res;
+
+		res = batch->AllocateStaging(indexDataSize, &indexStaging);
+		if (res != ResultCode::Success)
+			return res;
+	}
+
+	writer((DefaultVertex*)vertexStaging.Data, (uint32_t*)indexStaging.Data);
+
+	res = batch->UploadStagingToBuffer(&m_VertexBuffer, vertexStaging);
+	if (res != ResultCode::Success)
+		return res;
+
+	if (indexCount > 0)
+	{
+		res = batch->UploadStagingToBuffer(&m_IndexBuffer, indexStaging);
+		if (res != ResultCode::Success)
+			return res;
+	}
+
+	m_VertexCount = vertexCount;
+	m_IndexCount = indexCount;
+	m_HasIndexBuffer = indexCount > 0;
+
+	m_VertexSize = sizeof(DefaultVertex);
+	CreateInputAttributes(GetDefaultInputAttributes());
+
+	return res;
 }
 
 VulkanHelper::Mesh::~Mesh()
@@ -126,6 +202,15 @@ VulkanHelper::Mesh::~Mesh()
 	Destroy();
 }
 
+std::vector<VulkanHelper::Mesh::InputAttribute> VulkanHelper::Mesh::GetDefaultInputAttributes()
+{
+	return {
+		{ VK_FORMAT_R32G32B32_SFLOAT, offsetof(DefaultVertex, Position) },
+		{ VK_FORMAT_R32G32B32_SFLOAT, offsetof(DefaultVertex, Normal) },
+		{ VK_FORMAT_R32G32_SFLOAT, offsetof(DefaultVertex, TexCoord) }
+	};
+}
+
 void VulkanHelper::Mesh::CreateInputAttributes(const std::vector<InputAttribute>& inputAttributes)
 {
 	InputAttributes.resize(inputAttributes.size());
@@ -12,6 +12,7 @@ struct aiScene;
 namespace VulkanHelper
 {
 	class Device;
+	class UploadBatch;
 
 	class Mesh
 	{
@@ -34,10 +35,34 @@ namespace VulkanHelper
 			std::vector<uint32_t> IndexData;
 
 			uint32_t VertexSize = 0;
+
+			// If set, data is only recorded into the batch and uploaded when the batch is submitted
+			UploadBatch* Batch = nullptr;
 		};
 
+		// Vertex layout used by meshes created from model files
+		struct DefaultVertex
+		{
+			glm::vec3 Position;
+			glm::vec3 Normal;
+			glm::vec2 TexCoord;
+		};
+
+		// Called once with pointers into staging memory that have room for exactly vertexCount vertices and indexCount indices
+		using DefaultMeshWriter = std::function<void(DefaultVertex* vertices, uint32_t* indices)>;
+
 		ResultCode Init(const CreateInfo& createInfo);
-		ResultCode Init(Device* device, aiMesh* mesh, const aiScene* scene, glm::mat4 mat = glm::mat4(1.0f));
+		ResultCode Init(Device* device, aiMesh* mesh, const aiScene* scene, glm::mat4 mat = glm::mat4(1.0f), UploadBatch* batch = nullptr);
+
+		// CPU side of the Assimp Init(), shared with the offline cooker
+		static void ConvertAssimpMesh(const aiMesh* mesh, glm::mat4 mat, std::vector<DefaultVertex>* outVertices, std::vector<uint32_t>* outIndices);
+
+		/**
+		 * @brief Creates a mesh with the default vertex layout whose data is written by writer directly into staging memory of batch.
+		 *
+		 * indexCount of 0 creates a mesh without an index buffer.
+		 */
+		ResultCode Init(Device* device, uint64_t vertexCount, uint64_t indexCount, UploadBatch* batch, const DefaultMeshWriter& writer);
 		Mesh() = default;
 		~Mesh();
 
@@ -63,13 +88,7 @@ namespace VulkanHelper
 
 	private:
 
-		struct DefaultVertex
-		{
-			glm::vec3 Position;
-			glm::vec3 Normal;
-			glm::vec2 TexCoord;
-		};
-
+		static std::vector<InputAttribute> GetDefaultInputAttributes();
 		void CreateInputAttributes(const std::vector<InputAttribute>& inputAttributes);
 		Device* m_Device = nullptr;
 
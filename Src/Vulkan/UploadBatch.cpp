@@ -0,0 +1,220 @@
+#include "Pch.h"
+#include "UploadBatch.h"
+
+#include "Logger/Logger.h"
+
+#include "Device.h"
+#include "Image.h"
+
+void VulkanHelper::UploadBatch::Init(const CreateInfo& createInfo)
+{
+	Destroy();
+
+	m_Device = createInfo.Device;
+
+	// The batch gets its own pool so it can be recorded from several threads without touching per thread pools
+	CommandPool::CreateInfo poolInfo{};
+	poolInfo.Device = m_Device->GetHandle();
+	poolInfo.QueueFamilyIndex = m_Device->GetGraphicsCommandPool()->GetQueueFamilyIndex();
+	poolInfo.Flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	m_CommandPool = std::make_unique<CommandPool>(poolInfo);
+}
+
+VulkanHelper::UploadBatch::~UploadBatch()
+{
+	Destroy();
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::AllocateStaging(VkDeviceSize size, StagingAllocation* outAllocation)
+{
+	VkDeviceSize alignedSize = (size + s_StagingAlignment - 1) & ~(s_StagingAlignment - 1);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	StagingChunk* chunk = m_StagingChunks.empty() ? nullptr : m_StagingChunks.back().get();
+	if (alignedSize >= s_StagingChunkSize)
+	{
+		// Gets a chunk of its own, put in front so the last chunk keeps being filled
+		std::unique_ptr<StagingChunk> newChunk = std::make_unique<StagingChunk>();
+		ResultCode res = CreateStagingChunk(alignedSize, newChunk.get());
+		if (res != ResultCode::Success)
+			return res;
+
+		chunk = newChunk.get();
+		m_StagingChunks.insert(m_StagingChunks.begin(), std::move(newChunk));
+	}
+	else if (chunk == nullptr || chunk->Used + alignedSize > chunk->Buffer.GetBufferSize())
+	{
+		std::unique_ptr<StagingChunk> newChunk = std::make_unique<StagingChunk>();
+		ResultCode res = CreateStagingChunk(s_StagingChunkSize, newChunk.get());
+		if (res != ResultCode::Success)
+			return res;
+
+		chunk = newChunk.get();
+		m_StagingChunks.emplace_back(std::move(newChunk));
+	}
+
+	outAllocation->Buffer = chunk->Buffer.GetHandle();
+	outAllocation->Offset = chunk->Used;
+	outAllocation->Size = size;
+	outAllocation->Data = (char*)chunk->Buffer.GetMappedMemory() + chunk->Used;
+	chunk->Used += alignedSize;
+
+	return ResultCode::Success;
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::UploadStagingToBuffer(Buffer* dstBuffer, const StagingAllocation& staging, VkDeviceSize dstOffset /*= 0*/)
+{
+	VH_ASSERT(dstBuffer->GetBufferSize() >= staging.Size + dstOffset, "Data size is larger than buffer size!");
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = staging.Offset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = staging.Size;
+
+	vkCmdCopyBuffer(GetCommandBuffer(), staging.Buffer, dstBuffer->GetHandle(), 1, &copyRegion);
+
+	m_UploadCount++;
+	m_UploadedBytes += staging.Size;
+
+	return ResultCode::Success;
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::UploadStagingToImage(Image* dstImage, const StagingAllocation& staging, bool generateMipMaps /*= false*/)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	// Layers are expected to be tightly packed one after another
+	uint32_t layerCount = dstImage->GetLayerCount();
+	VkDeviceSize layerSize = staging.Size / layerCount;
+
+	VkCommandBuffer cmd = GetCommandBuffer();
+	dstImage->TransitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd, 0, layerCount);
+	for (uint32_t layer = 0; layer < layerCount; layer++)
+	{
+		dstImage->CopyBufferToImage(staging.Buffer, layer, cmd, staging.Offset + layerSize * layer);
+	}
+
+	if (generateMipMaps)
+		dstImage->GenerateMipmaps(cmd);
+
+	m_UploadCount++;
+	m_UploadedBytes += staging.Size;
+
+	return ResultCode::Success;
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::UploadStagingToImage(Image* dstImage, const StagingAllocation& staging, std::span<const VkBufferImageCopy> regions)
+{
+	std::vector<VkBufferImageCopy> stagingRegions(regions.begin(), regions.end());
+	for (VkBufferImageCopy& region : stagingRegions)
+	{
+		VH_ASSERT(region.bufferOffset < staging.Size, "Region lies outside of the staging allocation!");
+		region.bufferOffset += staging.Offset;
+	}
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	uint32_t layerCount = dstImage->GetLayerCount();
+
+	VkCommandBuffer cmd = GetCommandBuffer();
+	dstImage->TransitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd, 0, layerCount);
+	dstImage->CopyBufferToImage(staging.Buffer, stagingRegions, cmd);
+	dstImage->TransitionImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cmd, 0, layerCount);
+
+	m_UploadCount++;
+	m_UploadedBytes += staging.Size;
+
+	return ResultCode::Success;
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::UploadToBuffer(Buffer* dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset /*= 0*/)
+{
+	StagingAllocation staging;
+	ResultCode res = AllocateStaging(size, &staging);
+	if (res != ResultCode::Success)
+		return res;
+
+	memcpy(staging.Data, data, size);
+
+	return UploadStagingToBuffer(dstBuffer, staging, dstOffset);
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::UploadToImage(Image* dstImage, const void* data, VkDeviceSize size, bool generateMipMaps /*= false*/)
+{
+	StagingAllocation staging;
+	ResultCode res = AllocateStaging(size, &staging);
+	if (res != ResultCode::Success)
+		return res;
+
+	memcpy(staging.Data, data, size);
+
+	return UploadStagingToImage(dstImage, staging, generateMipMaps);
+}
+
+void VulkanHelper::UploadBatch::Submit()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	if (m_CommandBuffer == VK_NULL_HANDLE)
+	{
+		m_StagingChunks.clear();
+		return;
+	}
+
+	// Cached memory doesn't have to be coherent
+	for (std::unique_ptr<StagingChunk>& chunk : m_StagingChunks)
+	{
+		(void)chunk->Buffer.Flush(chunk->Used, 0);
+	}
+
+	m_Device->EndSingleTimeCommands(m_CommandBuffer, m_Device->GetGraphicsQueue(), m_CommandPool->GetHandle());
+	m_CommandBuffer = VK_NULL_HANDLE;
+
+	// Upload finished, staging memory can go
+	m_StagingChunks.clear();
+}
+
+VulkanHelper::ResultCode VulkanHelper::UploadBatch::CreateStagingChunk(VkDeviceSize size, StagingChunk* outChunk)
+{
+	// Cached memory so decoders that read back what they wrote (PNG unfiltering, vertical flips) stay fast
+	Buffer::CreateInfo info{};
+	info.Device = m_Device;
+	info.BufferSize = size;
+	info.MemoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+	info.UsageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	ResultCode res = outChunk->Buffer.Init(info);
+	if (res != ResultCode::Success)
+	{
+		info.MemoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+		res = outChunk->Buffer.Init(info);
+		if (res != ResultCode::Success)
+			return res;
+	}
+
+	outChunk->Used = 0;
+	return outChunk->Buffer.Map();
+}
+
+VkCommandBuffer VulkanHelper::UploadBatch::GetCommandBuffer()
+{
+	if (m_CommandBuffer == VK_NULL_HANDLE)
+		m_Device->BeginSingleTimeCommands(&m_CommandBuffer, m_CommandPool->GetHandle());
+
+	return m_CommandBuffer;
+}
+
+void VulkanHelper::UploadBatch::Destroy()
+{
+	if (m_Device == nullptr)
+		return;
+
+	Submit();
+
+	m_CommandPool.reset();
+	m_Device = nullptr;
+	m_UploadCount = 0;
+	m_UploadedBytes = 0;
+}
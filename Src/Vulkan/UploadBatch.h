@@ -0,0 +1,103 @@
+#pragma once
+#include "Pch.h"
+
+#include "ErrorCodes.h"
+#include "Buffer.h"
+#include "CommandPool.h"
+
+namespace VulkanHelper
+{
+	class Device;
+	class Image;
+
+	/**
+	 * @brief Collects many buffer and image uploads into a single command buffer submission.
+	 *
+	 * Uploads can be recorded from any thread. Staging memory is sub-allocated from a few large mapped chunks that
+	 * are kept alive until Submit(), so they are never released to the DeleteQueue while the GPU can still read them.
+	 */
+	class UploadBatch
+	{
+	public:
+		struct CreateInfo
+		{
+			Device* Device = nullptr;
+		};
+
+		void Init(const CreateInfo& createInfo);
+		UploadBatch(const CreateInfo& createInfo) { Init(createInfo); }
+		UploadBatch() = default;
+		~UploadBatch();
+
+		UploadBatch(const UploadBatch& other) = delete;
+		UploadBatch& operator=(const UploadBatch& other) = delete;
+		UploadBatch(UploadBatch&& other) = delete;
+		UploadBatch& operator=(UploadBatch&& other) = delete;
+
+	public:
+
+		// Range of a mapped staging buffer owned by the batch, valid until Submit()
+		struct StagingAllocation
+		{
+			VkBuffer Buffer = VK_NULL_HANDLE;
+			VkDeviceSize Offset = 0;
+			VkDeviceSize Size = 0;
+			void* Data = nullptr;
+		};
+
+		/**
+		 * @brief Sub-allocates host cached staging memory that can be filled directly, e.g. by a decoder.
+		 *
+		 * Fill Data and pass the allocation to UploadStagingToImage() or UploadStagingToBuffer().
+		 */
+		[[nodiscard]] ResultCode AllocateStaging(VkDeviceSize size, StagingAllocation* outAllocation);
+		[[nodiscard]] ResultCode UploadStagingToBuffer(Buffer* dstBuffer, const StagingAllocation& staging, VkDeviceSize dstOffset = 0);
+		// For layered images staging has to contain every layer, tightly packed
+		[[nodiscard]] ResultCode UploadStagingToImage(Image* dstImage, const StagingAllocation& staging, bool generateMipMaps = false);
+		/**
+		 * @brief Uploads prebuilt subresources, e.g. every mip level of a compressed texture, with a single copy.
+		 *
+		 * Region buffer offsets are relative to the staging allocation. The image ends up in SHADER_READ_ONLY_OPTIMAL layout.
+		 */
+		[[nodiscard]] ResultCode UploadStagingToImage(Image* dstImage, const StagingAllocation& staging, std::span<const VkBufferImageCopy> regions);
+
+		[[nodiscard]] ResultCode UploadToBuffer(Buffer* dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+		// For layered images data has to contain every layer, tightly packed
+		[[nodiscard]] ResultCode UploadToImage(Image* dstImage, const void* data, VkDeviceSize size, bool generateMipMaps = false);
+
+		/**
+		 * @brief Submits everything recorded so far, waits for it to finish and releases the staging memory.
+		 */
+		void Submit();
+
+		[[nodiscard]] inline uint32_t GetUploadCount() const { return m_UploadCount; }
+		[[nodiscard]] inline VkDeviceSize GetUploadedBytes() const { return m_UploadedBytes; }
+
+	private:
+
+		struct StagingChunk
+		{
+			Buffer Buffer;
+			VkDeviceSize Used = 0;
+		};
+
+		[[nodiscard]] ResultCode CreateStagingChunk(VkDeviceSize size, StagingChunk* outChunk);
+		VkCommandBuffer GetCommandBuffer();
+
+		// Uploads are packed into chunks of this size, larger ones get a chunk of their own
+		inline static constexpr VkDeviceSize s_StagingChunkSize = 64ull * 1024 * 1024;
+		inline static constexpr VkDeviceSize s_StagingAlignment = 16;
+
+		Device* m_Device = nullptr;
+		std::unique_ptr<CommandPool> m_CommandPool;
+
+		VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+		std::vector<std::unique_ptr<StagingChunk>> m_StagingChunks; // Pointers stay valid while other threads allocate
+		uint32_t m_UploadCount = 0;
+		VkDeviceSize m_UploadedBytes = 0;
+
+		std::mutex m_Mutex;
+
+		void Destroy();
+	};
+}
@@ -16,6 +16,7 @@
 #include "Vulkan/PushConstant.h"
 #include "Vulkan/DescriptorSet.h"
 #include "Vulkan/DeleteQueue.h"
+#include "Vulkan/UploadBatch.h"
 
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
@@ -23,8 +24,16 @@
 #include "Scene/System.h"
 
 #include "Asset/Serializer.h"
+#include "Asset/SceneJournal.h"
 #include "Asset/Asset.h"
 #include "Asset/AssetManager.h"
+#include "Asset/Package.h"
+#include "Asset/AssetProfiler.h"
+#include "Asset/AssetPrefetcher.h"
+#include "Asset/CookManifest.h"
+#include "Asset/CookedModel.h"
+#include "Asset/AssetCooker.h"
+#include "Asset/MaterialTable.h"
 
 #include "Math/Transform.h"
 #include "Math/Quaternion.h"
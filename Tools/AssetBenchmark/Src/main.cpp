@@ -0,0 +1,235 @@
+#include "Asset/AssetImporter.h"
+#include "Asset/AssetManager.h"
+#include "Asset/GLTFImporter.h"
+#include "Logger/Logger.h"
+#include "Utility/MappedFile.h"
+#include "Vulkan/DeleteQueue.h"
+#include "Vulkan/Device.h"
+#include "Vulkan/Instance.h"
+#include "Vulkan/Mesh.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static double GetMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+namespace
+{
+	// Averaged after one untimed import, so both importers find the files in the page cache
+	constexpr uint32_t s_RunCount = 5;
+
+	struct ModelOutputs
+	{
+		std::vector<VulkanHelper::Mesh> Meshes;
+		std::vector<std::string> MeshNames;
+		std::vector<glm::mat4> MeshTransforms;
+		std::vector<VulkanHelper::Material> Materials;
+		std::vector<uint32_t> MeshMaterialIndices;
+		std::vector<VulkanHelper::MeshInstance> Instances;
+	};
+
+	bool ImportNative(VulkanHelper::Device* device, const std::string& path, ModelOutputs* outputs)
+	{
+		return VulkanHelper::GLTFImporter::ImportModel(device, path, &outputs->Meshes, &outputs->MeshNames, &outputs->MeshTransforms, &outputs->Materials, &outputs->MeshMaterialIndices, &outputs->Instances);
+	}
+
+	bool ImportAssimp(VulkanHelper::Device* device, const std::string& path, ModelOutputs* outputs)
+	{
+		VulkanHelper::AssetImporter::ImportAssimpModel(device, path, &outputs->Meshes, &outputs->MeshNames, &outputs->MeshTransforms, &outputs->Materials, &outputs->MeshMaterialIndices, &outputs->Instances);
+		return !outputs->Meshes.empty();
+	}
+
+	/**
+	 * @brief Average import time in milliseconds, negative if the importer failed.
+	 *
+	 * Outputs are dropped after every run, so textures are loaded again each time instead of coming from the asset cache.
+	 */
+	double TimeImport(VulkanHelper::Device* device, const std::string& path, bool(*import)(VulkanHelper::Device*, const std::string&, ModelOutputs*), size_t* outMeshCount)
+	{
+		double total = 0.0;
+		for (uint32_t run = 0; run <= s_RunCount; run++)
+		{
+			bool success;
+			{
+				ModelOutputs outputs;
+
+				Clock::time_point start = Clock::now();
+				success = import(device, path, &outputs);
+				if (run > 0)
+					total += GetMilliseconds(start);
+
+				*outMeshCount = outputs.Meshes.size();
+			}
+
+			VulkanHelper::DeleteQueue::ClearQueue();
+			if (!success)
+				return -1.0;
+		}
+
+		return total / s_RunCount;
+	}
+
+	// Every file is imported with both importers, fails if Assimp can't import a file or the two disagree on it
+	int CompareImporters(VulkanHelper::Device* device, const std::vector<std::string>& paths)
+	{
+		int result = 0;
+		for (const std::string& path : paths)
+		{
+			if (!VulkanHelper::GLTFImporter::IsGLTF(path))
+			{
+				std::cout << path << ": not a glTF file, skipped\n";
+				continue;
+			}
+
+			size_t nativeMeshCount = 0;
+			size_t assimpMeshCount = 0;
+			double native = TimeImport(device, path, ImportNative, &nativeMeshCount);
+			double assimp = TimeImport(device, path, ImportAssimp, &assimpMeshCount);
+
+			if (assimp < 0.0)
+			{
+				std::cout << path << ": failed to import\n";
+				result = 1;
+				continue;
+			}
+
+			if (native < 0.0)
+			{
+				std::cout << path << ": not supported by the native importer, Assimp " << assimp << " ms\n";
+				continue;
+			}
+
+			std::cout << path << ": native " << native << " ms, Assimp " << assimp << " ms (" << assimp / native << "x) average of " << s_RunCount << " runs, " << nativeMeshCount << " meshes\n";
+
+			// Both importers produce one mesh per primitive, anything else means they disagree on the file
+			if (nativeMeshCount != assimpMeshCount)
+			{
+				std::cout << path << ": native importer made " << nativeMeshCount << " meshes, Assimp " << assimpMeshCount << "\n";
+				result = 1;
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Loads every texture and model below the directory through the AssetManager, first cold and then warm.
+	 *
+	 * The cold pass evicts every file of the directory from the OS cache first, including model buffers and
+	 * textures referenced by models. The warm pass loads the same files again, now served from the page cache.
+	 */
+	int BenchmarkLoads(const std::string& directory)
+	{
+		std::vector<std::string> assetPaths;
+		std::vector<std::string> allPaths;
+		uint64_t totalSize = 0;
+
+		std::error_code error;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory, error))
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			std::string path = entry.path().generic_string();
+			allPaths.push_back(path);
+			totalSize += entry.file_size();
+
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+			if (extension == ".png" || extension == ".jpg" || extension == ".hdr" || extension == ".ktx2" || extension == ".gltf" || extension == ".glb" || extension == ".obj")
+				assetPaths.push_back(path);
+		}
+
+		if (error || assetPaths.empty())
+		{
+			std::cout << "No assets found in " << directory << "\n";
+			return 1;
+		}
+
+		std::cout << assetPaths.size() << " assets, " << (double)totalSize / (1024.0 * 1024.0) << " MB in " << allPaths.size() << " files\n";
+
+		for (bool cold : { true, false })
+		{
+			if (cold)
+			{
+				size_t evicted = 0;
+				for (const std::string& path : allPaths)
+					evicted += VulkanHelper::MappedFile::EvictFromCache(path) ? 1 : 0;
+
+				if (evicted != allPaths.size())
+					std::cout << "Only " << evicted << " of " << allPaths.size() << " files could be evicted, the cold pass is partly warm\n";
+			}
+
+			VulkanHelper::AssetManager::ResetStatistics();
+
+			Clock::time_point start = Clock::now();
+			{
+				std::vector<VulkanHelper::AssetHandle> handles = VulkanHelper::AssetManager::GetAssets(assetPaths);
+				for (VulkanHelper::AssetHandle& handle : handles)
+					handle.WaitToLoad();
+			}
+			double milliseconds = GetMilliseconds(start);
+
+			// Handles are gone, so the warm pass decodes and uploads everything again instead of reusing the assets
+			VulkanHelper::DeleteQueue::ClearQueue();
+
+			VulkanHelper::AssetManager::Statistics statistics = VulkanHelper::AssetManager::GetStatistics();
+			std::cout << (cold ? "Cold: " : "Warm: ") << milliseconds << " ms, " << (double)totalSize / (1024.0 * 1024.0) / (milliseconds / 1000.0) << " MB/s, "
+				<< statistics.TexturesLoaded << " textures, " << statistics.ModelsLoaded << " models\n";
+		}
+
+		return 0;
+	}
+}
+
+// Runs on a device without a window. Either imports glTF files with the native importer and with Assimp,
+// or with --load measures cold and warm loads of an asset directory. Both end with everything uploaded
+int main(int argc, char** argv)
+{
+	VulkanHelper::Logger::Init();
+
+	bool loadDirectory = argc > 1 && std::string(argv[1]) == "--load";
+	if (argc < 2 || (loadDirectory && argc != 3))
+	{
+		std::cout << "Usage: VulkanHelperAssetBenchmark <model.gltf|model.glb>...\n";
+		std::cout << "       VulkanHelperAssetBenchmark --load <asset directory>\n";
+		return 1;
+	}
+
+	VulkanHelper::Instance::Init({});
+
+	std::vector<VulkanHelper::Instance::PhysicalDevice> physicalDevices = VulkanHelper::Instance::Get()->QuerySuitablePhysicalDevices(VK_NULL_HANDLE, {});
+	if (physicalDevices.empty())
+	{
+		std::cout << "No suitable GPU found\n";
+		return 1;
+	}
+
+	int result = 0;
+	{
+		VulkanHelper::Device::CreateInfo deviceCreateInfo{};
+		deviceCreateInfo.PhysicalDevice = physicalDevices[0];
+		deviceCreateInfo.Surface = VK_NULL_HANDLE;
+
+		VulkanHelper::Device device(deviceCreateInfo);
+		VulkanHelper::DeleteQueue::Init({ &device, 0 }); // Nothing is in flight between runs, so deletes happen right away
+		VulkanHelper::AssetManager::Init(&device);
+
+		std::cout << "GPU: " << physicalDevices[0].Name << "\n";
+		if (loadDirectory)
+			result = BenchmarkLoads(argv[2]);
+		else
+			result = CompareImporters(&device, std::vector<std::string>(argv + 1, argv + argc));
+
+		VulkanHelper::DeleteQueue::Destroy();
+	}
+
+	VulkanHelper::Instance::Destroy();
+	return result;
+}
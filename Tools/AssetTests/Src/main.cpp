@@ -0,0 +1,209 @@
+#include "Asset/GLTFImporter.h"
+#include "Asset/KTX2.h"
+#include "Logger/Logger.h"
+#include "Utility/Json.h"
+#include "Utility/ThreadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Headless regression tests for the asset pipeline, returns the number of failed tests
+namespace
+{
+	using TestFunction = bool(*)();
+
+	/**
+	 * @brief More models than workers, every model waits on a texture that is queued behind the remaining models.
+	 *
+	 * Same order AssetManager::GetAssets() schedules a batch in, models first and their textures after them. A
+	 * worker blocking in the wait would leave no worker for the textures.
+	 */
+	bool ModelsOutnumberWorkers()
+	{
+		static constexpr uint32_t s_WorkerCount = 2;
+		static constexpr uint32_t s_ModelCount = s_WorkerCount * 4;
+
+		VulkanHelper::ThreadPool threadPool({ nullptr, s_WorkerCount });
+
+		std::vector<std::promise<void>> modelPromises(s_ModelCount);
+		std::vector<std::shared_future<void>> models;
+		for (std::promise<void>& promise : modelPromises)
+			models.push_back(promise.get_future().share());
+
+		for (uint32_t i = 0; i < s_ModelCount; i++)
+		{
+			threadPool.PushTask([&threadPool, &modelPromises, i]()
+				{
+					std::shared_ptr<std::promise<void>> texturePromise = std::make_shared<std::promise<void>>();
+					std::shared_future<void> texture = texturePromise->get_future().share();
+					threadPool.PushTask([texturePromise]() { texturePromise->set_value(); });
+
+					threadPool.WaitFor(texture);
+					modelPromises[i].set_value();
+				});
+		}
+
+		for (std::shared_future<void>& model : models)
+		{
+			if (model.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+			{
+				// Workers are stuck for good, joining them in the pool destructor would hang too
+				std::cout << "ModelsOutnumberWorkers: deadlocked" << std::endl;
+				std::_Exit(1);
+			}
+		}
+
+		return true;
+	}
+
+	bool AccessorInRange(const char* accessorJson, const char* bufferViewJson, uint64_t elementSize, uint64_t bufferSize)
+	{
+		VulkanHelper::JsonValue accessor;
+		VulkanHelper::JsonValue bufferView;
+		if (!VulkanHelper::JsonValue::Parse(accessorJson, strlen(accessorJson), &accessor) || !VulkanHelper::JsonValue::Parse(bufferViewJson, strlen(bufferViewJson), &bufferView))
+			return false;
+
+		uint64_t offset = 0, stride = 0, count = 0;
+		return VulkanHelper::GLTFImporter::GetAccessorRange(accessor, bufferView, elementSize, bufferSize, &offset, &stride, &count);
+	}
+
+	/**
+	 * @brief Accessors and buffer views with negative, fractional or overflowing values have to be rejected instead of wrapping around.
+	 */
+	bool MalformedAccessorsRejected()
+	{
+		struct Case
+		{
+			const char* Accessor;
+			const char* BufferView;
+			bool Valid;
+		};
+
+		// 12 byte elements in a 1024 byte buffer
+		const Case cases[] =
+		{
+			{ R"({ "count": 10 })", R"({ "byteLength": 120 })", true },
+			{ R"({ "count": 0 })", R"({ "byteLength": 0 })", true },
+			{ R"({ "byteOffset": 4, "count": 2 })", R"({ "byteOffset": 1000, "byteLength": 24, "byteStride": 16 })", false },
+			{ R"({ "byteOffset": 4, "count": 2 })", R"({ "byteOffset": 992, "byteLength": 32, "byteStride": 16 })", true },
+			{ R"({ "count": 11 })", R"({ "byteLength": 120 })", false },
+			{ R"({ "byteOffset": -12, "count": 1 })", R"({ "byteOffset": 12, "byteLength": 12 })", false },
+			{ R"({ "count": 1 })", R"({ "byteOffset": -8, "byteLength": 20 })", false },
+			{ R"({ "count": -1 })", R"({ "byteLength": 120 })", false },
+			{ R"({ "count": 1 })", R"({ "byteLength": 120, "byteStride": -4 })", false },
+			{ R"({ "count": 1.5 })", R"({ "byteLength": 120 })", false },
+			{ R"({ "count": 1 })", R"({ "byteOffset": 18446744073709551600, "byteLength": 32 })", false },
+			{ R"({ "count": 1 })", R"({ "byteOffset": 8, "byteLength": 18446744073709551608 })", false },
+			{ R"({ "count": 4503599627370497 })", R"({ "byteLength": 1024, "byteStride": 4503599627370496 })", false },
+			{ R"({ "count": 2 })", R"({ "byteLength": 1024, "byteStride": 9007199254740000 })", false },
+			{ R"({ "byteOffset": 1020, "count": 1 })", R"({ "byteLength": 1024 })", false },
+			{ R"({})", R"({ "byteLength": 120 })", false },
+		};
+
+		bool passed = true;
+		for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+		{
+			if (AccessorInRange(cases[i].Accessor, cases[i].BufferView, 12, 1024) != cases[i].Valid)
+			{
+				std::cout << "MalformedAccessorsRejected: case " << i << " should be " << (cases[i].Valid ? "accepted" : "rejected") << "\n";
+				passed = false;
+			}
+		}
+
+		return passed;
+	}
+
+	/**
+	 * @brief The row order written to KTXorientation is read back, and top down levels are flipped row by row and inside compressed blocks.
+	 */
+	bool KTX2Orientation()
+	{
+		bool passed = true;
+		auto expect = [&passed](bool condition, const char* what)
+			{
+				if (!condition)
+				{
+					std::cout << "KTX2Orientation: " << what << "\n";
+					passed = false;
+				}
+			};
+
+		std::vector<std::vector<uint8_t>> levels = { std::vector<uint8_t>(2 * 2 * 4), std::vector<uint8_t>(4) };
+		for (bool topDown : { false, true })
+		{
+			std::vector<uint8_t> file;
+			VulkanHelper::KTX2::Info info;
+			std::string error;
+			bool valid = VulkanHelper::KTX2::Write(VK_FORMAT_R8G8B8A8_UNORM, 2, 2, levels, topDown, &file) && VulkanHelper::KTX2::Parse(file.data(), file.size(), &info, &error);
+			expect(valid && info.TopDown == topDown, "orientation isn't read back");
+		}
+
+		VulkanHelper::KTX2::Info info;
+		info.Format = VK_FORMAT_R8_UNORM;
+		info.Width = 2;
+		info.Height = 2;
+		uint8_t texels[4] = { 1, 2, 3, 4 };
+		VulkanHelper::KTX2::FlipVertically(info, 0, texels);
+		expect(texels[0] == 3 && texels[1] == 4 && texels[2] == 1 && texels[3] == 2, "uncompressed rows aren't flipped");
+
+		// Single BC4 block, the 12 bits of row r hold r + 1
+		info.Format = VK_FORMAT_BC4_UNORM_BLOCK;
+		info.Width = 4;
+		info.Height = 4;
+		uint8_t bc4[8] = { 0xFF, 0x00 };
+		uint64_t indices = 1 | (2 << 12) | (3ull << 24) | (4ull << 36);
+		memcpy(bc4 + 2, &indices, 6);
+		expect(VulkanHelper::KTX2::CanFlipVertically(info), "BC4 can't be flipped");
+		VulkanHelper::KTX2::FlipVertically(info, 0, bc4);
+		uint64_t flipped = 0;
+		memcpy(&flipped, bc4 + 2, 6);
+		expect(bc4[0] == 0xFF && flipped == (4 | (3 << 12) | (2ull << 24) | (1ull << 36)), "BC4 indices aren't flipped");
+
+		// 4x2 BC1 image, only the two rows that exist are swapped
+		info.Format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		info.Height = 2;
+		uint8_t bc1[8] = { 0, 0, 0, 0, 0x11, 0x22, 0x33, 0x44 };
+		VulkanHelper::KTX2::FlipVertically(info, 0, bc1);
+		expect(bc1[4] == 0x22 && bc1[5] == 0x11 && bc1[6] == 0x33 && bc1[7] == 0x44, "partial BC1 block isn't flipped");
+
+		// Formats whose blocks can't be flipped, and block rows that are only partially filled
+		info.Format = VK_FORMAT_BC7_UNORM_BLOCK;
+		expect(!VulkanHelper::KTX2::CanFlipVertically(info), "BC7 claims to be flippable");
+		info.Format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		info.Height = 6;
+		expect(!VulkanHelper::KTX2::CanFlipVertically(info), "partial block rows claim to be flippable");
+
+		return passed;
+	}
+
+	struct Test
+	{
+		const char* Name;
+		TestFunction Function;
+	};
+
+	const Test s_Tests[] =
+	{
+		{ "ModelsOutnumberWorkers", &ModelsOutnumberWorkers },
+		{ "MalformedAccessorsRejected", &MalformedAccessorsRejected },
+		{ "KTX2Orientation", &KTX2Orientation },
+	};
+}
+
+int main()
+{
+	VulkanHelper::Logger::Init();
+
+	int failed = 0;
+	for (const Test& test : s_Tests)
+	{
+		bool passed = test.Function();
+		std::cout << (passed ? "[PASS] " : "[FAIL] ") << test.Name << "\n";
+		failed += passed ? 0 : 1;
+	}
+
+	std::cout << (sizeof(s_Tests) / sizeof(s_Tests[0]) - failed) << " of " << sizeof(s_Tests) / sizeof(s_Tests[0]) << " tests passed\n";
+	return failed;
+}
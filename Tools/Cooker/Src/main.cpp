@@ -0,0 +1,41 @@
+#include "Asset/AssetCooker.h"
+#include "Logger/Logger.h"
+
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	VulkanHelper::Logger::Init();
+
+	VulkanHelper::AssetCooker::CreateInfo info;
+	int argIndex = 1;
+	for (; argIndex < argc; argIndex++)
+	{
+		std::string arg = argv[argIndex];
+		if (arg == "--force")
+			info.Force = true;
+		else if (arg == "--threads" && argIndex + 1 < argc)
+			info.ThreadCount = (uint32_t)std::stoul(argv[++argIndex]);
+		else
+			break;
+	}
+
+	if (argc - argIndex != 2)
+	{
+		std::cout << "Usage: VulkanHelperCooker [--force] [--threads N] <source directory> <output directory>\n";
+		std::cout << "  --force    Cook everything, even outputs that are up to date\n";
+		std::cout << "  --threads  Worker count, defaults to every hardware thread\n";
+		return 1;
+	}
+
+	info.SourceDirectory = argv[argIndex];
+	info.OutputDirectory = argv[argIndex + 1];
+
+	VulkanHelper::AssetCooker::Statistics statistics;
+	bool succeeded = VulkanHelper::AssetCooker::Cook(info, &statistics);
+
+	std::cout << statistics.Cooked << " cooked, " << statistics.UpToDate << " up to date, " << statistics.Failed << " failed\n";
+	std::cout << "Load the result with AssetManager::LoadCookManifest(\"" << info.OutputDirectory << "/" << VulkanHelper::AssetCooker::s_ManifestName << "\")\n";
+
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include "Asset/Package.h"
+
+#include <fstream>
+#include <iostream>
+
+// Files are stored under the path they're given with, so run this from the directory the application runs from
+static bool AddFile(VulkanHelper::PackageWriter& writer, const std::filesystem::path& path, bool compress)
+{
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (!stream)
+	{
+		std::cerr << "Can't read " << path.generic_string() << "\n";
+		return false;
+	}
+
+	std::vector<uint8_t> data((size_t)stream.tellg());
+	stream.seekg(0);
+	stream.read((char*)data.data(), data.size());
+
+	writer.AddFile(path.generic_string(), std::move(data), compress);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cout << "Usage: VulkanHelperPacker [--store] <output.pak> <directory or file>...\n";
+		std::cout << "  --store  Don't compress, every file can then be used straight from the mapping\n";
+		return 1;
+	}
+
+	int argIndex = 1;
+	bool compress = true;
+	if (std::string(argv[argIndex]) == "--store")
+	{
+		compress = false;
+		argIndex++;
+	}
+
+	std::string outputPath = argv[argIndex++];
+
+	VulkanHelper::PackageWriter writer;
+	for (; argIndex < argc; argIndex++)
+	{
+		std::filesystem::path input = argv[argIndex];
+
+		std::error_code error;
+		if (std::filesystem::is_directory(input, error))
+		{
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(input, error))
+			{
+				if (entry.is_regular_file() && !AddFile(writer, entry.path(), compress))
+					return 1;
+			}
+		}
+		else if (!AddFile(writer, input, compress))
+		{
+			return 1;
+		}
+	}
+
+	std::string writeError;
+	if (!writer.Write(outputPath, &writeError))
+	{
+		std::cerr << writeError << "\n";
+		return 1;
+	}
+
+	std::cout << "Packed " << writer.GetFileCount() << " files into " << outputPath << "\n";
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include "Asset/SceneJournal.h"
+#include "Asset/Serializer.h"
+#include "Logger/Logger.h"
+#include "Scene/Components.h"
+#include "Scene/Entity.h"
+#include "Scene/Scene.h"
+#include "Utility/ThreadPool.h"
+
+#include <chrono>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static double GetMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Saves and loads a scene of transform and name components, both without a window or GPU
+int main(int argc, char** argv)
+{
+	VulkanHelper::Logger::Init();
+
+	uint32_t entityCount = argc > 1 ? (uint32_t)std::stoul(argv[1]) : 1'000'000;
+	std::string path = argc > 2 ? argv[2] : "SceneBenchmark.vhscene";
+
+	uint64_t fileSize = 0;
+	{
+		VulkanHelper::Scene scene;
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			VulkanHelper::Entity entity = scene.CreateEntity();
+			entity.AddComponent<VulkanHelper::TransformComponent>().Transform.SetTranslation({ (float)i, 0.0f, 0.0f });
+			entity.AddComponent<VulkanHelper::NameComponent>().Name = "Entity " + std::to_string(i);
+		}
+
+		Clock::time_point start = Clock::now();
+		if (!VulkanHelper::Serializer::SerializeScene<VulkanHelper::TransformComponent, VulkanHelper::NameComponent>(&scene, path))
+			return 1;
+
+		double milliseconds = GetMilliseconds(start);
+		fileSize = (uint64_t)std::filesystem::file_size(path);
+		std::cout << "Save: " << milliseconds << " ms, " << (double)fileSize / (1024.0 * 1024.0) / (milliseconds / 1000.0) << " MB/s\n";
+	}
+
+	// Once decoding on the calling thread only, once with every core
+	uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	VulkanHelper::ThreadPool threadPool({ nullptr, threadCount - 1 }); // The calling thread takes part in ParallelFor
+	for (VulkanHelper::ThreadPool* pool : { (VulkanHelper::ThreadPool*)nullptr, &threadPool })
+	{
+		VulkanHelper::Scene scene;
+
+		Clock::time_point start = Clock::now();
+		if (!VulkanHelper::Serializer::DeserializeScene<VulkanHelper::TransformComponent, VulkanHelper::NameComponent>(path, &scene, pool))
+			return 1;
+
+		double milliseconds = GetMilliseconds(start);
+		std::cout << "Load (" << (pool ? threadCount : 1) << " threads): " << milliseconds << " ms, " << (double)fileSize / (1024.0 * 1024.0) / (milliseconds / 1000.0) << " MB/s\n";
+
+		// Every name has to still match the transform it was saved with
+		size_t loaded = 0;
+		for (auto [entity, transform, name] : scene.GetRegistry().view<VulkanHelper::TransformComponent, VulkanHelper::NameComponent>().each())
+		{
+			if (name.Name == "Entity " + std::to_string((uint32_t)transform.Transform.GetTranslation().x))
+				loaded++;
+		}
+
+		if (loaded != entityCount)
+		{
+			std::cout << "Loaded " << loaded << " of " << entityCount << " entities correctly\n";
+			return 1;
+		}
+	}
+
+	// Delta saves, 1% of the entities change, a few are destroyed and created, then it's loaded back with the journal
+	using Journal = VulkanHelper::SceneJournal<VulkanHelper::TransformComponent, VulkanHelper::NameComponent>;
+	std::string journalPath = path + ".journal";
+	uint32_t expectedCount = entityCount; // Destroyed entities are replaced one for one
+	{
+		VulkanHelper::Scene scene;
+		Journal journal({ &scene, path, journalPath });
+		if (!journal.Load(&threadPool))
+			return 1;
+
+		Clock::time_point start = Clock::now();
+		if (!journal.Compact())
+			return 1;
+
+		std::cout << "Compact: " << GetMilliseconds(start) << " ms\n";
+
+		std::vector<VulkanHelper::Entity> changed;
+		for (auto entity : scene.GetRegistry().view<VulkanHelper::TransformComponent>())
+		{
+			if (changed.size() * 100 < entityCount)
+				changed.push_back({ entity, &scene });
+		}
+
+		uint32_t nextNumber = entityCount;
+		auto setNumber = [&nextNumber](VulkanHelper::Entity& entity)
+			{
+				uint32_t number = nextNumber++;
+				entity.PatchComponent<VulkanHelper::TransformComponent>([number](auto& component) { component.Transform.SetTranslation({ (float)number, 0.0f, 0.0f }); });
+				entity.PatchComponent<VulkanHelper::NameComponent>([number](auto& component) { component.Name = "Entity " + std::to_string(number); });
+			};
+
+		// Every tenth changed entity is destroyed and replaced by a new one instead
+		for (size_t i = 0; i < changed.size(); i++)
+		{
+			if (i % 10 != 0)
+			{
+				setNumber(changed[i]);
+				continue;
+			}
+
+			scene.DestroyEntity(changed[i]);
+
+			VulkanHelper::Entity entity = scene.CreateEntity();
+			entity.AddComponent<VulkanHelper::TransformComponent>();
+			entity.AddComponent<VulkanHelper::NameComponent>();
+			setNumber(entity);
+		}
+
+		start = Clock::now();
+		if (!journal.SaveDelta())
+			return 1;
+
+		std::cout << "Delta save of " << changed.size() << " entities: " << GetMilliseconds(start) << " ms, journal " << (double)journal.GetJournalSize() / (1024.0 * 1024.0) << " MB\n";
+	}
+
+	{
+		VulkanHelper::Scene scene;
+		Journal journal({ &scene, path, journalPath });
+
+		Clock::time_point start = Clock::now();
+		if (!journal.Load(&threadPool))
+			return 1;
+
+		std::cout << "Load with journal: " << GetMilliseconds(start) << " ms\n";
+
+		size_t loaded = 0;
+		for (auto [entity, transform, name] : scene.GetRegistry().view<VulkanHelper::TransformComponent, VulkanHelper::NameComponent>().each())
+		{
+			if (name.Name == "Entity " + std::to_string((uint32_t)transform.Transform.GetTranslation().x))
+				loaded++;
+		}
+
+		if (loaded != expectedCount || scene.GetRegistry().storage<VulkanHelper::TransformComponent>().size() != expectedCount)
+		{
+			std::cout << "Loaded " << loaded << " of " << expectedCount << " entities correctly with the journal\n";
+			return 1;
+		}
+	}
+
+	std::cout << entityCount << " entities, " << (double)fileSize / (1024.0 * 1024.0) << " MB\n";
+	std::filesystem::remove(path);
+	std::filesystem::remove(journalPath);
+
+	return 0;
+}
@@ -6,3 +6,8 @@ workspace "TemplateProject"
         
     include "VulkanHelperPremake5.lua"
     include "TemplateProject"
+    include "Tools/Packer"
+    include "Tools/Cooker"
+    include "Tools/SceneBenchmark"
+    include "Tools/AssetTests"
+    include "Tools/AssetBenchmark"